@@ -31,8 +31,26 @@ namespace gr {
        * constructor is in a private implementation
        * class. ieee80211::decode::make is the public interface for
        * creating new instances.
+       *
+       * \param ifdebug print crc results and per mcs counters.
+       * \param tbdepth traceback depth of the windowed data Viterbi. With 0
+       * the whole trellis is traced back once the frame is complete. A
+       * positive depth commits decoded bits while the frame is arriving,
+       * so A-MPDU subframes are published about that many bits after
+       * their last bit is received.
+       * \param nworkers number of decode threads. With 0 packets are
+       * decoded in the block's own thread. Otherwise the LLRs of each
+       * packet are handed to a worker and the PDUs are still published
+       * in the order of the seq tags, tbdepth is not used then. Whenever
+     * the block has caught up with its input it waits for the packets
+     * in flight, so none is lost when a finite stream ends.
+       * \param nsegments with workers, a long trellis is cut into up to
+       * this many overlapping segments that are decoded by different
+       * workers. Each segment is at least 2048 steps.
+       * \param llrtype input LLR type of demod, 0 float, 1 int16 and 2
+       * int8. Fixed point LLRs are decoded with 16 bit path metrics.
        */
-      static sptr make(bool ifdebug);
+      static sptr make(bool ifdebug, int tbdepth = 0, int nworkers = 0, int nsegments = 0, int llrtype = 0);
     };
 
   } // namespace ieee80211
@@ -31,8 +31,12 @@ namespace gr {
        * constructor is in a private implementation
        * class. ieee80211::demod2::make is the public interface for
        * creating new instances.
+       *
+       * \param llrtype output LLR type, 0 float, 1 int16 and 2 int8.
+       * Fixed point LLRs are scaled by the snr tag of the packet and
+       * saturated, decode must be given the same type.
        */
-      static sptr make();
+      static sptr make(int llrtype = 0);
     };
 
   } // namespace ieee80211
@@ -0,0 +1,51 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Zelin Yun.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_IEEE80211_OFDM_RX_H
+#define INCLUDED_IEEE80211_OFDM_RX_H
+
+#include <gnuradio/ieee80211/api.h>
+#include <gnuradio/block.h>
+
+namespace gr {
+  namespace ieee80211 {
+
+    /*!
+     * \brief Signal, demod and decode fused in one block.
+     *
+     * Takes the outputs of sync in place of signal2, demod2 and decode.
+     * Each packet is copied once into a scratch buffer of the block with
+     * the cfo removed, then demodulated and decoded in place, and the PDUs
+     * are published on "out" in the format of decode. There are no sample
+     * or LLR streams between the stages, signal2, demod2 and decode remain
+     * for looking at those.
+     * \ingroup ieee80211
+     *
+     */
+    class IEEE80211_API ofdm_rx : virtual public gr::block
+    {
+     public:
+      typedef std::shared_ptr<ofdm_rx> sptr;
+
+      /*!
+       * \brief Return a shared_ptr to a new instance of ieee80211::ofdm_rx.
+       *
+       * To avoid accidental use of raw pointers, ieee80211::ofdm_rx's
+       * constructor is in a private implementation
+       * class. ieee80211::ofdm_rx::make is the public interface for
+       * creating new instances.
+       *
+       * \param llrtype LLR type between the demodulator and the Viterbi
+       * decoder, 0 float, 1 int16 and 2 int8.
+       */
+      static sptr make(int llrtype = 0);
+    };
+
+  } // namespace ieee80211
+} // namespace gr
+
+#endif /* INCLUDED_IEEE80211_OFDM_RX_H */
@@ -0,0 +1,159 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Zelin Yun.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_IEEE80211_PHY_H
+#define INCLUDED_IEEE80211_PHY_H
+
+#include <gnuradio/ieee80211/api.h>
+#include <gnuradio/gr_complex.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace gr {
+  namespace ieee80211 {
+    namespace phy {
+
+    //! Packet formats, same values as the format byte of the decode PDUs
+    enum Format {
+      FORMAT_L = 0,
+      FORMAT_HT = 1,
+      FORMAT_VHT = 2
+    };
+
+    /*!
+     * \brief One MPDU decoded by the Receiver, with the metadata of its packet.
+     */
+    struct Frame
+    {
+      int format;                 //!< FORMAT_L, FORMAT_HT or FORMAT_VHT
+      int mcs;
+      int nss;
+      uint64_t seq;               //!< packet count, the MPDUs of one A-MPDU share it
+      int64_t offset;             //!< sync index of the packet, L-LTF start + 16, from the first sample
+      float cfo;                  //!< rad per sample
+      float snr;                  //!< dB, from the L-LTF autocorrelation
+      float rssi;                 //!< mean power of the L-LTF samples
+      std::vector<uint8_t> mpdu;  //!< MAC header, body and fcs
+    };
+
+    /*!
+     * \brief Receiver of 802.11a/g/n/ac 20MHz up to 2x2, without the scheduler.
+     *
+     * Runs stf_detect, sync and ofdm_rx over sample buffers given by the
+     * caller and returns the MPDUs with a correct fcs. The buffers of one
+     * call need not hold whole packets, the detection and packet state
+     * carries over to the next call as in the blocks. All the state is in
+     * the instance, instances can run concurrently on different threads,
+     * one instance must not be called from two threads at once.
+     *
+     * \code
+     * gr::ieee80211::phy::Receiver rx(2);
+     * std::vector<gr::ieee80211::phy::Frame> frames;
+     * while (read(buf1, buf2, n)) {
+     *     rx.process(buf1, buf2, n, frames);
+     * }
+     * \endcode
+     */
+    class IEEE80211_API Receiver
+    {
+     public:
+      /*!
+       * \param nant antennas, 1 or 2, 2 stream packets need 2.
+       * \param llrtype LLR type between the demodulator and the Viterbi
+       * decoder, 0 float, 1 int16 and 2 int8.
+       */
+      Receiver(int nant = 2, int llrtype = 0);
+      ~Receiver();
+      Receiver(const Receiver&) = delete;
+      Receiver& operator=(const Receiver&) = delete;
+
+      /*!
+       * \brief Process n samples of each antenna.
+       *
+       * The MPDUs of the packets completed by these samples are appended
+       * to frames, in the order of the packets.
+       *
+       * \param in1 samples of antenna 1
+       * \param in2 samples of antenna 2, ignored with 1 antenna
+       * \param n number of samples
+       * \param frames decoded MPDUs are appended
+       * \return number of MPDUs appended
+       */
+      int process(const gr_complex* in1, const gr_complex* in2, int n, std::vector<Frame>& frames);
+
+      //! Drops the buffered samples and any packet in progress, offset and seq restart from 0.
+      void reset();
+
+     private:
+      struct impl;
+      std::unique_ptr<impl> d_impl;
+    };
+
+    /*!
+     * \brief Transmitter of 802.11a/g/n/ac 20MHz up to 2x2, without the scheduler.
+     *
+     * Runs encode2, modulation2, the 64 point FFT with cyclic prefix and pad2
+     * for one single user packet and writes the whole burst of each antenna,
+     * the legacy preamble, the signal fields, the data and 2 zero symbols,
+     * scaled as pad2. The second antenna carries the cyclic shifted streams
+     * of 2 stream packets, and zeros with 1 stream. For VHT the psdu is the
+     * A-MPDU with its delimiters as the blocks take it, a len of 0 gives an
+     * NDP. The instance keeps the buffers of one packet, one instance must
+     * not be called from two threads at once.
+     *
+     * \code
+     * gr::ieee80211::phy::Transmitter tx;
+     * std::vector<gr_complex> s1(tx.burst_len(FORMAT_HT, 3, 1, len)), s2(s1.size());
+     * tx.generate(psdu, len, FORMAT_HT, 3, 1, s1.data(), s2.data(), s1.size());
+     * \endcode
+     */
+    class IEEE80211_API Transmitter
+    {
+     public:
+      Transmitter();
+      ~Transmitter();
+      Transmitter(const Transmitter&) = delete;
+      Transmitter& operator=(const Transmitter&) = delete;
+
+      /*!
+       * \brief Samples per antenna of the burst of a packet.
+       *
+       * \param format FORMAT_L, FORMAT_HT or FORMAT_VHT
+       * \param mcs 0 to 7 for L, 0 to 15 for HT, 0 to 8 for VHT
+       * \param nss spatial streams, 1 or 2, for HT the one of the mcs
+       * \param len psdu bytes, up to 4095
+       * \return number of samples, -1 if the parameters are not supported
+       */
+      int burst_len(int format, int mcs, int nss, int len) const;
+
+      /*!
+       * \brief Generate the burst of one packet.
+       *
+       * \param psdu len bytes of psdu
+       * \param len psdu bytes
+       * \param format FORMAT_L, FORMAT_HT or FORMAT_VHT
+       * \param mcs modulation and coding scheme
+       * \param nss spatial streams
+       * \param out1 samples of antenna 1
+       * \param out2 samples of antenna 2, may be null with 1 stream
+       * \param max size of out1 and out2 in samples
+       * \return number of samples written to each antenna, -1 if the
+       * parameters are not supported or the burst is longer than max
+       */
+      int generate(const uint8_t* psdu, int len, int format, int mcs, int nss, gr_complex* out1, gr_complex* out2, int max);
+
+     private:
+      struct impl;
+      std::unique_ptr<impl> d_impl;
+    };
+
+    } // namespace phy
+  } // namespace ieee80211
+} // namespace gr
+
+#endif /* INCLUDED_IEEE80211_PHY_H */
@@ -0,0 +1,54 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Zelin Yun.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_IEEE80211_RX_PARALLEL_H
+#define INCLUDED_IEEE80211_RX_PARALLEL_H
+
+#include <gnuradio/ieee80211/api.h>
+#include <gnuradio/block.h>
+
+namespace gr {
+  namespace ieee80211 {
+
+    /*!
+     * \brief Signal, demod and decode of whole packets on a worker pool.
+     *
+     * Takes the outputs of sync in place of signal2, demod2 and decode.
+     * The block checks the legacy signal of each synchronized packet and
+     * copies the samples of the packet into a ring shared with the workers.
+     * Each worker demodulates and decodes one packet at a time, the PDUs
+     * are published on "out" in the format of decode and in the order of
+     * the packets. Whenever the block has caught up with its input it
+     * waits for the packets in flight, so the last packets of a finite
+     * stream are out before the block is done.
+     * \ingroup ieee80211
+     *
+     */
+    class IEEE80211_API rx_parallel : virtual public gr::block
+    {
+     public:
+      typedef std::shared_ptr<rx_parallel> sptr;
+
+      /*!
+       * \brief Return a shared_ptr to a new instance of ieee80211::rx_parallel.
+       *
+       * To avoid accidental use of raw pointers, ieee80211::rx_parallel's
+       * constructor is in a private implementation
+       * class. ieee80211::rx_parallel::make is the public interface for
+       * creating new instances.
+       *
+       * \param nworkers number of worker threads, 1 to 64.
+       * \param llrtype LLR type between the demodulator and the Viterbi
+       * decoder of the workers, 0 float, 1 int16 and 2 int8.
+       */
+      static sptr make(int nworkers = 4, int llrtype = 0);
+    };
+
+  } // namespace ieee80211
+} // namespace gr
+
+#endif /* INCLUDED_IEEE80211_RX_PARALLEL_H */
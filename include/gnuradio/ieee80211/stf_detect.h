@@ -0,0 +1,46 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Zelin Yun.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_IEEE80211_STF_DETECT_H
+#define INCLUDED_IEEE80211_STF_DETECT_H
+
+#include <gnuradio/ieee80211/api.h>
+#include <gnuradio/block.h>
+
+namespace gr {
+  namespace ieee80211 {
+
+    /*!
+     * \brief Legacy packet detection on the STF in one pass.
+     *
+     * Delay-16 autocorrelation over 48 samples, normalized by the power
+     * over 64 samples, with the plateau detection of trigger. Outputs the
+     * trigger and the autocorrelation streams for sync, in place of the
+     * presiso hier block followed by trigger.
+     * \ingroup ieee80211
+     *
+     */
+    class IEEE80211_API stf_detect : virtual public gr::block
+    {
+     public:
+      typedef std::shared_ptr<stf_detect> sptr;
+
+      /*!
+       * \brief Return a shared_ptr to a new instance of ieee80211::stf_detect.
+       *
+       * To avoid accidental use of raw pointers, ieee80211::stf_detect's
+       * constructor is in a private implementation
+       * class. ieee80211::stf_detect::make is the public interface for
+       * creating new instances.
+       */
+      static sptr make();
+    };
+
+  } // namespace ieee80211
+} // namespace gr
+
+#endif /* INCLUDED_IEEE80211_STF_DETECT_H */
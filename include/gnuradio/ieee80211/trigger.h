@@ -33,6 +33,22 @@ namespace gr {
        * creating new instances.
        */
       static sptr make();
+
+      /*!
+       * \brief Samples processed since the block was made.
+       */
+      virtual uint64_t samples_processed() = 0;
+
+      /*!
+       * \brief Samples of idle spans, where the autocorrelation stays
+       * below the threshold, written out without the plateau detection.
+       */
+      virtual uint64_t samples_fast_pathed() = 0;
+
+      /*!
+       * \brief Fraction of the processed samples that were fast pathed.
+       */
+      virtual double fast_path_fraction() = 0;
     };
 
   } // namespace ieee80211
@@ -45,6 +45,30 @@ namespace utils {
  */
 IEEE80211_API uint32_t calc_fcs(const uint8_t* data, size_t len);
 
+/**
+ * @brief Update a CRC-32 with more bytes
+ *
+ * Incremental form of calc_fcs, the running value is the finished CRC-32
+ * of the bytes so far, so calc_fcs(data, len) equals
+ * crc32_update(0, data, len) and a buffer fed in pieces gives the same
+ * result as in one call. Folds 16 bytes at a time with PCLMULQDQ when the
+ * CPU has it and falls back to slicing-by-8 tables.
+ *
+ * @param crc CRC-32 of the preceding bytes, 0 to start
+ * @param data Pointer to data buffer
+ * @param len Length of data in bytes
+ * @return uint32_t CRC-32 of the preceding bytes followed by data
+ *
+ * Example usage:
+ * @code
+ * uint32_t crc = 0;
+ * crc = crc32_update(crc, mac_header, 24);
+ * crc = crc32_update(crc, frame_body, body_len);
+ * // crc == calc_fcs() over header and body
+ * @endcode
+ */
+IEEE80211_API uint32_t crc32_update(uint32_t crc, const uint8_t* data, size_t len);
+
 /**
  * @brief Validate IEEE 802.11 FCS
  *
@@ -0,0 +1,69 @@
+/*
+ *
+ *     GNU Radio IEEE 802.11a/g/n/ac 20M bw and upto 2x2
+ *     Batched FFT of the OFDM data symbols
+ *     Copyright (C) June 1, 2022  Zelin Yun
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU Affero General Public License as published
+ *     by the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU Affero General Public License for more details.
+ *
+ *     You should have received a copy of the GNU Affero General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "cloud80211fft.h"
+#include <gnuradio/fft/fft.h>
+
+c8pFftBatch::c8pFftBatch()
+{
+	for(int i=0;i<2;i++)
+	{
+		for(int j=0;j<C8P_FFT_BATCH;j++)
+		{
+			plans[i][j] = nullptr;
+		}
+	}
+	planIn = fftwf_alloc_complex(C8P_FFT_BATCH * 80);
+	bins = fftwf_alloc_complex(C8P_FFT_BATCH * 64);
+}
+
+c8pFftBatch::~c8pFftBatch()
+{
+	gr::fft::planner::scoped_lock lock(gr::fft::planner::mutex());
+	for(int i=0;i<2;i++)
+	{
+		for(int j=0;j<C8P_FFT_BATCH;j++)
+		{
+			if(plans[i][j])
+			{
+				fftwf_destroy_plan(plans[i][j]);
+			}
+		}
+	}
+	fftwf_free(planIn);
+	fftwf_free(bins);
+}
+
+const gr_complex* c8pFftBatch::run(const gr_complex* sig, int symSamp, int nSym)
+{
+	int gi = (symSamp == 72);
+	fftwf_plan& p = plans[gi][nSym - 1];
+	if(!p)
+	{
+		// the fftw planner is not thread safe, share the lock of gnuradio fft
+		gr::fft::planner::scoped_lock lock(gr::fft::planner::mutex());
+		int n = 64;
+		// the input is an item offset into the stream, its alignment differs per call
+		p = fftwf_plan_many_dft(1, &n, nSym, planIn, nullptr, 1, symSamp, bins, nullptr, 1, 64,
+			FFTW_FORWARD, FFTW_ESTIMATE | FFTW_UNALIGNED);
+	}
+	fftwf_execute_dft(p, (fftwf_complex*)sig, bins);
+	return (const gr_complex*)bins;
+}
@@ -0,0 +1,51 @@
+/*
+ *
+ *     GNU Radio IEEE 802.11a/g/n/ac 20M bw and upto 2x2
+ *     Batched FFT of the OFDM data symbols
+ *     Copyright (C) June 1, 2022  Zelin Yun
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU Affero General Public License as published
+ *     by the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU Affero General Public License for more details.
+ *
+ *     You should have received a copy of the GNU Affero General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_CLOUD80211FFT_H
+#define INCLUDED_CLOUD80211FFT_H
+
+#include <gnuradio/gr_complex.h>
+#include <fftw3.h>
+
+#define C8P_FFT_BATCH 32		// symbols of one batched fft call
+
+/*
+ * 64 point forward FFTs of up to C8P_FFT_BATCH symbols in one fftw call,
+ * read in place from the input stream. Symbol k starts symSamp samples
+ * after symbol k - 1, 80 for the normal gi and 72 for the short gi, and
+ * its bins are at k * 64 of the returned buffer in the fft order. Plans
+ * are made when a batch size is first used.
+ */
+class c8pFftBatch
+{
+	private:
+	fftwf_plan plans[2][C8P_FFT_BATCH];		/* by short gi and batch size */
+	fftwf_complex* planIn;
+	fftwf_complex* bins;
+
+	public:
+	c8pFftBatch();
+	~c8pFftBatch();
+	c8pFftBatch(const c8pFftBatch&) = delete;
+	c8pFftBatch& operator=(const c8pFftBatch&) = delete;
+	const gr_complex* run(const gr_complex* sig, int symSamp, int nSym);
+};
+
+#endif /* INCLUDED_CLOUD80211FFT_H */
@@ -19,6 +19,13 @@
  */
 
 #include "cloud80211phy.h"
+#include "cloud80211viterbi.h"
+#include <volk/volk.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define C8P_EQ_X86 1
+#include <immintrin.h>
+#endif
 
 /***************************************************/
 /* training field */
@@ -626,13 +633,27 @@ void procLHSigDemodDeint(gr_complex *sym1, gr_complex *sym2, gr_complex *sig, st
 	}
 }
 
-void procNLSigDemodDeint(gr_complex *sym1, gr_complex *sym2, std::vector<gr_complex> h, float *llrht, float *llrvht)
+static inline int procSigRotation(float eRe, float eIm, float ratio)
+{
+	if(eIm > eRe * ratio)
+	{
+		return 1;
+	}
+	if(eRe > eIm * ratio)
+	{
+		return 0;
+	}
+	return -1;
+}
+
+int procNLSigDemodDeint(gr_complex *sym1, gr_complex *sym2, std::vector<gr_complex> &h, float *llrht, float *llrvht)
 {
 	gr_complex tmpM1, tmpM2;
 	gr_complex tmpPilotSum1 = std::conj(sym1[7] / h[7] - sym1[21] / h[21] + sym1[43] / h[43] + sym1[57] / h[57]);
 	gr_complex tmpPilotSum2 = std::conj(sym2[7] / h[7] - sym2[21] / h[21] + sym2[43] / h[43] + sym2[57] / h[57]);
 	float tmpPilotSumAbs1 = std::abs(tmpPilotSum1);
 	float tmpPilotSumAbs2 = std::abs(tmpPilotSum2);
+	float tmpERe1 = 0.0f, tmpEIm1 = 0.0f, tmpERe2 = 0.0f, tmpEIm2 = 0.0f;
 	for(int i=0;i<64;i++)
 	{
 		if(FFT_NL_SIG_DEMAP[i] > -1)
@@ -643,8 +664,28 @@ void procNLSigDemodDeint(gr_complex *sym1, gr_complex *sym2, std::vector<gr_comp
 			llrht[FFT_NL_SIG_DEMAP[i + 64]] = tmpM2.imag();
 			llrvht[FFT_NL_SIG_DEMAP[i]] = tmpM1.real();
 			llrvht[FFT_NL_SIG_DEMAP[i + 64]] = tmpM2.imag();
+			tmpERe1 += tmpM1.real() * tmpM1.real();
+			tmpEIm1 += tmpM1.imag() * tmpM1.imag();
+			tmpERe2 += tmpM2.real() * tmpM2.real();
+			tmpEIm2 += tmpM2.imag() * tmpM2.imag();
 		}
 	}
+	// ht rotates both symbols, vht only the second one, legacy none
+	if(procSigRotation(tmpERe1, tmpEIm1, C8P_QBPSK_RATIO_L) == 0 && procSigRotation(tmpERe2, tmpEIm2, C8P_QBPSK_RATIO_L) == 0)
+	{
+		return C8P_F_L;
+	}
+	int tmpRot1 = procSigRotation(tmpERe1, tmpEIm1, C8P_QBPSK_RATIO);
+	int tmpRot2 = procSigRotation(tmpERe2, tmpEIm2, C8P_QBPSK_RATIO);
+	if(tmpRot1 == 1)
+	{
+		return C8P_F_HT;
+	}
+	if(tmpRot1 == 0 && tmpRot2 == 1)
+	{
+		return C8P_F_VHT;
+	}
+	return -1;
 }
 
 bool signalCheckLegacy(uint8_t* inBits, int* mcs, int* len, int* nDBPS)
@@ -1403,455 +1444,110 @@ bool checkBitCrc8(uint8_t* inBits, int len, uint8_t* crcBits)
 }
 
 
-// legacy interleave and deinterleave map
-const int mapIntelLegacyBpsk[48] = {
-	0, 3, 6, 9, 12, 15, 18, 21, 24, 27, 30, 33, 36, 39, 42, 45, 
-	1, 4, 7, 10, 13, 16, 19, 22, 25, 28, 31, 34, 37, 40, 43, 46, 
-	2, 5, 8, 11, 14, 17, 20, 23, 26, 29, 32, 35, 38, 41, 44, 47
-};
-
-const int mapDeintLegacyBpsk[48] = {
-    0, 16, 32, 1, 17, 33, 2, 18, 34, 3, 19, 35, 
-	4, 20, 36, 5, 21, 37, 6, 22, 38, 7, 23, 39, 
-	8, 24, 40, 9, 25, 41, 10, 26, 42, 11, 27, 43, 
-	12, 28, 44, 13, 29, 45, 14, 30, 46, 15, 31, 47
-};
-
-const int mapIntelLegacyQpsk[96] = {
-	0, 6, 12, 18, 24, 30, 36, 42, 48, 54, 60, 66, 72, 78, 84, 90, 
-	1, 7, 13, 19, 25, 31, 37, 43, 49, 55, 61, 67, 73, 79, 85, 91, 
-	2, 8, 14, 20, 26, 32, 38, 44, 50, 56, 62, 68, 74, 80, 86, 92, 
-	3, 9, 15, 21, 27, 33, 39, 45, 51, 57, 63, 69, 75, 81, 87, 93, 
-	4, 10, 16, 22, 28, 34, 40, 46, 52, 58, 64, 70, 76, 82, 88, 94, 
-	5, 11, 17, 23, 29, 35, 41, 47, 53, 59, 65, 71, 77, 83, 89, 95
-};
-
-const int mapDeintLegacyQpsk[96] = {
-	0, 16, 32, 48, 64, 80, 1, 17, 33, 49, 65, 81, 2, 18, 34, 50, 66, 82, 3, 19, 35, 51, 67, 83, 
-	4, 20, 36, 52, 68, 84, 5, 21, 37, 53, 69, 85, 6, 22, 38, 54, 70, 86, 7, 23, 39, 55, 71, 87, 
-	8, 24, 40, 56, 72, 88, 9, 25, 41, 57, 73, 89, 10, 26, 42, 58, 74, 90, 11, 27, 43, 59, 75, 91, 
-	12, 28, 44, 60, 76, 92, 13, 29, 45, 61, 77, 93, 14, 30, 46, 62, 78, 94, 15, 31, 47, 63, 79, 95
-};
-
-const int mapIntelLegacy16Qam[192] = {
-	0, 13, 24, 37, 48, 61, 72, 85, 96, 109, 120, 133, 144, 157, 168, 181, 
-	1, 12, 25, 36, 49, 60, 73, 84, 97, 108, 121, 132, 145, 156, 169, 180, 
-	2, 15, 26, 39, 50, 63, 74, 87, 98, 111, 122, 135, 146, 159, 170, 183, 
-	3, 14, 27, 38, 51, 62, 75, 86, 99, 110, 123, 134, 147, 158, 171, 182, 
-	4, 17, 28, 41, 52, 65, 76, 89, 100, 113, 124, 137, 148, 161, 172, 185, 
-	5, 16, 29, 40, 53, 64, 77, 88, 101, 112, 125, 136, 149, 160, 173, 184, 
-	6, 19, 30, 43, 54, 67, 78, 91, 102, 115, 126, 139, 150, 163, 174, 187, 
-	7, 18, 31, 42, 55, 66, 79, 90, 103, 114, 127, 138, 151, 162, 175, 186, 
-	8, 21, 32, 45, 56, 69, 80, 93, 104, 117, 128, 141, 152, 165, 176, 189, 
-	9, 20, 33, 44, 57, 68, 81, 92, 105, 116, 129, 140, 153, 164, 177, 188, 
-	10, 23, 34, 47, 58, 71, 82, 95, 106, 119, 130, 143, 154, 167, 178, 191, 
-	11, 22, 35, 46, 59, 70, 83, 94, 107, 118, 131, 142, 155, 166, 179, 190
-};
-
-const int mapDeintLegacy16Qam[192] = {
-	0, 16, 32, 48, 64, 80, 96, 112, 128, 144, 160, 176, 17, 1, 49, 33, 81, 65, 113, 97, 145, 129, 177, 161, 
-	2, 18, 34, 50, 66, 82, 98, 114, 130, 146, 162, 178, 19, 3, 51, 35, 83, 67, 115, 99, 147, 131, 179, 163, 
-	4, 20, 36, 52, 68, 84, 100, 116, 132, 148, 164, 180, 21, 5, 53, 37, 85, 69, 117, 101, 149, 133, 181, 165, 
-	6, 22, 38, 54, 70, 86, 102, 118, 134, 150, 166, 182, 23, 7, 55, 39, 87, 71, 119, 103, 151, 135, 183, 167, 
-	8, 24, 40, 56, 72, 88, 104, 120, 136, 152, 168, 184, 25, 9, 57, 41, 89, 73, 121, 105, 153, 137, 185, 169, 
-	10, 26, 42, 58, 74, 90, 106, 122, 138, 154, 170, 186, 27, 11, 59, 43, 91, 75, 123, 107, 155, 139, 187, 171, 
-	12, 28, 44, 60, 76, 92, 108, 124, 140, 156, 172, 188, 29, 13, 61, 45, 93, 77, 125, 109, 157, 141, 189, 173, 
-	14, 30, 46, 62, 78, 94, 110, 126, 142, 158, 174, 190, 31, 15, 63, 47, 95, 79, 127, 111, 159, 143, 191, 175
-};
-
-const int mapIntelLegacy64Qam[288] = {
-	0, 20, 37, 54, 74, 91, 108, 128, 145, 162, 182, 199, 216, 236, 253, 270, 
-	1, 18, 38, 55, 72, 92, 109, 126, 146, 163, 180, 200, 217, 234, 254, 271, 
-	2, 19, 36, 56, 73, 90, 110, 127, 144, 164, 181, 198, 218, 235, 252, 272, 
-	3, 23, 40, 57, 77, 94, 111, 131, 148, 165, 185, 202, 219, 239, 256, 273, 
-	4, 21, 41, 58, 75, 95, 112, 129, 149, 166, 183, 203, 220, 237, 257, 274, 
-	5, 22, 39, 59, 76, 93, 113, 130, 147, 167, 184, 201, 221, 238, 255, 275, 
-	6, 26, 43, 60, 80, 97, 114, 134, 151, 168, 188, 205, 222, 242, 259, 276, 
-	7, 24, 44, 61, 78, 98, 115, 132, 152, 169, 186, 206, 223, 240, 260, 277, 
-	8, 25, 42, 62, 79, 96, 116, 133, 150, 170, 187, 204, 224, 241, 258, 278, 
-	9, 29, 46, 63, 83, 100, 117, 137, 154, 171, 191, 208, 225, 245, 262, 279, 
-	10, 27, 47, 64, 81, 101, 118, 135, 155, 172, 189, 209, 226, 243, 263, 280, 
-	11, 28, 45, 65, 82, 99, 119, 136, 153, 173, 190, 207, 227, 244, 261, 281, 
-	12, 32, 49, 66, 86, 103, 120, 140, 157, 174, 194, 211, 228, 248, 265, 282, 
-	13, 30, 50, 67, 84, 104, 121, 138, 158, 175, 192, 212, 229, 246, 266, 283, 
-	14, 31, 48, 68, 85, 102, 122, 139, 156, 176, 193, 210, 230, 247, 264, 284, 
-	15, 35, 52, 69, 89, 106, 123, 143, 160, 177, 197, 214, 231, 251, 268, 285, 
-	16, 33, 53, 70, 87, 107, 124, 141, 161, 178, 195, 215, 232, 249, 269, 286, 
-	17, 34, 51, 71, 88, 105, 125, 142, 159, 179, 196, 213, 233, 250, 267, 287
-};
-
-const int mapDeintLegacy64Qam[288] = {
-	0, 16, 32, 48, 64, 80, 96, 112, 128, 144, 160, 176, 192, 208, 224, 240, 256, 272, 17, 33, 
-	1, 65, 81, 49, 113, 129, 97, 161, 177, 145, 209, 225, 193, 257, 273, 241, 34, 
-	2, 18, 82, 50, 66, 130, 98, 114, 178, 146, 162, 226, 194, 210, 274, 242, 258, 
-	3, 19, 35, 51, 67, 83, 99, 115, 131, 147, 163, 179, 195, 211, 227, 243, 259, 275, 20, 36, 
-	4, 68, 84, 52, 116, 132, 100, 164, 180, 148, 212, 228, 196, 260, 276, 244, 37, 
-	5, 21, 85, 53, 69, 133, 101, 117, 181, 149, 165, 229, 197, 213, 277, 245, 261, 
-	6, 22, 38, 54, 70, 86, 102, 118, 134, 150, 166, 182, 198, 214, 230, 246, 262, 278, 23, 39, 
-	7, 71, 87, 55, 119, 135, 103, 167, 183, 151, 215, 231, 199, 263, 279, 247, 40, 
-	8, 24, 88, 56, 72, 136, 104, 120, 184, 152, 168, 232, 200, 216, 280, 248, 264, 
-	9, 25, 41, 57, 73, 89, 105, 121, 137, 153, 169, 185, 201, 217, 233, 249, 265, 281, 26, 42, 
-	10, 74, 90, 58, 122, 138, 106, 170, 186, 154, 218, 234, 202, 266, 282, 250, 43, 
-	11, 27, 91, 59, 75, 139, 107, 123, 187, 155, 171, 235, 203, 219, 283, 251, 267, 
-	12, 28, 44, 60, 76, 92, 108, 124, 140, 156, 172, 188, 204, 220, 236, 252, 268, 284, 29, 45, 
-	13, 77, 93, 61, 125, 141, 109, 173, 189, 157, 221, 237, 205, 269, 285, 253, 46, 
-	14, 30, 94, 62, 78, 142, 110, 126, 190, 158, 174, 238, 206, 222, 286, 254, 270, 
-	15, 31, 47, 63, 79, 95, 111, 127, 143, 159, 175, 191, 207, 223, 239, 255, 271, 287
-};
+// legacy interleave and deinterleave map, from the interleaver formulas of 802.11
+constexpr std::array<int, 48> mapIntelLegacyBpsk = c8pIntelMap<48>(C8P_INTEL_NCOL_L, 1, 1, 0);
+constexpr std::array<int, 48> mapDeintLegacyBpsk = c8pDeintMap<48>(C8P_INTEL_NCOL_L, 1, 1, 0);
+constexpr std::array<int, 96> mapIntelLegacyQpsk = c8pIntelMap<96>(C8P_INTEL_NCOL_L, 2, 1, 0);
+constexpr std::array<int, 96> mapDeintLegacyQpsk = c8pDeintMap<96>(C8P_INTEL_NCOL_L, 2, 1, 0);
+constexpr std::array<int, 192> mapIntelLegacy16Qam = c8pIntelMap<192>(C8P_INTEL_NCOL_L, 4, 1, 0);
+constexpr std::array<int, 192> mapDeintLegacy16Qam = c8pDeintMap<192>(C8P_INTEL_NCOL_L, 4, 1, 0);
+constexpr std::array<int, 288> mapIntelLegacy64Qam = c8pIntelMap<288>(C8P_INTEL_NCOL_L, 6, 1, 0);
+constexpr std::array<int, 288> mapDeintLegacy64Qam = c8pDeintMap<288>(C8P_INTEL_NCOL_L, 6, 1, 0);
 
 // ht and vht interleave and deinterleave map for siso and 2x2 mimo
-const int mapDeintVhtSigB20[52] = {
-	0, 13, 26, 39, 1, 14, 27, 40, 2, 15, 28, 41, 3, 16, 29, 42, 4, 17,
-	30, 43, 5, 18, 31, 44, 6,19, 32, 45, 7, 20, 33, 46, 8, 21, 34, 47,
-	9, 22, 35, 48, 10, 23, 36, 49, 11, 24, 37, 50, 12, 25, 38, 51};
-
-const int mapIntelVhtSigB20[52] = {
-	0, 4, 8, 12, 16, 20, 24, 28, 32, 36, 40, 44, 48, 1, 5, 9, 13, 17, 
-	21, 25, 29, 33, 37, 41, 45, 49, 2, 6, 10, 14, 18, 22, 26, 30, 34, 
-	38, 42, 46, 50, 3, 7, 11, 15, 19, 23, 27, 31, 35, 39, 43, 47, 51};
-
-const int mapIntelNonlegacyBpsk[52] = {
-	0, 4, 8, 12, 16, 20, 24, 28, 32, 36, 40, 44, 48, 
-	1, 5, 9, 13, 17, 21, 25, 29, 33, 37, 41, 45, 49, 
-	2, 6, 10, 14, 18, 22, 26, 30, 34, 38, 42, 46, 50, 
-	3, 7, 11, 15, 19, 23, 27, 31, 35, 39, 43, 47, 51
-};
-
-const int mapIntelNonlegacyBpsk2[52] = {
-	30, 34, 38, 42, 46, 50, 2, 6, 10, 14, 18, 22, 26, 
-	31, 35, 39, 43, 47, 51, 3, 7, 11, 15, 19, 23, 27, 
-	32, 36, 40, 44, 48, 0, 4, 8, 12, 16, 20, 24, 28, 
-	33, 37, 41, 45, 49, 1, 5, 9, 13, 17, 21, 25, 29
-};
-
-const int mapIntelNonlegacyQpsk[104] = {
-	0, 8, 16, 24, 32, 40, 48, 56, 64, 72, 80, 88, 96, 
-	1, 9, 17, 25, 33, 41, 49, 57, 65, 73, 81, 89, 97, 
-	2, 10, 18, 26, 34, 42, 50, 58, 66, 74, 82, 90, 98, 
-	3, 11, 19, 27, 35, 43, 51, 59, 67, 75, 83, 91, 99, 
-	4, 12, 20, 28, 36, 44, 52, 60, 68, 76, 84, 92, 100, 
-	5, 13, 21, 29, 37, 45, 53, 61, 69, 77, 85, 93, 101, 
-	6, 14, 22, 30, 38, 46, 54, 62, 70, 78, 86, 94, 102, 
-	7, 15, 23, 31, 39, 47, 55, 63, 71, 79, 87, 95, 103
-};
-
-const int mapIntelNonlegacyQpsk2[104] = {
-	60, 68, 76, 84, 92, 100, 4, 12, 20, 28, 36, 44, 52, 
-	61, 69, 77, 85, 93, 101, 5, 13, 21, 29, 37, 45, 53, 
-	62, 70, 78, 86, 94, 102, 6, 14, 22, 30, 38, 46, 54, 
-	63, 71, 79, 87, 95, 103, 7, 15, 23, 31, 39, 47, 55, 
-	64, 72, 80, 88, 96, 0, 8, 16, 24, 32, 40, 48, 56, 
-	65, 73, 81, 89, 97, 1, 9, 17, 25, 33, 41, 49, 57, 
-	66, 74, 82, 90, 98, 2, 10, 18, 26, 34, 42, 50, 58, 
-	67, 75, 83, 91, 99, 3, 11, 19, 27, 35, 43, 51, 59
-};
-
-const int mapIntelNonlegacy16Qam[208] = {
-	0, 17, 32, 49, 64, 81, 96, 113, 128, 145, 160, 177, 192, 
-	1, 16, 33, 48, 65, 80, 97, 112, 129, 144, 161, 176, 193, 
-	2, 19, 34, 51, 66, 83, 98, 115, 130, 147, 162, 179, 194, 
-	3, 18, 35, 50, 67, 82, 99, 114, 131, 146, 163, 178, 195, 
-	4, 21, 36, 53, 68, 85, 100, 117, 132, 149, 164, 181, 196, 
-	5, 20, 37, 52, 69, 84, 101, 116, 133, 148, 165, 180, 197, 
-	6, 23, 38, 55, 70, 87, 102, 119, 134, 151, 166, 183, 198, 
-	7, 22, 39, 54, 71, 86, 103, 118, 135, 150, 167, 182, 199, 
-	8, 25, 40, 57, 72, 89, 104, 121, 136, 153, 168, 185, 200, 
-	9, 24, 41, 56, 73, 88, 105, 120, 137, 152, 169, 184, 201, 
-	10, 27, 42, 59, 74, 91, 106, 123, 138, 155, 170, 187, 202, 
-	11, 26, 43, 58, 75, 90, 107, 122, 139, 154, 171, 186, 203, 
-	12, 29, 44, 61, 76, 93, 108, 125, 140, 157, 172, 189, 204, 
-	13, 28, 45, 60, 77, 92, 109, 124, 141, 156, 173, 188, 205, 
-	14, 31, 46, 63, 78, 95, 110, 127, 142, 159, 174, 191, 206, 
-	15, 30, 47, 62, 79, 94, 111, 126, 143, 158, 175, 190, 207
-};
-
-const int mapIntelNonlegacy16Qam2[208] = {
-	120, 137, 152, 169, 184, 201, 8, 25, 40, 57, 72, 89, 104, 
-	121, 136, 153, 168, 185, 200, 9, 24, 41, 56, 73, 88, 105, 
-	122, 139, 154, 171, 186, 203, 10, 27, 42, 59, 74, 91, 106, 
-	123, 138, 155, 170, 187, 202, 11, 26, 43, 58, 75, 90, 107, 
-	124, 141, 156, 173, 188, 205, 12, 29, 44, 61, 76, 93, 108, 
-	125, 140, 157, 172, 189, 204, 13, 28, 45, 60, 77, 92, 109, 
-	126, 143, 158, 175, 190, 207, 14, 31, 46, 63, 78, 95, 110, 
-	127, 142, 159, 174, 191, 206, 15, 30, 47, 62, 79, 94, 111, 
-	128, 145, 160, 177, 192, 1, 16, 33, 48, 65, 80, 97, 112, 
-	129, 144, 161, 176, 193, 0, 17, 32, 49, 64, 81, 96, 113, 
-	130, 147, 162, 179, 194, 3, 18, 35, 50, 67, 82, 99, 114, 
-	131, 146, 163, 178, 195, 2, 19, 34, 51, 66, 83, 98, 115, 
-	132, 149, 164, 181, 196, 5, 20, 37, 52, 69, 84, 101, 116, 
-	133, 148, 165, 180, 197, 4, 21, 36, 53, 68, 85, 100, 117, 
-	134, 151, 166, 183, 198, 7, 22, 39, 54, 71, 86, 103, 118, 
-	135, 150, 167, 182, 199, 6, 23, 38, 55, 70, 87, 102, 119
-};
-
-const int mapIntelNonlegacy64Qam[312] = {
-	0, 26, 49, 72, 98, 121, 144, 170, 193, 216, 242, 265, 288, 
-	1, 24, 50, 73, 96, 122, 145, 168, 194, 217, 240, 266, 289, 
-	2, 25, 48, 74, 97, 120, 146, 169, 192, 218, 241, 264, 290, 
-	3, 29, 52, 75, 101, 124, 147, 173, 196, 219, 245, 268, 291, 
-	4, 27, 53, 76, 99, 125, 148, 171, 197, 220, 243, 269, 292, 
-	5, 28, 51, 77, 100, 123, 149, 172, 195, 221, 244, 267, 293, 
-	6, 32, 55, 78, 104, 127, 150, 176, 199, 222, 248, 271, 294, 
-	7, 30, 56, 79, 102, 128, 151, 174, 200, 223, 246, 272, 295, 
-	8, 31, 54, 80, 103, 126, 152, 175, 198, 224, 247, 270, 296, 
-	9, 35, 58, 81, 107, 130, 153, 179, 202, 225, 251, 274, 297, 
-	10, 33, 59, 82, 105, 131, 154, 177, 203, 226, 249, 275, 298, 
-	11, 34, 57, 83, 106, 129, 155, 178, 201, 227, 250, 273, 299, 
-	12, 38, 61, 84, 110, 133, 156, 182, 205, 228, 254, 277, 300, 
-	13, 36, 62, 85, 108, 134, 157, 180, 206, 229, 252, 278, 301, 
-	14, 37, 60, 86, 109, 132, 158, 181, 204, 230, 253, 276, 302, 
-	15, 41, 64, 87, 113, 136, 159, 185, 208, 231, 257, 280, 303, 
-	16, 39, 65, 88, 111, 137, 160, 183, 209, 232, 255, 281, 304, 
-	17, 40, 63, 89, 112, 135, 161, 184, 207, 233, 256, 279, 305, 
-	18, 44, 67, 90, 116, 139, 162, 188, 211, 234, 260, 283, 306, 
-	19, 42, 68, 91, 114, 140, 163, 186, 212, 235, 258, 284, 307, 
-	20, 43, 66, 92, 115, 138, 164, 187, 210, 236, 259, 282, 308, 
-	21, 47, 70, 93, 119, 142, 165, 191, 214, 237, 263, 286, 309, 
-	22, 45, 71, 94, 117, 143, 166, 189, 215, 238, 261, 287, 310, 
-	23, 46, 69, 95, 118, 141, 167, 190, 213, 239, 262, 285, 311
-};
-
-const int mapIntelNonlegacy64Qam2[312] = {
-	180, 206, 229, 252, 278, 301, 12, 38, 61, 84, 110, 133, 156, 
-	181, 204, 230, 253, 276, 302, 13, 36, 62, 85, 108, 134, 157, 
-	182, 205, 228, 254, 277, 300, 14, 37, 60, 86, 109, 132, 158, 
-	183, 209, 232, 255, 281, 304, 15, 41, 64, 87, 113, 136, 159, 
-	184, 207, 233, 256, 279, 305, 16, 39, 65, 88, 111, 137, 160, 
-	185, 208, 231, 257, 280, 303, 17, 40, 63, 89, 112, 135, 161, 
-	186, 212, 235, 258, 284, 307, 18, 44, 67, 90, 116, 139, 162, 
-	187, 210, 236, 259, 282, 308, 19, 42, 68, 91, 114, 140, 163, 
-	188, 211, 234, 260, 283, 306, 20, 43, 66, 92, 115, 138, 164, 
-	189, 215, 238, 261, 287, 310, 21, 47, 70, 93, 119, 142, 165, 
-	190, 213, 239, 262, 285, 311, 22, 45, 71, 94, 117, 143, 166, 
-	191, 214, 237, 263, 286, 309, 23, 46, 69, 95, 118, 141, 167, 
-	192, 218, 241, 264, 290, 1, 24, 50, 73, 96, 122, 145, 168, 
-	193, 216, 242, 265, 288, 2, 25, 48, 74, 97, 120, 146, 169, 
-	194, 217, 240, 266, 289, 0, 26, 49, 72, 98, 121, 144, 170, 
-	195, 221, 244, 267, 293, 4, 27, 53, 76, 99, 125, 148, 171, 
-	196, 219, 245, 268, 291, 5, 28, 51, 77, 100, 123, 149, 172, 
-	197, 220, 243, 269, 292, 3, 29, 52, 75, 101, 124, 147, 173, 
-	198, 224, 247, 270, 296, 7, 30, 56, 79, 102, 128, 151, 174, 
-	199, 222, 248, 271, 294, 8, 31, 54, 80, 103, 126, 152, 175, 
-	200, 223, 246, 272, 295, 6, 32, 55, 78, 104, 127, 150, 176, 
-	201, 227, 250, 273, 299, 10, 33, 59, 82, 105, 131, 154, 177, 
-	202, 225, 251, 274, 297, 11, 34, 57, 83, 106, 129, 155, 178, 
-	203, 226, 249, 275, 298, 9, 35, 58, 81, 107, 130, 153, 179
-};
-
-const int mapIntelNonlegacy256Qam[416] = {
-	0, 35, 66, 97, 128, 163, 194, 225, 256, 291, 322, 353, 384, 
-	1, 32, 67, 98, 129, 160, 195, 226, 257, 288, 323, 354, 385, 
-	2, 33, 64, 99, 130, 161, 192, 227, 258, 289, 320, 355, 386, 
-	3, 34, 65, 96, 131, 162, 193, 224, 259, 290, 321, 352, 387, 
-	4, 39, 70, 101, 132, 167, 198, 229, 260, 295, 326, 357, 388, 
-	5, 36, 71, 102, 133, 164, 199, 230, 261, 292, 327, 358, 389, 
-	6, 37, 68, 103, 134, 165, 196, 231, 262, 293, 324, 359, 390, 
-	7, 38, 69, 100, 135, 166, 197, 228, 263, 294, 325, 356, 391, 
-	8, 43, 74, 105, 136, 171, 202, 233, 264, 299, 330, 361, 392, 
-	9, 40, 75, 106, 137, 168, 203, 234, 265, 296, 331, 362, 393, 
-	10, 41, 72, 107, 138, 169, 200, 235, 266, 297, 328, 363, 394, 
-	11, 42, 73, 104, 139, 170, 201, 232, 267, 298, 329, 360, 395, 
-	12, 47, 78, 109, 140, 175, 206, 237, 268, 303, 334, 365, 396, 
-	13, 44, 79, 110, 141, 172, 207, 238, 269, 300, 335, 366, 397, 
-	14, 45, 76, 111, 142, 173, 204, 239, 270, 301, 332, 367, 398, 
-	15, 46, 77, 108, 143, 174, 205, 236, 271, 302, 333, 364, 399, 
-	16, 51, 82, 113, 144, 179, 210, 241, 272, 307, 338, 369, 400, 
-	17, 48, 83, 114, 145, 176, 211, 242, 273, 304, 339, 370, 401, 
-	18, 49, 80, 115, 146, 177, 208, 243, 274, 305, 336, 371, 402, 
-	19, 50, 81, 112, 147, 178, 209, 240, 275, 306, 337, 368, 403, 
-	20, 55, 86, 117, 148, 183, 214, 245, 276, 311, 342, 373, 404, 
-	21, 52, 87, 118, 149, 180, 215, 246, 277, 308, 343, 374, 405, 
-	22, 53, 84, 119, 150, 181, 212, 247, 278, 309, 340, 375, 406, 
-	23, 54, 85, 116, 151, 182, 213, 244, 279, 310, 341, 372, 407, 
-	24, 59, 90, 121, 152, 187, 218, 249, 280, 315, 346, 377, 408, 
-	25, 56, 91, 122, 153, 184, 219, 250, 281, 312, 347, 378, 409, 
-	26, 57, 88, 123, 154, 185, 216, 251, 282, 313, 344, 379, 410, 
-	27, 58, 89, 120, 155, 186, 217, 248, 283, 314, 345, 376, 411, 
-	28, 63, 94, 125, 156, 191, 222, 253, 284, 319, 350, 381, 412, 
-	29, 60, 95, 126, 157, 188, 223, 254, 285, 316, 351, 382, 413, 
-	30, 61, 92, 127, 158, 189, 220, 255, 286, 317, 348, 383, 414, 
-	31, 62, 93, 124, 159, 190, 221, 252, 287, 318, 349, 380, 415
-};
-
-const int mapIntelNonlegacy256Qam2[416] = {
-	240, 275, 306, 337, 368, 403, 18, 49, 80, 115, 146, 177, 208, 
-	241, 272, 307, 338, 369, 400, 19, 50, 81, 112, 147, 178, 209, 
-	242, 273, 304, 339, 370, 401, 16, 51, 82, 113, 144, 179, 210, 
-	243, 274, 305, 336, 371, 402, 17, 48, 83, 114, 145, 176, 211, 
-	244, 279, 310, 341, 372, 407, 22, 53, 84, 119, 150, 181, 212, 
-	245, 276, 311, 342, 373, 404, 23, 54, 85, 116, 151, 182, 213, 
-	246, 277, 308, 343, 374, 405, 20, 55, 86, 117, 148, 183, 214, 
-	247, 278, 309, 340, 375, 406, 21, 52, 87, 118, 149, 180, 215, 
-	248, 283, 314, 345, 376, 411, 26, 57, 88, 123, 154, 185, 216, 
-	249, 280, 315, 346, 377, 408, 27, 58, 89, 120, 155, 186, 217, 
-	250, 281, 312, 347, 378, 409, 24, 59, 90, 121, 152, 187, 218, 
-	251, 282, 313, 344, 379, 410, 25, 56, 91, 122, 153, 184, 219, 
-	252, 287, 318, 349, 380, 415, 30, 61, 92, 127, 158, 189, 220, 
-	253, 284, 319, 350, 381, 412, 31, 62, 93, 124, 159, 190, 221, 
-	254, 285, 316, 351, 382, 413, 28, 63, 94, 125, 156, 191, 222, 
-	255, 286, 317, 348, 383, 414, 29, 60, 95, 126, 157, 188, 223, 
-	256, 291, 322, 353, 384, 3, 34, 65, 96, 131, 162, 193, 224, 
-	257, 288, 323, 354, 385, 0, 35, 66, 97, 128, 163, 194, 225, 
-	258, 289, 320, 355, 386, 1, 32, 67, 98, 129, 160, 195, 226, 
-	259, 290, 321, 352, 387, 2, 33, 64, 99, 130, 161, 192, 227, 
-	260, 295, 326, 357, 388, 7, 38, 69, 100, 135, 166, 197, 228, 
-	261, 292, 327, 358, 389, 4, 39, 70, 101, 132, 167, 198, 229, 
-	262, 293, 324, 359, 390, 5, 36, 71, 102, 133, 164, 199, 230, 
-	263, 294, 325, 356, 391, 6, 37, 68, 103, 134, 165, 196, 231, 
-	264, 299, 330, 361, 392, 11, 42, 73, 104, 139, 170, 201, 232, 
-	265, 296, 331, 362, 393, 8, 43, 74, 105, 136, 171, 202, 233, 
-	266, 297, 328, 363, 394, 9, 40, 75, 106, 137, 168, 203, 234, 
-	267, 298, 329, 360, 395, 10, 41, 72, 107, 138, 169, 200, 235, 
-	268, 303, 334, 365, 396, 15, 46, 77, 108, 143, 174, 205, 236, 
-	269, 300, 335, 366, 397, 12, 47, 78, 109, 140, 175, 206, 237, 
-	270, 301, 332, 367, 398, 13, 44, 79, 110, 141, 172, 207, 238, 
-	271, 302, 333, 364, 399, 14, 45, 76, 111, 142, 173, 204, 239
-};
-
-const int mapDeintNonlegacyBpsk[52] = {
-	0, 13, 26, 39, 1, 14, 27, 40, 2, 15, 28, 41, 3, 16, 29, 42, 4, 17, 30, 43, 5, 18, 31, 44, 
-	6, 19, 32, 45, 7, 20, 33, 46, 8, 21, 34, 47, 9, 22, 35, 48, 10, 23, 36, 49, 11, 24, 37, 50, 
-	12, 25, 38, 51
-};
-
-const int mapDeintNonlegacyBpsk2[52] = {
-	31, 44, 6, 19, 32, 45, 7, 20, 33, 46, 8, 21, 34, 47, 9, 22, 35, 48, 10, 23, 36, 49, 11, 24, 
-	37, 50, 12, 25, 38, 51, 0, 13, 26, 39, 1, 14, 27, 40, 2, 15, 28, 41, 3, 16, 29, 42, 4, 17, 
-	30, 43, 5, 18
-};
-
-const int mapDeintNonlegacyQpsk[104] = {
-	0, 13, 26, 39, 52, 65, 78, 91, 1, 14, 27, 40, 53, 66, 79, 92, 2, 15, 28, 41, 54, 67, 80, 93, 
-	3, 16, 29, 42, 55, 68, 81, 94, 4, 17, 30, 43, 56, 69, 82, 95, 5, 18, 31, 44, 57, 70, 83, 96, 
-	6, 19, 32, 45, 58, 71, 84, 97, 7, 20, 33, 46, 59, 72, 85, 98, 8, 21, 34, 47, 60, 73, 86, 99, 
-	9, 22, 35, 48, 61, 74, 87, 100, 10, 23, 36, 49, 62, 75, 88, 101, 11, 24, 37, 50, 63, 76, 89, 
-	102, 12, 25, 38, 51, 64, 77, 90, 103
-};
-
- const int mapDeintNonlegacyQpsk2[104] = {
-	57, 70, 83, 96, 6, 19, 32, 45, 58, 71, 84, 97, 7, 20, 33, 46, 59, 72, 85, 98, 8, 21, 34, 47, 
-	60, 73, 86, 99, 9, 22, 35, 48, 61, 74, 87, 100, 10, 23, 36, 49, 62, 75, 88, 101, 11, 24, 37, 
-	50, 63, 76, 89, 102, 12, 25, 38, 51, 64, 77, 90, 103, 0, 13, 26, 39, 52, 65, 78, 91, 1, 14, 
-	27, 40, 53, 66, 79, 92, 2, 15, 28, 41, 54, 67, 80, 93, 3, 16, 29, 42, 55, 68, 81, 94, 4, 17, 
-	30, 43, 56, 69, 82, 95, 5, 18, 31, 44
-};
-
-const int mapDeintNonlegacy16Qam[208] = {
-	0, 13, 26, 39, 52, 65, 78, 91, 104, 117, 130, 143, 156, 169, 182, 195, 14, 
-	1, 40, 27, 66, 53, 92, 79, 118, 105, 144, 131, 170, 157, 196, 183, 
-	2, 15, 28, 41, 54, 67, 80, 93, 106, 119, 132, 145, 158, 171, 184, 197, 16, 
-	3, 42, 29, 68, 55, 94, 81, 120, 107, 146, 133, 172, 159, 198, 185, 
-	4, 17, 30, 43, 56, 69, 82, 95, 108, 121, 134, 147, 160, 173, 186, 199, 18, 
-	5, 44, 31, 70, 57, 96, 83, 122, 109, 148, 135, 174, 161, 200, 187, 
-	6, 19, 32, 45, 58, 71, 84, 97, 110, 123, 136, 149, 162, 175, 188, 201, 20, 
-	7, 46, 33, 72, 59, 98, 85, 124, 111, 150, 137, 176, 163, 202, 189, 
-	8, 21, 34, 47, 60, 73, 86, 99, 112, 125, 138, 151, 164, 177, 190, 203, 22, 
-	9, 48, 35, 74, 61, 100, 87, 126, 113, 152, 139, 178, 165, 204, 191, 
-	10, 23, 36, 49, 62, 75, 88, 101, 114, 127, 140, 153, 166, 179, 192, 205, 24, 
-	11, 50, 37, 76, 63, 102, 89, 128, 115, 154, 141, 180, 167, 206, 193, 
-	12, 25, 38, 51, 64, 77, 90, 103, 116, 129, 142, 155, 168, 181, 194, 207
-};
-
-const int mapDeintNonlegacy16Qam2[208] = {
-	122, 109, 148, 135, 174, 161, 200, 187, 6, 19, 32, 45, 58, 71, 84, 97, 110, 
-	123, 136, 149, 162, 175, 188, 201, 20, 7, 46, 33, 72, 59, 98, 85, 124, 111, 
-	150, 137, 176, 163, 202, 189, 8, 21, 34, 47, 60, 73, 86, 99, 112, 125, 138, 
-	151, 164, 177, 190, 203, 22, 9, 48, 35, 74, 61, 100, 87, 126, 113, 152, 139, 
-	178, 165, 204, 191, 10, 23, 36, 49, 62, 75, 88, 101, 114, 127, 140, 153, 166, 
-	179, 192, 205, 24, 11, 50, 37, 76, 63, 102, 89, 128, 115, 154, 141, 180, 167, 
-	206, 193, 12, 25, 38, 51, 64, 77, 90, 103, 116, 129, 142, 155, 168, 181, 194, 
-	207, 0, 13, 26, 39, 52, 65, 78, 91, 104, 117, 130, 143, 156, 169, 182, 195, 
-	14, 1, 40, 27, 66, 53, 92, 79, 118, 105, 144, 131, 170, 157, 196, 183, 2, 15, 
-	28, 41, 54, 67, 80, 93, 106, 119, 132, 145, 158, 171, 184, 197, 16, 3, 42, 29, 
-	68, 55, 94, 81, 120, 107, 146, 133, 172, 159, 198, 185, 4, 17, 30, 43, 56, 69, 
-	82, 95, 108, 121, 134, 147, 160, 173, 186, 199, 18, 5, 44, 31, 70, 57, 96, 83
-};
-
-const int mapDeintNonlegacy64Qam[312] = {
-	0, 13, 26, 39, 52, 65, 78, 91, 104, 117, 130, 143, 156, 169, 182, 195, 208, 221, 234, 247, 260, 273, 286, 299, 14, 27, 
-	1, 53, 66, 40, 92, 105, 79, 131, 144, 118, 170, 183, 157, 209, 222, 196, 248, 261, 235, 287, 300, 274, 28, 
-	2, 15, 67, 41, 54, 106, 80, 93, 145, 119, 132, 184, 158, 171, 223, 197, 210, 262, 236, 249, 301, 275, 288, 
-	3, 16, 29, 42, 55, 68, 81, 94, 107, 120, 133, 146, 159, 172, 185, 198, 211, 224, 237, 250, 263, 276, 289, 302, 17, 30, 
-	4, 56, 69, 43, 95, 108, 82, 134, 147, 121, 173, 186, 160, 212, 225, 199, 251, 264, 238, 290, 303, 277, 31, 
-	5, 18, 70, 44, 57, 109, 83, 96, 148, 122, 135, 187, 161, 174, 226, 200, 213, 265, 239, 252, 304, 278, 291, 
-	6, 19, 32, 45, 58, 71, 84, 97, 110, 123, 136, 149, 162, 175, 188, 201, 214, 227, 240, 253, 266, 279, 292, 305, 20, 33, 
-	7, 59, 72, 46, 98, 111, 85, 137, 150, 124, 176, 189, 163, 215, 228, 202, 254, 267, 241, 293, 306, 280, 34, 
-	8, 21, 73, 47, 60, 112, 86, 99, 151, 125, 138, 190, 164, 177, 229, 203, 216, 268, 242, 255, 307, 281, 294, 
-	9, 22, 35, 48, 61, 74, 87, 100, 113, 126, 139, 152, 165, 178, 191, 204, 217, 230, 243, 256, 269, 282, 295, 308, 23, 36, 
-	10, 62, 75, 49, 101, 114, 88, 140, 153, 127, 179, 192, 166, 218, 231, 205, 257, 270, 244, 296, 309, 283, 37, 
-	11, 24, 76, 50, 63, 115, 89, 102, 154, 128, 141, 193, 167, 180, 232, 206, 219, 271, 245, 258, 310, 284, 297, 
-	12, 25, 38, 51, 64, 77, 90, 103, 116, 129, 142, 155, 168, 181, 194, 207, 220, 233, 246, 259, 272, 285, 298, 311
-};
-
-const int mapDeintNonlegacy64Qam2[312] = {
-	187, 161, 174, 226, 200, 213, 265, 239, 252, 304, 278, 291, 6, 19, 32, 45, 58, 71, 84, 97, 110, 123, 136, 149, 162, 175, 
-	188, 201, 214, 227, 240, 253, 266, 279, 292, 305, 20, 33, 7, 59, 72, 46, 98, 111, 85, 137, 150, 124, 176, 189, 163, 215, 
-	228, 202, 254, 267, 241, 293, 306, 280, 34, 8, 21, 73, 47, 60, 112, 86, 99, 151, 125, 138, 190, 164, 177, 229, 203, 216, 
-	268, 242, 255, 307, 281, 294, 9, 22, 35, 48, 61, 74, 87, 100, 113, 126, 139, 152, 165, 178, 191, 204, 217, 230, 243, 256, 
-	269, 282, 295, 308, 23, 36, 10, 62, 75, 49, 101, 114, 88, 140, 153, 127, 179, 192, 166, 218, 231, 205, 257, 270, 244, 296, 
-	309, 283, 37, 11, 24, 76, 50, 63, 115, 89, 102, 154, 128, 141, 193, 167, 180, 232, 206, 219, 271, 245, 258, 310, 284, 297, 
-	12, 25, 38, 51, 64, 77, 90, 103, 116, 129, 142, 155, 168, 181, 194, 207, 220, 233, 246, 259, 272, 285, 298, 311, 0, 13, 
-	26, 39, 52, 65, 78, 91, 104, 117, 130, 143, 156, 169, 182, 195, 208, 221, 234, 247, 260, 273, 286, 299, 14, 27, 1, 53, 66, 
-	40, 92, 105, 79, 131, 144, 118, 170, 183, 157, 209, 222, 196, 248, 261, 235, 287, 300, 274, 28, 2, 15, 67, 41, 54, 106, 80, 
-	93, 145, 119, 132, 184, 158, 171, 223, 197, 210, 262, 236, 249, 301, 275, 288, 3, 16, 29, 42, 55, 68, 81, 94, 107, 120, 133, 
-	146, 159, 172, 185, 198, 211, 224, 237, 250, 263, 276, 289, 302, 17, 30, 4, 56, 69, 43, 95, 108, 82, 134, 147, 121, 173, 186, 
-	160, 212, 225, 199, 251, 264, 238, 290, 303, 277, 31, 5, 18, 70, 44, 57, 109, 83, 96, 148, 122, 135
-};
-
-const int mapDeintNonlegacy256Qam[416] = {
-	0, 13, 26, 39, 52, 65, 78, 91, 104, 117, 130, 143, 156, 169, 182, 195, 208, 221, 234, 247, 260, 273, 286, 299, 312, 325, 338, 351, 364, 377, 390, 403, 14, 27, 40, 
-	1, 66, 79, 92, 53, 118, 131, 144, 105, 170, 183, 196, 157, 222, 235, 248, 209, 274, 287, 300, 261, 326, 339, 352, 313, 378, 391, 404, 365, 28, 41, 
-	2, 15, 80, 93, 54, 67, 132, 145, 106, 119, 184, 197, 158, 171, 236, 249, 210, 223, 288, 301, 262, 275, 340, 353, 314, 327, 392, 405, 366, 379, 42, 
-	3, 16, 29, 94, 55, 68, 81, 146, 107, 120, 133, 198, 159, 172, 185, 250, 211, 224, 237, 302, 263, 276, 289, 354, 315, 328, 341, 406, 367, 380, 393, 
-	4, 17, 30, 43, 56, 69, 82, 95, 108, 121, 134, 147, 160, 173, 186, 199, 212, 225, 238, 251, 264, 277, 290, 303, 316, 329, 342, 355, 368, 381, 394, 407, 18, 31, 44, 
-	5, 70, 83, 96, 57, 122, 135, 148, 109, 174, 187, 200, 161, 226, 239, 252, 213, 278, 291, 304, 265, 330, 343, 356, 317, 382, 395, 408, 369, 32, 45, 
-	6, 19, 84, 97, 58, 71, 136, 149, 110, 123, 188, 201, 162, 175, 240, 253, 214, 227, 292, 305, 266, 279, 344, 357, 318, 331, 396, 409, 370, 383, 46, 
-	7, 20, 33, 98, 59, 72, 85, 150, 111, 124, 137, 202, 163, 176, 189, 254, 215, 228, 241, 306, 267, 280, 293, 358, 319, 332, 345, 410, 371, 384, 397, 
-	8, 21, 34, 47, 60, 73, 86, 99, 112, 125, 138, 151, 164, 177, 190, 203, 216, 229, 242, 255, 268, 281, 294, 307, 320, 333, 346, 359, 372, 385, 398, 411, 22, 35, 48, 
-	9, 74, 87, 100, 61, 126, 139, 152, 113, 178, 191, 204, 165, 230, 243, 256, 217, 282, 295, 308, 269, 334, 347, 360, 321, 386, 399, 412, 373, 36, 49, 
-	10, 23, 88, 101, 62, 75, 140, 153, 114, 127, 192, 205, 166, 179, 244, 257, 218, 231, 296, 309, 270, 283, 348, 361, 322, 335, 400, 413, 374, 387, 50, 
-	11, 24, 37, 102, 63, 76, 89, 154, 115, 128, 141, 206, 167, 180, 193, 258, 219, 232, 245, 310, 271, 284, 297, 362, 323, 336, 349, 414, 375, 388, 401, 
-	12, 25, 38, 51, 64, 77, 90, 103, 116, 129, 142, 155, 168, 181, 194, 207, 220, 233, 246, 259, 272, 285, 298, 311, 324, 337, 350, 363, 376, 389, 402, 415
-};
+constexpr std::array<int, 52> mapDeintVhtSigB20 = c8pDeintMap<52>(C8P_INTEL_NCOL_NL20, 1, 1, C8P_INTEL_NROT_NL20);
+constexpr std::array<int, 52> mapIntelVhtSigB20 = c8pIntelMap<52>(C8P_INTEL_NCOL_NL20, 1, 1, C8P_INTEL_NROT_NL20);
+constexpr std::array<int, 52> mapIntelNonlegacyBpsk = c8pIntelMap<52>(C8P_INTEL_NCOL_NL20, 1, 1, C8P_INTEL_NROT_NL20);
+constexpr std::array<int, 52> mapIntelNonlegacyBpsk2 = c8pIntelMap<52>(C8P_INTEL_NCOL_NL20, 1, 2, C8P_INTEL_NROT_NL20);
+constexpr std::array<int, 104> mapIntelNonlegacyQpsk = c8pIntelMap<104>(C8P_INTEL_NCOL_NL20, 2, 1, C8P_INTEL_NROT_NL20);
+constexpr std::array<int, 104> mapIntelNonlegacyQpsk2 = c8pIntelMap<104>(C8P_INTEL_NCOL_NL20, 2, 2, C8P_INTEL_NROT_NL20);
+constexpr std::array<int, 208> mapIntelNonlegacy16Qam = c8pIntelMap<208>(C8P_INTEL_NCOL_NL20, 4, 1, C8P_INTEL_NROT_NL20);
+constexpr std::array<int, 208> mapIntelNonlegacy16Qam2 = c8pIntelMap<208>(C8P_INTEL_NCOL_NL20, 4, 2, C8P_INTEL_NROT_NL20);
+constexpr std::array<int, 312> mapIntelNonlegacy64Qam = c8pIntelMap<312>(C8P_INTEL_NCOL_NL20, 6, 1, C8P_INTEL_NROT_NL20);
+constexpr std::array<int, 312> mapIntelNonlegacy64Qam2 = c8pIntelMap<312>(C8P_INTEL_NCOL_NL20, 6, 2, C8P_INTEL_NROT_NL20);
+constexpr std::array<int, 416> mapIntelNonlegacy256Qam = c8pIntelMap<416>(C8P_INTEL_NCOL_NL20, 8, 1, C8P_INTEL_NROT_NL20);
+constexpr std::array<int, 416> mapIntelNonlegacy256Qam2 = c8pIntelMap<416>(C8P_INTEL_NCOL_NL20, 8, 2, C8P_INTEL_NROT_NL20);
+constexpr std::array<int, 52> mapDeintNonlegacyBpsk = c8pDeintMap<52>(C8P_INTEL_NCOL_NL20, 1, 1, C8P_INTEL_NROT_NL20);
+constexpr std::array<int, 52> mapDeintNonlegacyBpsk2 = c8pDeintMap<52>(C8P_INTEL_NCOL_NL20, 1, 2, C8P_INTEL_NROT_NL20);
+constexpr std::array<int, 104> mapDeintNonlegacyQpsk = c8pDeintMap<104>(C8P_INTEL_NCOL_NL20, 2, 1, C8P_INTEL_NROT_NL20);
+constexpr std::array<int, 104> mapDeintNonlegacyQpsk2 = c8pDeintMap<104>(C8P_INTEL_NCOL_NL20, 2, 2, C8P_INTEL_NROT_NL20);
+constexpr std::array<int, 208> mapDeintNonlegacy16Qam = c8pDeintMap<208>(C8P_INTEL_NCOL_NL20, 4, 1, C8P_INTEL_NROT_NL20);
+constexpr std::array<int, 208> mapDeintNonlegacy16Qam2 = c8pDeintMap<208>(C8P_INTEL_NCOL_NL20, 4, 2, C8P_INTEL_NROT_NL20);
+constexpr std::array<int, 312> mapDeintNonlegacy64Qam = c8pDeintMap<312>(C8P_INTEL_NCOL_NL20, 6, 1, C8P_INTEL_NROT_NL20);
+constexpr std::array<int, 312> mapDeintNonlegacy64Qam2 = c8pDeintMap<312>(C8P_INTEL_NCOL_NL20, 6, 2, C8P_INTEL_NROT_NL20);
+constexpr std::array<int, 416> mapDeintNonlegacy256Qam = c8pDeintMap<416>(C8P_INTEL_NCOL_NL20, 8, 1, C8P_INTEL_NROT_NL20);
+constexpr std::array<int, 416> mapDeintNonlegacy256Qam2 = c8pDeintMap<416>(C8P_INTEL_NCOL_NL20, 8, 2, C8P_INTEL_NROT_NL20);
+
+// each map is a permutation and has the entries 1, N/2 and N-1 of the tables of the standard
+template<size_t N>
+constexpr bool c8pMapCheck(const std::array<int, N>& m, int e1, int eHalf, int eLast)
+{
+	bool tmpSeen[N] = {};
+	for(size_t k=0;k<N;k++)
+	{
+		if(m[k] < 0 || m[k] >= (int)N || tmpSeen[m[k]])
+		{
+			return false;
+		}
+		tmpSeen[m[k]] = true;
+	}
+	return m[1] == e1 && m[N / 2] == eHalf && m[N - 1] == eLast;
+}
 
-const int mapDeintNonlegacy256Qam2[416] = {
-	226, 239, 252, 213, 278, 291, 304, 265, 330, 343, 356, 317, 382, 395, 408, 369, 32, 45, 6, 19, 84, 97, 58, 71, 136, 149, 110, 123, 188, 201, 162, 175, 
-	240, 253, 214, 227, 292, 305, 266, 279, 344, 357, 318, 331, 396, 409, 370, 383, 46, 7, 20, 33, 98, 59, 72, 85, 150, 111, 124, 137, 202, 163, 176, 189, 
-	254, 215, 228, 241, 306, 267, 280, 293, 358, 319, 332, 345, 410, 371, 384, 397, 8, 21, 34, 47, 60, 73, 86, 99, 112, 125, 138, 151, 164, 177, 190, 203, 
-	216, 229, 242, 255, 268, 281, 294, 307, 320, 333, 346, 359, 372, 385, 398, 411, 22, 35, 48, 9, 74, 87, 100, 61, 126, 139, 152, 113, 178, 191, 204, 165, 
-	230, 243, 256, 217, 282, 295, 308, 269, 334, 347, 360, 321, 386, 399, 412, 373, 36, 49, 10, 23, 88, 101, 62, 75, 140, 153, 114, 127, 192, 205, 166, 179, 
-	244, 257, 218, 231, 296, 309, 270, 283, 348, 361, 322, 335, 400, 413, 374, 387, 50, 11, 24, 37, 102, 63, 76, 89, 154, 115, 128, 141, 206, 167, 180, 193, 
-	258, 219, 232, 245, 310, 271, 284, 297, 362, 323, 336, 349, 414, 375, 388, 401, 12, 25, 38, 51, 64, 77, 90, 103, 116, 129, 142, 155, 168, 181, 194, 207, 
-	220, 233, 246, 259, 272, 285, 298, 311, 324, 337, 350, 363, 376, 389, 402, 415, 0, 13, 26, 39, 52, 65, 78, 91, 104, 117, 130, 143, 156, 169, 182, 195, 
-	208, 221, 234, 247, 260, 273, 286, 299, 312, 325, 338, 351, 364, 377, 390, 403, 14, 27, 40, 1, 66, 79, 92, 53, 118, 131, 144, 105, 170, 183, 196, 157, 
-	222, 235, 248, 209, 274, 287, 300, 261, 326, 339, 352, 313, 378, 391, 404, 365, 28, 41, 2, 15, 80, 93, 54, 67, 132, 145, 106, 119, 184, 197, 158, 171, 
-	236, 249, 210, 223, 288, 301, 262, 275, 340, 353, 314, 327, 392, 405, 366, 379, 42, 3, 16, 29, 94, 55, 68, 81, 146, 107, 120, 133, 198, 159, 172, 185, 
-	250, 211, 224, 237, 302, 263, 276, 289, 354, 315, 328, 341, 406, 367, 380, 393, 4, 17, 30, 43, 56, 69, 82, 95, 108, 121, 134, 147, 160, 173, 186, 199, 
-	212, 225, 238, 251, 264, 277, 290, 303, 316, 329, 342, 355, 368, 381, 394, 407, 18, 31, 44, 5, 70, 83, 96, 57, 122, 135, 148, 109, 174, 187, 200, 161
-};
+static_assert(c8pMapCheck(mapIntelLegacyBpsk, 3, 25, 47), "mapIntelLegacyBpsk");
+static_assert(c8pMapCheck(mapDeintLegacyBpsk, 16, 8, 47), "mapDeintLegacyBpsk");
+static_assert(c8pMapCheck(mapIntelLegacyQpsk, 6, 3, 95), "mapIntelLegacyQpsk");
+static_assert(c8pMapCheck(mapDeintLegacyQpsk, 16, 8, 95), "mapDeintLegacyQpsk");
+static_assert(c8pMapCheck(mapIntelLegacy16Qam, 13, 6, 190), "mapIntelLegacy16Qam");
+static_assert(c8pMapCheck(mapDeintLegacy16Qam, 16, 8, 175), "mapDeintLegacy16Qam");
+static_assert(c8pMapCheck(mapIntelLegacy64Qam, 20, 9, 287), "mapIntelLegacy64Qam");
+static_assert(c8pMapCheck(mapDeintLegacy64Qam, 16, 40, 287), "mapDeintLegacy64Qam");
+static_assert(c8pMapCheck(mapDeintVhtSigB20, 13, 32, 51), "mapDeintVhtSigB20");
+static_assert(c8pMapCheck(mapIntelVhtSigB20, 4, 2, 51), "mapIntelVhtSigB20");
+static_assert(c8pMapCheck(mapIntelNonlegacyBpsk, 4, 2, 51), "mapIntelNonlegacyBpsk");
+static_assert(c8pMapCheck(mapIntelNonlegacyBpsk2, 34, 32, 29), "mapIntelNonlegacyBpsk2");
+static_assert(c8pMapCheck(mapIntelNonlegacyQpsk, 8, 4, 103), "mapIntelNonlegacyQpsk");
+static_assert(c8pMapCheck(mapIntelNonlegacyQpsk2, 68, 64, 59), "mapIntelNonlegacyQpsk2");
+static_assert(c8pMapCheck(mapIntelNonlegacy16Qam, 17, 8, 207), "mapIntelNonlegacy16Qam");
+static_assert(c8pMapCheck(mapIntelNonlegacy16Qam2, 137, 128, 119), "mapIntelNonlegacy16Qam2");
+static_assert(c8pMapCheck(mapIntelNonlegacy64Qam, 26, 12, 311), "mapIntelNonlegacy64Qam");
+static_assert(c8pMapCheck(mapIntelNonlegacy64Qam2, 206, 192, 179), "mapIntelNonlegacy64Qam2");
+static_assert(c8pMapCheck(mapIntelNonlegacy256Qam, 35, 16, 415), "mapIntelNonlegacy256Qam");
+static_assert(c8pMapCheck(mapIntelNonlegacy256Qam2, 275, 256, 239), "mapIntelNonlegacy256Qam2");
+static_assert(c8pMapCheck(mapDeintNonlegacyBpsk, 13, 32, 51), "mapDeintNonlegacyBpsk");
+static_assert(c8pMapCheck(mapDeintNonlegacyBpsk2, 44, 12, 18), "mapDeintNonlegacyBpsk2");
+static_assert(c8pMapCheck(mapDeintNonlegacyQpsk, 13, 58, 103), "mapDeintNonlegacyQpsk");
+static_assert(c8pMapCheck(mapDeintNonlegacyQpsk2, 70, 12, 44), "mapDeintNonlegacyQpsk2");
+static_assert(c8pMapCheck(mapDeintNonlegacy16Qam, 13, 110, 207), "mapDeintNonlegacy16Qam");
+static_assert(c8pMapCheck(mapDeintNonlegacy16Qam2, 109, 12, 83), "mapDeintNonlegacy16Qam2");
+static_assert(c8pMapCheck(mapDeintNonlegacy64Qam, 13, 162, 311), "mapDeintNonlegacy64Qam");
+static_assert(c8pMapCheck(mapDeintNonlegacy64Qam2, 161, 12, 135), "mapDeintNonlegacy64Qam2");
+static_assert(c8pMapCheck(mapDeintNonlegacy256Qam, 13, 240, 415), "mapDeintNonlegacy256Qam");
+static_assert(c8pMapCheck(mapDeintNonlegacy256Qam2, 239, 12, 161), "mapDeintNonlegacy256Qam2");
+
+template<typename T, size_t N, const std::array<int, N>& map>
+static inline void procSymPermute(const T* in, T* out)
+{
+	// map is constant per instance, so each modulation gets its own unrolled copy
+	for(size_t i=0;i<N;i++)
+	{
+		out[map[i]] = in[i];
+	}
+}
 
 void procDeintLegacyBpsk(float* inBits, float* outBits)
 {
-    for(int i=0;i<48;i++)
-    {
-        outBits[mapDeintLegacyBpsk[i]] = inBits[i];
-    }
+	procSymPermute<float, 48, mapDeintLegacyBpsk>(inBits, outBits);
 }
 
 void procIntelLegacyBpsk(uint8_t* inBits, uint8_t* outBits)
 {
-	for(int i=0;i<48;i++)
-    {
-        outBits[mapIntelLegacyBpsk[i]] = inBits[i];
-    }
+	procSymPermute<uint8_t, 48, mapIntelLegacyBpsk>(inBits, outBits);
 }
 
 void procIntelVhtB20(uint8_t* inBits, uint8_t* outBits)
 {
-	for(int i=0;i<52;i++)
-    {
-        outBits[mapIntelVhtSigB20[i]] = inBits[i];
-    }
+	procSymPermute<uint8_t, 52, mapIntelVhtSigB20>(inBits, outBits);
 }
 
 const int SV_PUNC_12[2] = {1, 1};
@@ -1998,153 +1694,390 @@ void SV_Decode_Sig(float* llrv, uint8_t* decoded_bits, int trellisLen)
 	free(state_sequence);
 }
 
+static inline void svSigTraceback(const uint64_t* his, int trellisLen, uint8_t* decoded_bits)
+{
+	// the final state should be 0, the bit decoded at each step is the top bit of the state it ends in
+	int state = 0;
+	for(int j=trellisLen;j>0;j--)
+	{
+		decoded_bits[j-1] = (uint8_t)(state >> 5);
+		state = ((state & 31) << 1) | (int)((his[j] >> state) & 1);
+	}
+}
+
+template<int L>
+void svSigDecoder::decodeFixed(const float* llrv, uint8_t* decoded_bits)
+{
+	for(int i=0;i<64;i++)
+	{
+		pm[i] = SV_METRIC_INIT;
+	}
+	pm[0] = 0;
+	svAcsRun(llrv, L, pm, &his[1]);
+	svSigTraceback(his, L, decoded_bits);
+}
+
 void svSigDecoder::decode(float* llrv, uint8_t* decoded_bits, int trellisLen)
 {
-	if(trellisLen < 0 || trellisLen > 48)
+	switch(trellisLen)
+	{
+		case 24:
+			decodeFixed<24>(llrv, decoded_bits);
+			return;
+		case 26:
+			decodeFixed<26>(llrv, decoded_bits);
+			return;
+		case 48:
+			decodeFixed<48>(llrv, decoded_bits);
+			return;
+		default:
+			break;
+	}
+	if(trellisLen < 0 || trellisLen > SV_SIG_T_MAX)
 	{
 		return;
 	}
-	/* initialize data structures */
-	for (i = 0; i < 64; i++)
+	for(int i=0;i<64;i++)
 	{
-		for (j = 0; j <= trellisLen; j++)
+		pm[i] = SV_METRIC_INIT;
+	}
+	pm[0] = 0;
+	svAcsRun(llrv, trellisLen, pm, &his[1]);
+	svSigTraceback(his, trellisLen, decoded_bits);
+}
+
+void procCsiWeights(const float* scW, float* qamW, int format)
+{
+	// data subcarriers in the qam order of the chan update, normalized to mean 1
+	int tmpNSd = (format == C8P_F_L) ? 48 : 52;
+	int j = tmpNSd / 2;
+	float tmpSum = 0.0f;
+	for(int i=0;i<64;i++)
+	{
+		if(i==0 || i==7 || i==21 || i==43 || i==57)
 		{
-			state_history[i][j] = 0;
+			continue;
 		}
-		/* initial the accumulated error metrics */
-		accum_err_metric0[i] = -1000000000000000.0f;
-		accum_err_metric1[i] = -1000000000000000.0f;
+		if((format == C8P_F_L && i>=27 && i<=37) || (format != C8P_F_L && i>=29 && i<=35))
+		{
+			continue;
+		}
+		qamW[j] = scW[i];
+		tmpSum += scW[i];
+		j++;
+		if(j >= tmpNSd){j = 0;}
 	}
-	accum_err_metric0[0] = 0;
-	cur_accum_err_metric = accum_err_metric1;
-	pre_accum_err_metric = accum_err_metric0;
-
-	/* start viterbi decoding */
-	for (t=0; t<trellisLen; t++)
+	float tmpNorm = (tmpSum > 0.0f) ? ((float)tmpNSd / tmpSum) : 0.0f;
+	for(int i=0;i<tmpNSd;i++)
 	{
-		t0 = *llrv++;
-		t1 = *llrv++;
+		qamW[i] *= tmpNorm;
+	}
+}
 
-		tbl_t[0] = 0;
-		tbl_t[1] = t1;
-		tbl_t[2] = t0;
-		tbl_t[3] = t1+t0;
+static const float C8P_CSI_ONE[52] = {
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
 
-		/* repeat for each possible state */
-		for (i = 0; i < 64; i++)
-		{
-			op0 = SV_STATE_OUTPUT[i][0];
-			op1 = SV_STATE_OUTPUT[i][1];
+static float procQamScale(int qam)
+{
+	switch(qam)
+	{
+		case C8P_QAM_QPSK:
+			return 1.4142135623730951f;
+		case C8P_QAM_16QAM:
+			return 3.1622776601683795f;
+		case C8P_QAM_64QAM:
+			return 6.48074069840786f;
+		case C8P_QAM_256QAM:
+			return 13.038404810405298f;
+		default:
+			return 1.0f;
+	}
+}
 
-			acc_tmp0 = pre_accum_err_metric[i] + tbl_t[op0];
-			acc_tmp1 = pre_accum_err_metric[i] + tbl_t[op1];
+static void procSymQamToLlrScalar(const gr_complex* inQam, float* outLlr, int nSD, int nBPSCS, float tmpScale, const float* csi)
+{
+	if(nBPSCS == 1)
+	{
+		for(int i=0;i<nSD;i++)
+		{
+			outLlr[i] = inQam[i].real() * csi[i];
+		}
+		return;
+	}
+	int tmpHalf = nBPSCS / 2;
+	float tmpA = (float)(1 << (tmpHalf - 1));
+	for(int i=0;i<nSD;i++)
+	{
+		// max-log of the gray mapped axes, each bit folds the distance of the previous one
+		float tmpX[2] = {inQam[i].real() * tmpScale, inQam[i].imag() * tmpScale};
+		for(int c=0;c<2;c++)
+		{
+			float* o = &outLlr[i*nBPSCS + c*tmpHalf];
+			float tmpB = tmpX[c];
+			float tmpLevel = tmpA;
+			o[0] = tmpB * csi[i];
+			for(int k=1;k<tmpHalf;k++)
+			{
+				tmpB = tmpLevel - std::abs(tmpB);
+				o[k] = tmpB * csi[i];
+				tmpLevel *= 0.5f;
+			}
+		}
+	}
+}
 
-			next0 = SV_STATE_NEXT[i][0];
-			next1 = SV_STATE_NEXT[i][1];
+#ifdef C8P_EQ_X86
 
-			if (acc_tmp0 > cur_accum_err_metric[next0])
+template<int tmpHalf>
+__attribute__((target("avx2")))
+static void procSymQamToLlrAvx2(const gr_complex* inQam, float* outLlr, int nSD, float tmpScale, const float* csi)
+{
+	const __m256 vScale = _mm256_set1_ps(tmpScale);
+	const __m256 vAbs = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+	const __m256i vDup = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+	for(int i=0;i<nSD;i+=4)
+	{
+		// 4 subcarriers, one lane per axis, the weight of each subcarrier on both of its axes
+		__m256 x = _mm256_loadu_ps((const float*)&inQam[i]);
+		__m256 w = _mm256_permutevar8x32_ps(_mm256_castps128_ps256(_mm_loadu_ps(&csi[i])), vDup);
+		__m256 b[4];
+		b[0] = _mm256_mul_ps(x, vScale);
+		float tmpLevel = (float)(1 << (tmpHalf - 1));
+		for(int k=1;k<tmpHalf;k++)
+		{
+			b[k] = _mm256_sub_ps(_mm256_set1_ps(tmpLevel), _mm256_and_ps(b[k-1], vAbs));
+			tmpLevel *= 0.5f;
+		}
+		for(int k=0;k<tmpHalf;k++)
+		{
+			b[k] = _mm256_mul_ps(b[k], w);
+		}
+		float* o = &outLlr[i*tmpHalf*2];
+		if(tmpHalf == 1)
+		{
+			_mm256_storeu_ps(o, b[0]);
+		}
+		else if(tmpHalf == 2)
+		{
+			__m256 lo = _mm256_unpacklo_ps(b[0], b[1]);
+			__m256 hi = _mm256_unpackhi_ps(b[0], b[1]);
+			_mm256_storeu_ps(o, _mm256_permute2f128_ps(lo, hi, 0x20));
+			_mm256_storeu_ps(o + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+		}
+		else if(tmpHalf == 4)
+		{
+			__m256 t0 = _mm256_unpacklo_ps(b[0], b[1]);
+			__m256 t1 = _mm256_unpackhi_ps(b[0], b[1]);
+			__m256 t2 = _mm256_unpacklo_ps(b[2], b[3]);
+			__m256 t3 = _mm256_unpackhi_ps(b[2], b[3]);
+			__m256 c0 = _mm256_shuffle_ps(t0, t2, 0x44);
+			__m256 c1 = _mm256_shuffle_ps(t0, t2, 0xee);
+			__m256 c2 = _mm256_shuffle_ps(t1, t3, 0x44);
+			__m256 c3 = _mm256_shuffle_ps(t1, t3, 0xee);
+			_mm256_storeu_ps(o, _mm256_permute2f128_ps(c0, c1, 0x20));
+			_mm256_storeu_ps(o + 8, _mm256_permute2f128_ps(c2, c3, 0x20));
+			_mm256_storeu_ps(o + 16, _mm256_permute2f128_ps(c0, c1, 0x31));
+			_mm256_storeu_ps(o + 24, _mm256_permute2f128_ps(c2, c3, 0x31));
+		}
+		else
+		{
+			alignas(32) float tmpB[3][8];
+			for(int k=0;k<3;k++)
 			{
-				cur_accum_err_metric[next0] = acc_tmp0;
-				state_history[next0][t+1] = i;			//path
+				_mm256_store_ps(tmpB[k], b[k]);
 			}
-
-			if (acc_tmp1 > cur_accum_err_metric[next1])
+			for(int c=0;c<8;c++)
 			{
-				cur_accum_err_metric[next1] = acc_tmp1;
-				state_history[next1][t+1] = i;
+				o[c*3] = tmpB[0][c];
+				o[c*3+1] = tmpB[1][c];
+				o[c*3+2] = tmpB[2][c];
 			}
 		}
+	}
+}
 
-		/* update accum_err_metric array */
-		tmp = pre_accum_err_metric;
-		pre_accum_err_metric = cur_accum_err_metric;
-		cur_accum_err_metric = tmp;
-
-		for (i = 0; i < 64; i++)
-		{
-			cur_accum_err_metric[i] = -1000000000000000.0f;
-		}
-	} // end of t loop
+#endif
 
-	// The final state should be 0
-	state_sequence[trellisLen] = 0;
+void procSymQamToLlr(const gr_complex* inQam, float* outLlr, c8p_mod* mod, const float* csi)
+{
+	if(!csi)
+	{
+		csi = C8P_CSI_ONE;
+	}
+#ifdef C8P_EQ_X86
+	static const bool avx2 = __builtin_cpu_supports("avx2");
+	if(avx2 && !(mod->nSD & 3))
+	{
+		switch(mod->nBPSCS)
+		{
+			case 2:
+				procSymQamToLlrAvx2<1>(inQam, outLlr, mod->nSD, procQamScale(mod->mod), csi);
+				return;
+			case 4:
+				procSymQamToLlrAvx2<2>(inQam, outLlr, mod->nSD, procQamScale(mod->mod), csi);
+				return;
+			case 6:
+				procSymQamToLlrAvx2<3>(inQam, outLlr, mod->nSD, procQamScale(mod->mod), csi);
+				return;
+			case 8:
+				procSymQamToLlrAvx2<4>(inQam, outLlr, mod->nSD, procQamScale(mod->mod), csi);
+				return;
+			default:
+				break;
+		}
+	}
+#endif
+	procSymQamToLlrScalar(inQam, outLlr, mod->nSD, mod->nBPSCS, procQamScale(mod->mod), csi);
+}
 
-	for (j = trellisLen; j > 0; j--)
+int llrItemSize(int llrType)
+{
+	switch(llrType)
 	{
-		state_sequence[j-1] = state_history[state_sequence[j]][j];
+		case C8P_LLR_I16:
+			return sizeof(int16_t);
+		case C8P_LLR_I8:
+			return sizeof(int8_t);
+		default:
+			return sizeof(float);
 	}
+}
 
-	for (j = 0; j < trellisLen; j++)
+float llrQuantScale(float snr, c8p_mod* mod, int llrType)
+{
+	// llr of procSymQamToLlr peaks at the outer constellation point, leave 3 sigma of noise above it before saturating
+	float tmpPeak, tmpQamScale;
+	switch(mod->mod)
 	{
-		if (state_sequence[j+1] == SV_STATE_NEXT[state_sequence[j]][1])
-		{
-			decoded_bits[j] = 1;
-		}
-		else
-		{
-			decoded_bits[j] = 0;
-		}
+		case C8P_QAM_QPSK:
+			tmpPeak = 1.0f;
+			tmpQamScale = 1.4142135623730951f;
+			break;
+		case C8P_QAM_16QAM:
+			tmpPeak = 3.0f;
+			tmpQamScale = 3.1622776601683795f;
+			break;
+		case C8P_QAM_64QAM:
+			tmpPeak = 7.0f;
+			tmpQamScale = 6.48074069840786f;
+			break;
+		case C8P_QAM_256QAM:
+			tmpPeak = 15.0f;
+			tmpQamScale = 13.038404810405298f;
+			break;
+		default:
+			tmpPeak = 1.0f;
+			tmpQamScale = 1.0f;
+			break;
 	}
+	float tmpSigma = tmpQamScale * sqrtf(0.5f * powf(10.0f, -std::max(snr, 0.0f) / 10.0f));
+	float tmpMax = (llrType == C8P_LLR_I8) ? 127.0f : 32767.0f;
+	return tmpMax / (tmpPeak + 3.0f * tmpSigma);
 }
 
-void procSymQamToLlr(gr_complex* inQam, float* outLlr, c8p_mod* mod)
+void procLlrQuant(const float* in, void* out, int len, float scale, int llrType)
 {
-	if(mod->mod == C8P_QAM_BPSK)
+	if(llrType == C8P_LLR_I16)
 	{
-		for(int i=0;i<mod->nSD;i++)
-		{
-			outLlr[i] = inQam[i].real();
-		}
+		volk_32f_s32f_convert_16i((int16_t*)out, in, scale, len);
 	}
-	else if(mod->mod == C8P_QAM_QPSK)
+	else if(llrType == C8P_LLR_I8)
 	{
-		for(int i=0;i<mod->nSD;i++)
-		{
-			inQam[i] *= 1.4142135623730951f;
-			outLlr[i*2] = inQam[i].real();
-			outLlr[i*2+1] = inQam[i].imag();
-		}
+		volk_32f_s32f_convert_8i((int8_t*)out, in, scale, len);
 	}
-	else if(mod->mod == C8P_QAM_16QAM)
+	else
 	{
-		for(int i=0;i<mod->nSD;i++)
-		{
-			inQam[i] *= 3.1622776601683795f;
-			outLlr[i*4] = inQam[i].real();
-			outLlr[i*4+1] = 2.0f - std::abs(inQam[i].real());
-			outLlr[i*4+2] = inQam[i].imag();
-			outLlr[i*4+3] = 2.0f - std::abs(inQam[i].imag());
-		}
+		memcpy(out, in, sizeof(float) * len);
 	}
-	else if(mod->mod == C8P_QAM_64QAM)
+}
+
+void procEq2Prep(const gr_complex h[64][4], float noise, c8p_eq2* eq)
+{
+	memset(eq, 0, sizeof(c8p_eq2));
+	for(int i=0;i<64;i++)
 	{
-		for(int i=0;i<mod->nSD;i++)
-		{
-			inQam[i] *= 6.48074069840786f;
-			outLlr[i*6] = inQam[i].real();
-			outLlr[i*6+1] = 4.0f - std::abs(inQam[i].real());
-			outLlr[i*6+2] = 2 - std::abs(4.0f - std::abs(inQam[i].real()));
-			outLlr[i*6+3] = inQam[i].imag();
-			outLlr[i*6+4] = 4.0f - std::abs(inQam[i].imag());
-			outLlr[i*6+5] = 2 - std::abs(4.0f - std::abs(inQam[i].imag()));
-		}
+		if(i==0 || (i>=29 && i<=35))
+		{
+			continue;
+		}
+		// h0 and h1 are stream 1 at the two antennas, h2 and h3 stream 2
+		gr_complex a = h[i][0] * std::conj(h[i][0]) + h[i][1] * std::conj(h[i][1]) + noise;
+		gr_complex b = h[i][0] * std::conj(h[i][2]) + h[i][1] * std::conj(h[i][3]);
+		gr_complex c = h[i][2] * std::conj(h[i][0]) + h[i][3] * std::conj(h[i][1]);
+		gr_complex d = h[i][2] * std::conj(h[i][2]) + h[i][3] * std::conj(h[i][3]) + noise;
+		gr_complex tmpadbc = 1.0f/(a*d - b*c);
+		gr_complex inv0 = tmpadbc*d;
+		gr_complex inv1 = -tmpadbc*b;
+		gr_complex inv2 = -tmpadbc*c;
+		gr_complex inv3 = tmpadbc*a;
+		gr_complex w[4];
+		w[0] = inv0 * std::conj(h[i][0]) + inv2 * std::conj(h[i][2]);
+		w[1] = inv0 * std::conj(h[i][1]) + inv2 * std::conj(h[i][3]);
+		w[2] = inv1 * std::conj(h[i][0]) + inv3 * std::conj(h[i][2]);
+		w[3] = inv1 * std::conj(h[i][1]) + inv3 * std::conj(h[i][3]);
+		for(int k=0;k<4;k++)
+		{
+			eq->wRe[k][i*2] = w[k].real();
+			eq->wRe[k][i*2+1] = w[k].real();
+			eq->wIm[k][i*2] = w[k].imag();
+			eq->wIm[k][i*2+1] = w[k].imag();
+		}
+		// the noise of stream k is scaled by the diagonal of the inverse
+		eq->snr[0][i] = 1.0f / std::max(inv0.real(), 1e-9f);
+		eq->snr[1][i] = 1.0f / std::max(inv3.real(), 1e-9f);
 	}
-	else if(mod->mod == C8P_QAM_256QAM)
+}
+
+static void procEq2ApplyScalar(const c8p_eq2* eq, const gr_complex* y1, const gr_complex* y2, gr_complex* s1, gr_complex* s2)
+{
+	const float* a = (const float*)y1;
+	const float* b = (const float*)y2;
+	float* o1 = (float*)s1;
+	float* o2 = (float*)s2;
+	for(int i=0;i<128;i+=2)
 	{
-		for(int i=0;i<mod->nSD;i++)
-		{
-			inQam[i] *= 13.038404810405298f;
-			outLlr[i*8] = inQam[i].real();
-			outLlr[i*8+1] = 8.0f - std::abs(inQam[i].real());
-			outLlr[i*8+2] = 4 - std::abs(8.0f - std::abs(inQam[i].real()));
-			outLlr[i*8+3] = 2 - std::abs(4 - std::abs(8.0f - std::abs(inQam[i].real())));
-			outLlr[i*8+4] = inQam[i].imag();
-			outLlr[i*8+5] = 8.0f - std::abs(inQam[i].imag());
-			outLlr[i*8+6] = 4 - std::abs(8.0f - std::abs(inQam[i].imag()));
-			outLlr[i*8+7] = 2 - std::abs(4 - std::abs(8.0f - std::abs(inQam[i].imag())));
+		o1[i] = a[i]*eq->wRe[0][i] - a[i+1]*eq->wIm[0][i] + b[i]*eq->wRe[1][i] - b[i+1]*eq->wIm[1][i];
+		o1[i+1] = a[i+1]*eq->wRe[0][i] + a[i]*eq->wIm[0][i] + b[i+1]*eq->wRe[1][i] + b[i]*eq->wIm[1][i];
+		o2[i] = a[i]*eq->wRe[2][i] - a[i+1]*eq->wIm[2][i] + b[i]*eq->wRe[3][i] - b[i+1]*eq->wIm[3][i];
+		o2[i+1] = a[i+1]*eq->wRe[2][i] + a[i]*eq->wIm[2][i] + b[i+1]*eq->wRe[3][i] + b[i]*eq->wIm[3][i];
+	}
+}
 
-		}
+#ifdef C8P_EQ_X86
+
+__attribute__((target("avx2,fma")))
+static void procEq2ApplyAvx2(const c8p_eq2* eq, const gr_complex* y1, const gr_complex* y2, gr_complex* s1, gr_complex* s2)
+{
+	for(int i=0;i<128;i+=8)
+	{
+		// 4 subcarriers, the swapped samples times the imaginary planes go through addsub
+		__m256 a = _mm256_loadu_ps((const float*)y1 + i);
+		__m256 b = _mm256_loadu_ps((const float*)y2 + i);
+		__m256 as = _mm256_permute_ps(a, 0xb1);
+		__m256 bs = _mm256_permute_ps(b, 0xb1);
+		__m256 r = _mm256_fmadd_ps(b, _mm256_loadu_ps(&eq->wRe[1][i]), _mm256_mul_ps(a, _mm256_loadu_ps(&eq->wRe[0][i])));
+		__m256 q = _mm256_fmadd_ps(bs, _mm256_loadu_ps(&eq->wIm[1][i]), _mm256_mul_ps(as, _mm256_loadu_ps(&eq->wIm[0][i])));
+		_mm256_storeu_ps((float*)s1 + i, _mm256_addsub_ps(r, q));
+		r = _mm256_fmadd_ps(b, _mm256_loadu_ps(&eq->wRe[3][i]), _mm256_mul_ps(a, _mm256_loadu_ps(&eq->wRe[2][i])));
+		q = _mm256_fmadd_ps(bs, _mm256_loadu_ps(&eq->wIm[3][i]), _mm256_mul_ps(as, _mm256_loadu_ps(&eq->wIm[2][i])));
+		_mm256_storeu_ps((float*)s2 + i, _mm256_addsub_ps(r, q));
+	}
+}
+
+#endif
+
+void procEq2Apply(const c8p_eq2* eq, const gr_complex* y1, const gr_complex* y2, gr_complex* s1, gr_complex* s2)
+{
+#ifdef C8P_EQ_X86
+	static const bool avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+	if(avx2)
+	{
+		procEq2ApplyAvx2(eq, y1, y2, s1, s2);
+		return;
 	}
+#endif
+	procEq2ApplyScalar(eq, y1, y2, s1, s2);
 }
 
 void procSymDeintL2(float* in, float* out, c8p_mod* mod)
@@ -2154,34 +2087,22 @@ void procSymDeintL2(float* in, float* out, c8p_mod* mod)
 	{
 		case 48:
 		{
-			for(int i=0; i<48; i++)
-			{
-				out[mapDeintLegacyBpsk[i]] = in[i];
-			}
+			procSymPermute<float, 48, mapDeintLegacyBpsk>(in, out);
 			return;
 		}
 		case 96:
 		{
-			for(int i=0; i<96; i++)
-			{
-				out[mapDeintLegacyQpsk[i]] = in[i];
-			}
+			procSymPermute<float, 96, mapDeintLegacyQpsk>(in, out);
 			return;
 		}
 		case 192:
 		{
-			for(int i=0; i<192; i++)
-			{
-				out[mapDeintLegacy16Qam[i]] = in[i];
-			}
+			procSymPermute<float, 192, mapDeintLegacy16Qam>(in, out);
 			return;
 		}
 		case 288:
 		{
-			for(int i=0; i<288; i++)
-			{
-				out[mapDeintLegacy64Qam[i]] = in[i];
-			}
+			procSymPermute<float, 288, mapDeintLegacy64Qam>(in, out);
 			return;
 		}
 		default:
@@ -2198,34 +2119,22 @@ void procSymIntelL2(uint8_t* in, uint8_t* out, c8p_mod* mod)
 	{
 		case 48:
 		{
-			for(int i=0; i<48; i++)
-			{
-				out[mapIntelLegacyBpsk[i]] = in[i];
-			}
+			procSymPermute<uint8_t, 48, mapIntelLegacyBpsk>(in, out);
 			return;
 		}
 		case 96:
 		{
-			for(int i=0; i<96; i++)
-			{
-				out[mapIntelLegacyQpsk[i]] = in[i];
-			}
+			procSymPermute<uint8_t, 96, mapIntelLegacyQpsk>(in, out);
 			return;
 		}
 		case 192:
 		{
-			for(int i=0; i<192; i++)
-			{
-				out[mapIntelLegacy16Qam[i]] = in[i];
-			}
+			procSymPermute<uint8_t, 192, mapIntelLegacy16Qam>(in, out);
 			return;
 		}
 		case 288:
 		{
-			for(int i=0; i<288; i++)
-			{
-				out[mapIntelLegacy64Qam[i]] = in[i];
-			}
+			procSymPermute<uint8_t, 288, mapIntelLegacy64Qam>(in, out);
 			return;
 		}
 		default:
@@ -2241,42 +2150,27 @@ void procSymDeintNL2SS1(float* in, float* out, c8p_mod* mod)
 	{
 		case 52:
 		{
-			for(int i=0; i<52; i++)
-			{
-				out[mapDeintNonlegacyBpsk[i]] = in[i];
-			}
+			procSymPermute<float, 52, mapDeintNonlegacyBpsk>(in, out);
 			return;
 		}
 		case 104:
 		{
-			for(int i=0; i<104; i++)
-			{
-				out[mapDeintNonlegacyQpsk[i]] = in[i];
-			}
+			procSymPermute<float, 104, mapDeintNonlegacyQpsk>(in, out);
 			return;
 		}
 		case 208:
 		{
-			for(int i=0; i<208; i++)
-			{
-				out[mapDeintNonlegacy16Qam[i]] = in[i];
-			}
+			procSymPermute<float, 208, mapDeintNonlegacy16Qam>(in, out);
 			return;
 		}
 		case 312:
 		{
-			for(int i=0; i<312; i++)
-			{
-				out[mapDeintNonlegacy64Qam[i]] = in[i];
-			}
+			procSymPermute<float, 312, mapDeintNonlegacy64Qam>(in, out);
 			return;
 		}
 		case 416:
 		{
-			for(int i=0; i<416; i++)
-			{
-				out[mapDeintNonlegacy256Qam[i]] = in[i];
-			}
+			procSymPermute<float, 416, mapDeintNonlegacy256Qam>(in, out);
 			return;
 		}
 		default:
@@ -2292,42 +2186,27 @@ void procSymDeintNL2SS2(float* in, float* out, c8p_mod* mod)
 	{
 		case 52:
 		{
-			for(int i=0; i<52; i++)
-			{
-				out[mapDeintNonlegacyBpsk2[i]] = in[i];
-			}
+			procSymPermute<float, 52, mapDeintNonlegacyBpsk2>(in, out);
 			return;
 		}
 		case 104:
 		{
-			for(int i=0; i<104; i++)
-			{
-				out[mapDeintNonlegacyQpsk2[i]] = in[i];
-			}
+			procSymPermute<float, 104, mapDeintNonlegacyQpsk2>(in, out);
 			return;
 		}
 		case 208:
 		{
-			for(int i=0; i<208; i++)
-			{
-				out[mapDeintNonlegacy16Qam2[i]] = in[i];
-			}
+			procSymPermute<float, 208, mapDeintNonlegacy16Qam2>(in, out);
 			return;
 		}
 		case 312:
 		{
-			for(int i=0; i<312; i++)
-			{
-				out[mapDeintNonlegacy64Qam2[i]] = in[i];
-			}
+			procSymPermute<float, 312, mapDeintNonlegacy64Qam2>(in, out);
 			return;
 		}
 		case 416:
 		{
-			for(int i=0; i<416; i++)
-			{
-				out[mapDeintNonlegacy256Qam2[i]] = in[i];
-			}
+			procSymPermute<float, 416, mapDeintNonlegacy256Qam2>(in, out);
 			return;
 		}
 		default:
@@ -2343,42 +2222,27 @@ void procSymIntelNL2SS1(uint8_t* in, uint8_t* out, c8p_mod* mod)
 	{
 		case 52:
 		{
-			for(int i=0; i<52; i++)
-			{
-				out[mapIntelNonlegacyBpsk[i]] = in[i];
-			}
+			procSymPermute<uint8_t, 52, mapIntelNonlegacyBpsk>(in, out);
 			return;
 		}
 		case 104:
 		{
-			for(int i=0; i<104; i++)
-			{
-				out[mapIntelNonlegacyQpsk[i]] = in[i];
-			}
+			procSymPermute<uint8_t, 104, mapIntelNonlegacyQpsk>(in, out);
 			return;
 		}
 		case 208:
 		{
-			for(int i=0; i<208; i++)
-			{
-				out[mapIntelNonlegacy16Qam[i]] = in[i];
-			}
+			procSymPermute<uint8_t, 208, mapIntelNonlegacy16Qam>(in, out);
 			return;
 		}
 		case 312:
 		{
-			for(int i=0; i<312; i++)
-			{
-				out[mapIntelNonlegacy64Qam[i]] = in[i];
-			}
+			procSymPermute<uint8_t, 312, mapIntelNonlegacy64Qam>(in, out);
 			return;
 		}
 		case 416:
 		{
-			for(int i=0; i<416; i++)
-			{
-				out[mapIntelNonlegacy256Qam[i]] = in[i];
-			}
+			procSymPermute<uint8_t, 416, mapIntelNonlegacy256Qam>(in, out);
 			return;
 		}
 		default:
@@ -2394,42 +2258,27 @@ void procSymIntelNL2SS2(uint8_t* in, uint8_t* out, c8p_mod* mod)
 	{
 		case 52:
 		{
-			for(int i=0; i<52; i++)
-			{
-				out[mapIntelNonlegacyBpsk2[i]] = in[i];
-			}
+			procSymPermute<uint8_t, 52, mapIntelNonlegacyBpsk2>(in, out);
 			return;
 		}
 		case 104:
 		{
-			for(int i=0; i<104; i++)
-			{
-				out[mapIntelNonlegacyQpsk2[i]] = in[i];
-			}
+			procSymPermute<uint8_t, 104, mapIntelNonlegacyQpsk2>(in, out);
 			return;
 		}
 		case 208:
 		{
-			for(int i=0; i<208; i++)
-			{
-				out[mapIntelNonlegacy16Qam2[i]] = in[i];
-			}
+			procSymPermute<uint8_t, 208, mapIntelNonlegacy16Qam2>(in, out);
 			return;
 		}
 		case 312:
 		{
-			for(int i=0; i<312; i++)
-			{
-				out[mapIntelNonlegacy64Qam2[i]] = in[i];
-			}
+			procSymPermute<uint8_t, 312, mapIntelNonlegacy64Qam2>(in, out);
 			return;
 		}
 		case 416:
 		{
-			for(int i=0; i<416; i++)
-			{
-				out[mapIntelNonlegacy256Qam2[i]] = in[i];
-			}
+			procSymPermute<uint8_t, 416, mapIntelNonlegacy256Qam2>(in, out);
 			return;
 		}
 		default:
@@ -2450,6 +2299,86 @@ void procSymDepasNL(float in[C8P_MAX_N_SS][C8P_MAX_N_CBPSS], float* out, c8p_mod
 	}
 }
 
+/*
+ * Gather tables of the deinterleaver and, with 2 ss, the stream deparser in
+ * one, by legacy, nss 1 and nss 2 and the bits per subcarrier. They are made
+ * by passing the llr positions through the per stage functions above, the
+ * input position of stream s is s * C8P_MAX_N_CBPSS plus its llr index.
+ */
+struct c8pDeintTabs
+{
+	int tab[3][5][C8P_MAX_N_SS * C8P_MAX_N_CBPSS];
+
+	c8pDeintTabs()
+	{
+		const int tmpBits[5] = {1, 2, 4, 6, 8};
+		static float tmpIdx[C8P_MAX_N_SS][C8P_MAX_N_CBPSS];
+		static float tmpDeint[C8P_MAX_N_SS][C8P_MAX_N_CBPSS];
+		static float tmpOut[C8P_MAX_N_SS * C8P_MAX_N_CBPSS];
+		for(int s=0;s<C8P_MAX_N_SS;s++)
+		{
+			for(int i=0;i<C8P_MAX_N_CBPSS;i++)
+			{
+				tmpIdx[s][i] = (float)(s * C8P_MAX_N_CBPSS + i);
+			}
+		}
+		for(int t=0;t<3;t++)
+		{
+			for(int b=0;b<5;b++)
+			{
+				c8p_mod tmpMod;
+				tmpMod.nBPSCS = tmpBits[b];
+				tmpMod.nSS = (t == 2) ? 2 : 1;
+				tmpMod.nCBPSS = tmpBits[b] * ((t == 0) ? 48 : 52);
+				tmpMod.nCBPS = tmpMod.nCBPSS * tmpMod.nSS;
+				memset(tmpOut, 0, sizeof(tmpOut));
+				if(t == 0)
+				{
+					procSymDeintL2(tmpIdx[0], tmpOut, &tmpMod);
+				}
+				else if(t == 1)
+				{
+					procSymDeintNL2SS1(tmpIdx[0], tmpOut, &tmpMod);
+				}
+				else
+				{
+					procSymDeintNL2SS1(tmpIdx[0], tmpDeint[0], &tmpMod);
+					procSymDeintNL2SS2(tmpIdx[1], tmpDeint[1], &tmpMod);
+					procSymDepasNL(tmpDeint, tmpOut, &tmpMod);
+				}
+				for(int i=0;i<C8P_MAX_N_SS * C8P_MAX_N_CBPSS;i++)
+				{
+					tab[t][b][i] = (int)tmpOut[i];
+				}
+			}
+		}
+	}
+};
+
+const int* procSymDeintGather(const c8p_mod* mod)
+{
+	static const c8pDeintTabs tabs;
+	int t = (mod->format == C8P_F_L) ? 0 : ((mod->nSS == 1) ? 1 : 2);
+	int b = 0;
+	switch(mod->nBPSCS)
+	{
+		case 2: b = 1; break;
+		case 4: b = 2; break;
+		case 6: b = 3; break;
+		case 8: b = 4; break;
+		default: break;
+	}
+	return tabs.tab[t][b];
+}
+
+void procSymDeintFused(const float* in, float* out, const int* gat, int n)
+{
+	for(int i=0;i<n;i++)
+	{
+		out[i] = in[gat[i]];
+	}
+}
+
 int nCodedToUncoded(int nCoded, c8p_mod* mod)
 {
 	switch(mod->cr)
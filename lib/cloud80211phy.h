@@ -21,6 +21,8 @@
 #ifndef INCLUDED_CLOUD80211PHY_H
 #define INCLUDED_CLOUD80211PHY_H
 
+#include <array>
+#include <cstdint>
 #include <cstring>
 #include <iostream>
 #include <gnuradio/io_signature.h>
@@ -55,6 +57,13 @@
 #define C8P_QAM_64QAM 4
 #define C8P_QAM_256QAM 5
 
+#define C8P_QBPSK_RATIO 2.0f	// axis energy ratio to call a sig symbol bpsk or qbpsk
+#define C8P_QBPSK_RATIO_L 4.0f	// stricter one to skip the sig decoding as legacy
+
+#define C8P_LLR_FLOAT 0
+#define C8P_LLR_I16 1
+#define C8P_LLR_I8 2
+
 class c8p_mod
 {
     public:
@@ -131,18 +140,38 @@ class c8p_sigVhtA
         int ldpcExtra;
 };
 
+/*
+ * 2x2 equalizer of one packet, s = W y on each subcarrier with
+ * W = (H^H H + noise I)^-1 H^H, noise 0 is zero forcing. The elements w00,
+ * w01, w10 and w11 are kept as planes of real and imaginary parts, each
+ * value twice to line up with the interleaved complex samples. snr is the
+ * post equalization snr of each stream relative to the input snr, unused
+ * subcarriers have zero matrices and weights.
+ */
+class c8p_eq2
+{
+	public:
+	float wRe[4][128];
+	float wIm[4][128];
+	float snr[2][64];
+};
+
+/*
+ * Soft Viterbi of the SIG fields, L-SIG has 24 steps, VHT-SIG-B 26 and
+ * HT-SIG or VHT-SIG-A 48. The lengths are fixed so each one has its own
+ * decoder with the traceback unrolled, the ACS runs on the simd kernels of
+ * the data decoder and keeps one 64 bit survivor word per step.
+ */
+#define SV_SIG_T_MAX 48
+
 class svSigDecoder
 {
 	private:
-	int i, j, t;
-	float accum_err_metric0[64];
-	float accum_err_metric1[64];
-	float *tmp, *pre_accum_err_metric, *cur_accum_err_metric;
-	int state_history[64][49];		/* state history table */
-	int state_sequence[49];			/* state sequence list */
-	int op0, op1, next0, next1;
-	float acc_tmp0, acc_tmp1, t0, t1;
-	float tbl_t[4];
+	float pm[64];
+	uint64_t his[SV_SIG_T_MAX + 1];
+
+	template<int L>
+	void decodeFixed(const float* llrv, uint8_t* decoded_bits);
 
 	public:
 	void decode(float* llrv, uint8_t* decoded_bits, int trellisLen);
@@ -161,15 +190,55 @@ extern const float LTF_NL_28_F_FLOAT[64];
 extern const float LTF_NL_28_F_FLOAT_VHT22[64];
 extern const float LTF_NL_28_F_FLOAT2[64];
 
-extern const int mapDeintLegacyBpsk[48];
-extern const int mapDeintLegacyQpsk[96];
-extern const int mapDeintLegacy16Qam[192];
-extern const int mapDeintLegacy64Qam[288];
-extern const int mapDeintNonlegacyBpsk[52];
-extern const int mapDeintNonlegacyQpsk[104];
-extern const int mapDeintNonlegacy16Qam[208];
-extern const int mapDeintNonlegacy64Qam[312];
-extern const int mapDeintNonlegacy256Qam[416];
+#define C8P_INTEL_NCOL_L 16
+#define C8P_INTEL_NCOL_NL20 13
+#define C8P_INTEL_NROT_NL20 11
+
+/*
+ * Interleaver of one spatial stream with N coded bits, from 802.11 19.3.11.8.
+ * Bit k goes to position map[k], the first permutation spreads the bits over
+ * nCol columns, the second alternates the significance in a constellation
+ * and stream iss > 1 is rotated by nRot subcarriers. Legacy is nCol 16 with
+ * no rotation. The deinterleaver map is the inverse, bit map[j] is received
+ * at position j.
+ */
+template<int N>
+constexpr std::array<int, N> c8pIntelMap(int nCol, int nBPSCS, int iss, int nRot)
+{
+	std::array<int, N> m{};
+	int s = (nBPSCS / 2 > 1) ? (nBPSCS / 2) : 1;
+	int nRow = N / nCol;
+	int rot = (((iss - 1) * 2) % 3 + 3 * ((iss - 1) / 3)) * nRot * nBPSCS;
+	for(int k=0;k<N;k++)
+	{
+		int i = nRow * (k % nCol) + k / nCol;
+		int j = s * (i / s) + (i + N - (nCol * i) / N) % s;
+		m[k] = ((j - rot) % N + N) % N;
+	}
+	return m;
+}
+
+template<int N>
+constexpr std::array<int, N> c8pDeintMap(int nCol, int nBPSCS, int iss, int nRot)
+{
+	std::array<int, N> f = c8pIntelMap<N>(nCol, nBPSCS, iss, nRot);
+	std::array<int, N> m{};
+	for(int k=0;k<N;k++)
+	{
+		m[f[k]] = k;
+	}
+	return m;
+}
+
+extern const std::array<int, 48> mapDeintLegacyBpsk;
+extern const std::array<int, 96> mapDeintLegacyQpsk;
+extern const std::array<int, 192> mapDeintLegacy16Qam;
+extern const std::array<int, 288> mapDeintLegacy64Qam;
+extern const std::array<int, 52> mapDeintNonlegacyBpsk;
+extern const std::array<int, 104> mapDeintNonlegacyQpsk;
+extern const std::array<int, 208> mapDeintNonlegacy16Qam;
+extern const std::array<int, 312> mapDeintNonlegacy64Qam;
+extern const std::array<int, 416> mapDeintNonlegacy256Qam;
 
 extern const int SV_PUNC_12[2];
 extern const int SV_PUNC_23[4];
@@ -185,7 +254,8 @@ extern const float PILOT_HT_2_1[4];
 extern const float PILOT_HT_2_2[4];
 extern const float PILOT_VHT[4];
 extern const uint8_t EOF_PAD_SUBFRAME[32];
-extern const int mapDeintVhtSigB20[52];
+extern const uint8_t C8P_SCRAMBLE_SEQ[128][127];
+extern const std::array<int, 52> mapDeintVhtSigB20;
 
 
 extern const gr_complex C8P_STF_F[64];
@@ -199,7 +269,8 @@ void procDeintLegacyBpsk(float* inBits, float* outBits);
 void procIntelLegacyBpsk(uint8_t* inBits, uint8_t* outBits);
 void procIntelVhtB20(uint8_t* inBits, uint8_t* outBits);
 void SV_Decode_Sig(float* llrv, uint8_t* decoded_bits, int trellisLen);
-void procSymQamToLlr(gr_complex* inQam, float* outLlr, c8p_mod* mod);
+void procCsiWeights(const float* scW, float* qamW, int format);
+void procSymQamToLlr(const gr_complex* inQam, float* outLlr, c8p_mod* mod, const float* csi = nullptr);
 void procSymDeintL2(float* in, float* out, c8p_mod* mod);
 void procSymIntelL2(uint8_t* in, uint8_t* out, c8p_mod* mod);
 void procSymDeintNL2SS1(float* in, float* out, c8p_mod* mod);
@@ -207,6 +278,18 @@ void procSymDeintNL2SS2(float* in, float* out, c8p_mod* mod);
 void procSymIntelNL2SS1(uint8_t* in, uint8_t* out, c8p_mod* mod);
 void procSymIntelNL2SS2(uint8_t* in, uint8_t* out, c8p_mod* mod);
 void procSymDepasNL(float in[C8P_MAX_N_SS][C8P_MAX_N_CBPSS], float* out, c8p_mod* mod);
+/*
+ * Deinterleave and, with 2 ss, deparse one symbol in a single gather,
+ * out[i] = in[gat[i]] for the nCBPS llr. The table only depends on the
+ * format, nss and bits per subcarrier, so it is looked up once per packet.
+ */
+const int* procSymDeintGather(const c8p_mod* mod);
+void procSymDeintFused(const float* in, float* out, const int* gat, int n);
+void procEq2Prep(const gr_complex h[64][4], float noise, c8p_eq2* eq);
+void procEq2Apply(const c8p_eq2* eq, const gr_complex* y1, const gr_complex* y2, gr_complex* s1, gr_complex* s2);
+int llrItemSize(int llrType);
+float llrQuantScale(float snr, c8p_mod* mod, int llrType);
+void procLlrQuant(const float* in, void* out, int len, float scale, int llrType);
 int nCodedToUncoded(int nCoded, c8p_mod* mod);
 int nUncodedToCoded(int nUncoded, c8p_mod* mod);
 void procCSD(gr_complex* sig, int cycShift);
@@ -219,7 +302,14 @@ void procInsertPilots(gr_complex* sigIn, gr_complex* pilots);
 void procNonDataSc(gr_complex* sigIn, gr_complex* sigOut, int format);
 
 void procLHSigDemodDeint(gr_complex *sym1, gr_complex *sym2, gr_complex *sig, std::vector<gr_complex> &h, float *llr);
-void procNLSigDemodDeint(gr_complex *sym1, gr_complex *sym2, std::vector<gr_complex> h, float *llrht, float *llrvht);
+/*
+ * Demaps the two symbols after L-SIG as HT-SIG and as VHT-SIG-A. Also guesses
+ * the format from which axis holds the energy of each symbol, returns
+ * C8P_F_HT or C8P_F_VHT when one axis is C8P_QBPSK_RATIO times stronger
+ * than the other, C8P_F_L only when both symbols clear C8P_QBPSK_RATIO_L as
+ * there is no crc to fall back on, -1 otherwise.
+ */
+int procNLSigDemodDeint(gr_complex *sym1, gr_complex *sym2, std::vector<gr_complex> &h, float *llrht, float *llrvht);
 bool signalCheckLegacy(uint8_t* inBits, int* mcs, int* len, int* nDBPS);
 bool signalCheckHt(uint8_t* inBits);
 bool signalCheckVhtA(uint8_t* inBits);
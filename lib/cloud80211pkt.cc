@@ -0,0 +1,205 @@
+/*
+ *
+ *     GNU Radio IEEE 802.11a/g/n/ac 20M bw and upto 2x2
+ *     Packet descriptors passed down the rx chain
+ *     Copyright (C) June 1, 2022  Zelin Yun
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU Affero General Public License as published
+ *     by the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU Affero General Public License for more details.
+ *
+ *     You should have received a copy of the GNU Affero General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "cloud80211pkt.h"
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+
+void c8p_pkt::reset()
+{
+	seq = -1;
+	format = 0;
+	mcs = 0;
+	len = 0;
+	cr = 0;
+	ampdu = 0;
+	trellis = 0;
+	total = 0;
+	nSamp = 0;
+	rad = 0.0f;
+	cfo = 0.0f;
+	snr = 0.0f;
+	rssi = 0.0f;
+	sssnr0 = 0.0f;
+	sssnr1 = 0.0f;
+	nChan = 0;
+}
+
+static_assert(sizeof(c8p_pkt) % sizeof(uint32_t) == 0 && std::is_trivially_copyable<c8p_pkt>::value, "c8p_pkt is copied as words");
+
+c8pPktRing::c8pPktRing()
+{
+	for(int i=0;i<C8P_PKT_RING;i++)
+	{
+		ring[i].offset.store(UINT64_MAX);
+		for(size_t j=0;j<C8P_PKT_WORDS;j++)
+		{
+			ring[i].word[j].store(0);
+		}
+		val[i] = pmt::from_uint64((uint64_t)(uintptr_t)&ring[i]);
+	}
+	p = 0;
+	pkt.reset();
+}
+
+c8p_pkt* c8pPktRing::next()
+{
+	pkt.reset();
+	return &pkt;
+}
+
+const pmt::pmt_t& c8pPktRing::publish(uint64_t offset)
+{
+	// the old tag of the slot is no longer valid before the slot is rewritten
+	c8pPktSlot* tmpSlot = &ring[p];
+	tmpSlot->offset.store(offset, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	uint32_t tmpWord[C8P_PKT_WORDS];
+	memcpy(tmpWord, &pkt, sizeof(c8p_pkt));
+	for(size_t j=0;j<C8P_PKT_WORDS;j++)
+	{
+		tmpSlot->word[j].store(tmpWord[j], std::memory_order_relaxed);
+	}
+	const pmt::pmt_t& tmpVal = val[p];
+	p = (p + 1) % C8P_PKT_RING;
+	return tmpVal;
+}
+
+c8pBlobPool::c8pBlobPool()
+{
+	nBlob = 0;
+	nGet = 0;
+	nHit = 0;
+}
+
+static inline bool c8pBlobFree(const pmt::pmt_t& blob)
+{
+	// use_count is a relaxed load, the fence orders it before the rewrite of
+	// the blob, after the release of the last reference by the receiver
+	if(blob.use_count() == 1)
+	{
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return true;
+	}
+	return false;
+}
+
+bool c8pBlobPool::evict()
+{
+	// pool is full, forget a free blob of the length used least recently
+	auto tmpOld = bucket.end();
+	int tmpFree = -1;
+	for(auto it = bucket.begin(); it != bucket.end(); ++it)
+	{
+		if(tmpOld != bucket.end() && it->second.used >= tmpOld->second.used)
+		{
+			continue;
+		}
+		for(int i=0;i<(int)it->second.blobs.size();i++)
+		{
+			if(c8pBlobFree(it->second.blobs[i]))
+			{
+				tmpOld = it;
+				tmpFree = i;
+				break;
+			}
+		}
+	}
+	if(tmpOld == bucket.end())
+	{
+		return false;
+	}
+	std::vector<pmt::pmt_t>& tmpBlobs = tmpOld->second.blobs;
+	tmpBlobs[tmpFree] = tmpBlobs.back();
+	tmpBlobs.pop_back();
+	if(tmpBlobs.empty())
+	{
+		bucket.erase(tmpOld);
+	}
+	nBlob--;
+	return true;
+}
+
+uint8_t* c8pBlobPool::get(int len, pmt::pmt_t& blob)
+{
+	size_t tmpLen;
+	nGet++;
+	c8pBlobBucket& tmpBucket = bucket[len];
+	tmpBucket.used = nGet;
+	for(const pmt::pmt_t& tmpBlob : tmpBucket.blobs)
+	{
+		if(c8pBlobFree(tmpBlob))
+		{
+			nHit++;
+			blob = tmpBlob;
+			return pmt::u8vector_writable_elements(blob, tmpLen);
+		}
+	}
+	blob = pmt::make_u8vector(len, 0);
+	if(nBlob < C8P_BLOB_POOL || evict())
+	{
+		tmpBucket.blobs.push_back(blob);
+		nBlob++;
+	}
+	else if(tmpBucket.blobs.empty())
+	{
+		bucket.erase(len);
+	}
+	return pmt::u8vector_writable_elements(blob, tmpLen);
+}
+
+const pmt::pmt_t& c8pPktKey()
+{
+	static const pmt::pmt_t key = pmt::mp("pkt");
+	return key;
+}
+
+const c8p_pkt* c8pPktFind(const std::vector<gr::tag_t>& tags, c8p_pkt* copy, bool debug)
+{
+	for(const gr::tag_t& tag : tags)
+	{
+		if(pmt::eq(tag.key, c8pPktKey()))
+		{
+			c8pPktSlot* tmpSlot = (c8pPktSlot*)(uintptr_t)pmt::to_uint64(tag.value);
+			if(tmpSlot->offset.load(std::memory_order_acquire) == tag.offset)
+			{
+				// a word written by a producer reusing the slot makes the offset check below fail
+				uint32_t tmpWord[C8P_PKT_WORDS];
+				for(size_t j=0;j<C8P_PKT_WORDS;j++)
+				{
+					tmpWord[j] = tmpSlot->word[j].load(std::memory_order_relaxed);
+				}
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if(tmpSlot->offset.load(std::memory_order_relaxed) == tag.offset)
+				{
+					memcpy(copy, tmpWord, sizeof(c8p_pkt));
+					return copy;
+				}
+			}
+			if(debug)
+			{
+				std::cout<<"ieee80211, packet descriptor of item "<<tag.offset<<" was reused, more than "<<C8P_PKT_RING<<" packets behind."<<std::endl;
+			}
+			return nullptr;
+		}
+	}
+	return nullptr;
+}
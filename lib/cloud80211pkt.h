@@ -0,0 +1,133 @@
+/*
+ *
+ *     GNU Radio IEEE 802.11a/g/n/ac 20M bw and upto 2x2
+ *     Packet descriptors passed down the rx chain
+ *     Copyright (C) June 1, 2022  Zelin Yun
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU Affero General Public License as published
+ *     by the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU Affero General Public License for more details.
+ *
+ *     You should have received a copy of the GNU Affero General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_CLOUD80211PKT_H
+#define INCLUDED_CLOUD80211PKT_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include <gnuradio/tags.h>
+#include <gnuradio/gr_complex.h>
+#include <pmt/pmt.h>
+
+#define C8P_PKT_RING 256		// packets a consumer can lag behind its producer
+#define C8P_PKT_CHAN_MAX 128
+#define C8P_BLOB_POOL 64		// published blobs kept for reuse
+
+/*
+ * Metadata of one packet, filled by sync, signal and demod for the next
+ * block. Fields a stage does not know keep the reset values, seq -1 and
+ * zero for the rest.
+ */
+class c8p_pkt
+{
+	public:
+	int seq;
+	int format;
+	int mcs;
+	int len;
+	int cr;
+	int ampdu;
+	int trellis;
+	int total;		/* llr of the data field */
+	int nSamp;		/* samples of the data field after the legacy signal */
+	float rad;		/* cfo in rad per sample */
+	float cfo;		/* cfo in Hz */
+	float snr;
+	float rssi;
+	float sssnr0;
+	float sssnr1;
+	int nChan;
+	gr_complex chan[C8P_PKT_CHAN_MAX];	/* legacy channel, or the vht NDP 2x1 report */
+
+	void reset();
+};
+
+/*
+ * A producer owns a ring of descriptors and tags the first item of a
+ * packet with the key "pkt" and the value of the slot. The values are
+ * made once with the slot address, so a packet costs no pmt at all.
+ * The producer fills the packet given by next and publish copies it into
+ * the next slot with the offset of the item it is tagged on, a slot is
+ * reused after C8P_PKT_RING more packets of the same producer. The slot
+ * is a seqlock, the descriptor is copied in and out as atomic words and
+ * consumers only take the copy when the offset of the slot is still the
+ * one of the tag, before and after the copy, so a consumer that fell that
+ * far behind finds no descriptor instead of the one of a later packet.
+ */
+#define C8P_PKT_WORDS (sizeof(c8p_pkt) / sizeof(uint32_t))
+
+struct c8pPktSlot
+{
+	std::atomic<uint64_t> offset;
+	std::atomic<uint32_t> word[C8P_PKT_WORDS];
+};
+
+class c8pPktRing
+{
+	private:
+	c8pPktSlot ring[C8P_PKT_RING];
+	pmt::pmt_t val[C8P_PKT_RING];
+	int p;
+	c8p_pkt pkt;
+
+	public:
+	c8pPktRing();
+	c8p_pkt* next();
+	const pmt::pmt_t& publish(uint64_t offset);
+};
+
+struct c8pBlobBucket
+{
+	std::vector<pmt::pmt_t> blobs;
+	uint64_t used;		/* nGet when the length was last asked for */
+};
+
+/*
+ * Payload blobs of published messages. The message is the whole blob, so
+ * a blob is only reused for the same length and the pool keeps them by
+ * length. A pooled blob is free again once the pool holds its only
+ * reference, so a receiver that keeps the message never sees it
+ * overwritten. When the pool is full a free blob of the length asked for
+ * least recently makes room. nGet and nHit count the blobs given and the
+ * reused ones.
+ */
+class c8pBlobPool
+{
+	private:
+	std::unordered_map<int, c8pBlobBucket> bucket;
+	int nBlob;
+
+	bool evict();
+
+	public:
+	uint64_t nGet;
+	uint64_t nHit;
+
+	c8pBlobPool();
+	uint8_t* get(int len, pmt::pmt_t& blob);
+};
+
+const pmt::pmt_t& c8pPktKey();
+const c8p_pkt* c8pPktFind(const std::vector<gr::tag_t>& tags, c8p_pkt* copy, bool debug = false);
+
+#endif /* INCLUDED_CLOUD80211PKT_H */
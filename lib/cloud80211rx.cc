@@ -0,0 +1,1035 @@
+/*
+ *
+ *     GNU Radio IEEE 802.11a/g/n/ac 20M bw and upto 2x2
+ *     Per packet receiver stages, shared by the blocks and the workers
+ *     Copyright (C) June 1, 2022  Zelin Yun
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU Affero General Public License as published
+ *     by the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU Affero General Public License for more details.
+ *
+ *     You should have received a copy of the GNU Affero General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "cloud80211rx.h"
+#include <gnuradio/ieee80211/utils.h>
+#include <volk/volk.h>
+
+c8pRxSig::c8pRxSig()
+	: fft1(64, 1), fft2(64, 1), ffts(64, 1)
+{
+	h = std::vector<gr_complex>(64, gr_complex(0.0f, 0.0f));
+}
+
+bool c8pRxSig::run(const gr_complex* sig, float rad)
+{
+	// phasor recurrence from the start of each fft window, the gi of the sig skipped
+	gr_complex tmpPhase = std::polar(1.0f, (float)C8P_SYM_SAMP_SHIFT * rad);
+	gr_complex tmpStep = std::polar(1.0f, rad);
+	volk_32fc_s32fc_x2_rotator_32fc(fft1.get_inbuf(), &sig[C8P_SYM_SAMP_SHIFT], tmpStep, &tmpPhase, 64);
+	volk_32fc_s32fc_x2_rotator_32fc(fft2.get_inbuf(), &sig[C8P_SYM_SAMP_SHIFT+64], tmpStep, &tmpPhase, 64);
+	tmpPhase *= std::polar(1.0f, 16.0f * rad);
+	volk_32fc_s32fc_x2_rotator_32fc(ffts.get_inbuf(), &sig[C8P_SYM_SAMP_SHIFT+144], tmpStep, &tmpPhase, 64);
+	fft1.execute();
+	fft2.execute();
+	ffts.execute();
+	procLHSigDemodDeint(fft1.get_outbuf(), fft2.get_outbuf(), ffts.get_outbuf(), h, llr);
+	decoder.decode(llr, bits, 24);
+	if(signalCheckLegacy(bits, &mcs, &len, &nDBPS))
+	{
+		nSym = (len*8 + 22 + nDBPS - 1)/nDBPS;
+		nSamp = nSym * 80;
+		return true;
+	}
+	return false;
+}
+
+c8pRxDemod::c8pRxDemod(int llrType, int muPos)
+	: llrType(llrType), muPos(muPos), fft(64, 1)
+{
+	HL = std::vector<gr_complex>(64, gr_complex(0.0f, 0.0f));
+}
+
+void c8pRxDemod::init(int mcs, int len, const gr_complex* chan)
+{
+	sigLMcs = mcs;
+	sigLLen = len;
+	std::copy(chan, chan + 64, HL.begin());
+}
+
+int c8pRxDemod::format(const gr_complex* sig)
+{
+	fftDemod(&sig[C8P_SYM_SAMP_SHIFT], fftLtfOut1);
+	fftDemod(&sig[C8P_SYM_SAMP_SHIFT+80], fftLtfOut2);
+	int tmpFormat = procNLSigDemodDeint(fftLtfOut1, fftLtfOut2, HL, sigHtCodedLlr, sigVhtACodedLlr);
+	// decode the likely format first, the other one only when its crc fails
+	bool tmpVht = false, tmpHt = false;
+	if(tmpFormat != C8P_F_L)
+	{
+		if(tmpFormat != C8P_F_HT)
+		{
+			decoder.decode(sigVhtACodedLlr, sigVhtABits, 48);
+			tmpVht = signalCheckVhtA(sigVhtABits);
+		}
+		if(!tmpVht)
+		{
+			decoder.decode(sigHtCodedLlr, sigHtBits, 48);
+			tmpHt = signalCheckHt(sigHtBits);
+		}
+		if(!tmpVht && !tmpHt && tmpFormat == C8P_F_HT)
+		{
+			decoder.decode(sigVhtACodedLlr, sigVhtABits, 48);
+			tmpVht = signalCheckVhtA(sigVhtABits);
+		}
+	}
+	if(tmpVht)
+	{
+		signalParserVhtA(sigVhtABits, &m, &sigVhtA);
+		return C8P_F_VHT;
+	}
+	else if(tmpHt)
+	{
+		signalParserHt(sigHtBits, &m, &sigHt);
+		return C8P_F_HT;
+	}
+	return C8P_F_L;
+}
+
+int c8pRxDemod::nonLegacySamp()
+{
+	// STF, LTF and vht sig b
+	return 80 + m.nLTF*80 + ((m.format == C8P_F_VHT) ? 80 : 0);
+}
+
+bool c8pRxDemod::nonLegacy(const gr_complex* in1, const gr_complex* in2)
+{
+	int tmpNLegacySym = (sigLLen*8 + 22 + 23)/24;
+	// one antenna only demodulates one stream
+	bool tmpAnt = (in2 != nullptr) || (m.nSS == 1);
+	nonLegacyChanEstimate(&in1[80], in2 ? &in2[80] : nullptr);
+	if(m.format == C8P_F_VHT)
+	{
+		vhtSigBDemod(&in1[80 + m.nLTF*80], in2 ? &in2[80 + m.nLTF*80] : nullptr);
+		signalParserVhtB(sigVhtB20Bits, &m);
+		// or takes the NDP of a 2x2 sounding, no data and the ltfs in ndpChan
+		bool tmpLen = (m.len > 0 && tmpAnt) || (m.len == 0 && !in2 && m.nSS == 2);
+		if(tmpLen && m.len <= 4095 && m.nSS <= 2 && (tmpNLegacySym * 80) >= (m.nSym * m.nSymSamp + 160 + 80 + m.nLTF * 80 + 80))
+		{
+			nTrellis = m.nSym * m.nDBPS;
+			memcpy(pilot, PILOT_VHT, sizeof(float)*4);
+			pilotP = 4;
+			return true;
+		}
+		return false;
+	}
+	if(m.len > 0 && m.len <= 4095 && m.nSS <= 2 && tmpAnt && (tmpNLegacySym * 80) >= (m.nSym * m.nSymSamp + 160 + 80 + m.nLTF * 80))
+	{
+		nTrellis = m.len * 8 + 22;
+		if(m.nSS == 1)
+		{
+			memcpy(pilot, PILOT_HT_1, sizeof(float)*4);
+		}
+		else
+		{
+			memcpy(pilot, PILOT_HT_2_1, sizeof(float)*4);
+		}
+		memcpy(pilot2, PILOT_HT_2_2, sizeof(float)*4);
+		pilotP = 3;
+		return true;
+	}
+	return false;
+}
+
+void c8pRxDemod::legacy()
+{
+	signalParserL(sigLMcs, sigLLen, &m);
+	nTrellis = m.len*8 + 22;
+	memcpy(pilot, PILOT_L, sizeof(float)*4);
+	pilotP = 1;
+}
+
+void c8pRxDemod::prep(float snr)
+{
+	llrScale = llrQuantScale(snr, &m, llrType);
+	// llr weights from the channel power of each subcarrier, or the snr of each stream after the 2x2 equalizer
+	float tmpScW[2][64];
+	for(int i=0;i<64;i++)
+	{
+		if(m.format == C8P_F_L)
+		{
+			tmpScW[0][i] = std::norm(HL[i]);
+		}
+		else if(m.nSS == 1)
+		{
+			tmpScW[0][i] = std::norm(H_NL[i][0]);
+		}
+		else
+		{
+			tmpScW[0][i] = eq2.snr[0][i];
+			tmpScW[1][i] = eq2.snr[1][i];
+		}
+	}
+	procCsiWeights(tmpScW[0], csi[0], m.format);
+	if(m.format != C8P_F_L && m.nSS > 1)
+	{
+		procCsiWeights(tmpScW[1], csi[1], m.format);
+	}
+	deintGat = procSymDeintGather(&m);
+	nSymProcd = 0;
+}
+
+void c8pRxDemod::demod(const gr_complex* in1, const gr_complex* in2, int nSym, void* llr)
+{
+	float* outLlrs = (float*)llr;
+	uint8_t* outQuant = (uint8_t*)llr;
+	int o1 = 0;
+	int o2 = 0;
+	const gr_complex* tmpBins1 = nullptr;
+	const gr_complex* tmpBins2 = nullptr;
+	for(int i=0;i<nSym;i++)
+	{
+		int tmpB = (i % C8P_FFT_BATCH) * 64;
+		if(tmpB == 0)
+		{
+			// ffts of the symbols up to the next batch in one call, straight from the input
+			int tmpNBatch = std::min(C8P_FFT_BATCH, nSym - i);
+			tmpBins1 = fftBatch1.run(&in1[o1 + C8P_SYM_SAMP_SHIFT], m.nSymSamp, tmpNBatch);
+			tmpBins2 = tmpBins1;	// not read with one stream
+			if(m.format != C8P_F_L && m.nSS > 1)
+			{
+				tmpBins2 = fftBatch2.run(&in2[o1 + C8P_SYM_SAMP_SHIFT], m.nSymSamp, tmpNBatch);
+			}
+		}
+		float* tmpLlr = (llrType == C8P_LLR_FLOAT) ? &outLlrs[o2] : llrDeint;
+		if(m.format == C8P_F_L)
+		{
+			legacyChanUpdate(&tmpBins1[tmpB]);
+			procSymQamToLlr(qam[0], llrInted[0], &m, csi[0]);
+		}
+		else
+		{
+			if(m.format == C8P_F_VHT)
+			{
+				vhtChanUpdate(&tmpBins1[tmpB], &tmpBins2[tmpB]);
+			}
+			else
+			{
+				htChanUpdate(&tmpBins1[tmpB], &tmpBins2[tmpB]);
+			}
+			procSymQamToLlr(qam[0], llrInted[0], &m, csi[0]);
+			if(m.nSS > 1)
+			{
+				procSymQamToLlr(qam[1], llrInted[1], &m, csi[1]);
+			}
+		}
+		// deinterleave and deparse the streams in one pass
+		procSymDeintFused(llrInted[0], tmpLlr, deintGat, m.nCBPS);
+		if(llrType != C8P_LLR_FLOAT)
+		{
+			procLlrQuant(llrDeint, &outQuant[o2 * llrItemSize(llrType)], m.nCBPS, llrScale, llrType);
+		}
+		nSymProcd += 1;
+		o1 += m.nSymSamp;
+		o2 += m.nCBPS;
+	}
+}
+
+void c8pRxDemod::nonLegacyChanEstimate(const gr_complex* in1, const gr_complex* in2)
+{
+	// SISO, SU-MIMO 2x2, and with one antenna the MU-MIMO user and 2x2 sounding
+	if(m.format == C8P_F_VHT && m.sumu)
+	{
+		// mu-mimo, the stream at muPos from the two ltfs of the first antenna
+		fftDemod(&in1[C8P_SYM_SAMP_SHIFT], fftLtfOut1);
+		fftDemod(&in1[C8P_SYM_SAMP_SHIFT+80], fftLtfOut12);
+		for(int i=0;i<64;i++)
+		{
+			if(i==0 || (i>=29 && i<=35))
+			{}
+			else if(muPos == 0)
+			{
+				H_NL[i][0] = (fftLtfOut1[i] - fftLtfOut12[i]) / (LTF_NL_28_F_FLOAT[i] * 2.0f);
+			}
+			else
+			{
+				H_NL[i][0] = (fftLtfOut1[i]/LTF_NL_28_F_FLOAT[i] + fftLtfOut12[i]/LTF_NL_28_F_FLOAT_VHT22[i]) / 2.0f;
+			}
+		}
+	}
+	else if(m.nSS == 1)
+	{
+		if(m.nLTF == 1)
+		{
+			fftDemod(&in1[C8P_SYM_SAMP_SHIFT], fftLtfOut1);
+			for(int i=0;i<64;i++)
+			{
+				if(i==0 || (i>=29 && i<=35))
+				{}
+				else
+				{
+					H_NL[i][0] = fftLtfOut1[i] / LTF_NL_28_F_FLOAT[i];
+				}
+			}
+		}
+	}
+	else if(m.nSS == 2 && !in2)
+	{
+		// one antenna of a 2x2 sounding, the first ltf is enough for the sig b
+		memcpy(&ndpChan[0], &in1[C8P_SYM_SAMP_SHIFT], sizeof(gr_complex) * 64);
+		memcpy(&ndpChan[64], &in1[C8P_SYM_SAMP_SHIFT+80], sizeof(gr_complex) * 64);
+		fftDemod(&in1[C8P_SYM_SAMP_SHIFT], fftLtfOut1);
+		for(int i=0;i<64;i++)
+		{
+			if(i==0 || (i>=29 && i<=35))
+			{}
+			else
+			{
+				H_NL[i][0] = fftLtfOut1[i] / LTF_NL_28_F_FLOAT[i];
+			}
+		}
+	}
+	else if(m.nSS == 2)
+	{
+		fftDemod(&in1[C8P_SYM_SAMP_SHIFT], fftLtfOut1);
+		fftDemod(&in2[C8P_SYM_SAMP_SHIFT], fftLtfOut2);
+		fftDemod(&in1[C8P_SYM_SAMP_SHIFT+80], fftLtfOut12);
+		fftDemod(&in2[C8P_SYM_SAMP_SHIFT+80], fftLtfOut22);
+		for(int i=0;i<64;i++)
+		{
+			if(i==0 || (i>=29 && i<=35))
+			{
+			}
+			else
+			{
+				H_NL[i][0] = (fftLtfOut1[i] - fftLtfOut12[i])*LTF_NL_28_F_FLOAT2[i];
+				H_NL[i][1] = (fftLtfOut2[i] - fftLtfOut22[i])*LTF_NL_28_F_FLOAT2[i];
+				H_NL[i][2] = (fftLtfOut1[i] + fftLtfOut12[i])*LTF_NL_28_F_FLOAT2[i];
+				H_NL[i][3] = (fftLtfOut2[i] + fftLtfOut22[i])*LTF_NL_28_F_FLOAT2[i];
+			}
+		}
+		if(m.format == C8P_F_VHT)
+		{
+			// the vht ltf pilots are not mapped by P, use the neighbours
+			const int tmpSc[4] = {7, 21, 43, 57};
+			for(int k=0;k<4;k++)
+			{
+				for(int j=0;j<4;j++)
+				{
+					H_NL[tmpSc[k]][j] = (H_NL[tmpSc[k]-1][j] + H_NL[tmpSc[k]+1][j]) / 2.0f;
+				}
+			}
+		}
+		procEq2Prep(H_NL, 0.0f, &eq2);
+		// get the pilots from nl ltf, only for 2x2, by the same equalizer as the data
+		// pilot k of the symbol is on subcarrier tmpSc[k], the one on 57 is inverted
+		gr_complex tmpLtf1[64], tmpLtf2[64];
+		procEq2Apply(&eq2, fftLtfOut1, fftLtfOut2, tmpLtf1, tmpLtf2);
+		const int tmpSc[4] = {43, 57, 7, 21};
+		for(int k=0;k<4;k++)
+		{
+			gr_complex tmps1 = tmpLtf1[tmpSc[k]];
+			gr_complex tmps2 = tmpLtf2[tmpSc[k]];
+			if(k == 1)
+			{
+				tmps1 = -tmps1;
+				tmps2 = -tmps2;
+			}
+			pilotNlLtf[k] = std::conj(tmps1);
+			pilotNlLtf2[k] = std::conj(tmps2);
+		}
+	}
+	else
+	{
+		// not supported
+	}
+}
+
+void c8pRxDemod::htChanUpdate(const gr_complex* fft1, const gr_complex* fft2)
+{
+	if(m.nSS == 1)
+	{
+		for(int i=0;i<64;i++)
+		{
+			if(i==0 || (i>=29 && i<=35))
+			{}
+			else
+			{
+				sig1[i] = fft1[i] / H_NL[i][0];
+			}
+		}
+		gr_complex tmpPilotSum = std::conj(sig1[7]*pilot[2]*PILOT_P[pilotP] + sig1[21]*pilot[3]*PILOT_P[pilotP] + sig1[43]*pilot[0]*PILOT_P[pilotP] + sig1[57]*pilot[1]*PILOT_P[pilotP]);
+		pilotShift(pilot);
+		pilotP = (pilotP + 1) % 127;
+		float tmpPilotSumAbs = std::abs(tmpPilotSum);
+		int j=26;
+		for(int i=0;i<64;i++)
+		{
+			if(i==0 || (i>=29 && i<=35) || i==7 || i==21 || i==43 || i==57)
+			{
+			}
+			else
+			{
+				qam[0][j] = sig1[i] * tmpPilotSum / tmpPilotSumAbs;
+				j++;
+				if(j >= 52){j = 0;}
+			}
+		}
+	}
+	else
+	{
+		procEq2Apply(&eq2, fft1, fft2, sig1, sig2);
+
+		gr_complex tmpPilotSum = std::conj(
+			sig1[7]*pilot[2]*PILOT_P[pilotP]*pilotNlLtf[2] +
+			sig1[21]*pilot[3]*PILOT_P[pilotP]*pilotNlLtf[3] +
+			sig1[43]*pilot[0]*PILOT_P[pilotP]*pilotNlLtf[0] +
+			sig1[57]*pilot[1]*PILOT_P[pilotP]*pilotNlLtf[1] +
+			sig2[7]*pilot2[2]*PILOT_P[pilotP]*pilotNlLtf2[2] +
+			sig2[21]*pilot2[3]*PILOT_P[pilotP]*pilotNlLtf2[3] +
+			sig2[43]*pilot2[0]*PILOT_P[pilotP]*pilotNlLtf2[0] +
+			sig2[57]*pilot2[1]*PILOT_P[pilotP]*pilotNlLtf2[1]);
+
+		pilotShift(pilot);
+		pilotShift(pilot2);
+		pilotP = (pilotP + 1) % 127;
+		float tmpPilotSumAbs = std::abs(tmpPilotSum);
+
+		int j=26;
+		for(int i=0;i<64;i++)
+		{
+			if(i==0 || (i>=29 && i<=35) || i==7 || i==21 || i==43 || i==57)
+			{}
+			else
+			{
+				qam[0][j] = sig1[i] * tmpPilotSum / tmpPilotSumAbs;
+				qam[1][j] = sig2[i] * tmpPilotSum / tmpPilotSumAbs;
+				j++;
+				if(j >= 52){j = 0;}
+			}
+		}
+	}
+}
+
+void c8pRxDemod::vhtChanUpdate(const gr_complex* fft1, const gr_complex* fft2)
+{
+	if(m.nSS == 1)
+	{
+		for(int i=0;i<64;i++)
+		{
+			if(i==0 || (i>=29 && i<=35))
+			{}
+			else
+			{
+				sig1[i] = fft1[i] / H_NL[i][0];
+			}
+		}
+		gr_complex tmpPilotSum = std::conj(sig1[7]*pilot[2]*PILOT_P[pilotP] + sig1[21]*pilot[3]*PILOT_P[pilotP] + sig1[43]*pilot[0]*PILOT_P[pilotP] + sig1[57]*pilot[1]*PILOT_P[pilotP]);
+		pilotShift(pilot);
+		pilotP = (pilotP + 1) % 127;
+		float tmpPilotSumAbs = std::abs(tmpPilotSum);
+		int j=26;
+		for(int i=0;i<64;i++)
+		{
+			if(i==0 || (i>=29 && i<=35) || i==7 || i==21 || i==43 || i==57)
+			{
+			}
+			else
+			{
+				qam[0][j] = sig1[i] * tmpPilotSum / tmpPilotSumAbs;
+				j++;
+				if(j >= 52){j = 0;}
+			}
+		}
+	}
+	else
+	{
+		procEq2Apply(&eq2, fft1, fft2, sig1, sig2);
+		gr_complex tmpPilotSum = std::conj(
+			sig1[7]*pilot[2]*PILOT_P[pilotP]*pilotNlLtf[2] +
+			sig1[21]*pilot[3]*PILOT_P[pilotP]*pilotNlLtf[3] +
+			sig1[43]*pilot[0]*PILOT_P[pilotP]*pilotNlLtf[0] +
+			sig1[57]*pilot[1]*PILOT_P[pilotP]*pilotNlLtf[1] +
+			sig2[7]*pilot[2]*PILOT_P[pilotP]*pilotNlLtf2[2] +
+			sig2[21]*pilot[3]*PILOT_P[pilotP]*pilotNlLtf2[3] +
+			sig2[43]*pilot[0]*PILOT_P[pilotP]*pilotNlLtf2[0] +
+			sig2[57]*pilot[1]*PILOT_P[pilotP]*pilotNlLtf2[1]);
+		pilotShift(pilot);
+		pilotP = (pilotP + 1) % 127;
+		float tmpPilotSumAbs = std::abs(tmpPilotSum);
+		int j=26;
+		for(int i=0;i<64;i++)
+		{
+			if(i==0 || (i>=29 && i<=35) || i==7 || i==21 || i==43 || i==57)
+			{}
+			else
+			{
+				qam[0][j] = sig1[i] * tmpPilotSum / tmpPilotSumAbs;
+				qam[1][j] = sig2[i] * tmpPilotSum / tmpPilotSumAbs;
+				j++;
+				if(j >= 52){j = 0;}
+			}
+		}
+	}
+}
+
+void c8pRxDemod::vhtSigBDemod(const gr_complex* in1, const gr_complex* in2)
+{
+	bool tmpTwo = (m.nSS == 2 && in2);
+	if(m.nSS == 1 || !in2)
+	{
+		fftDemod(&in1[C8P_SYM_SAMP_SHIFT], fftLtfOut1);
+		for(int i=0;i<64;i++)
+		{
+			if(i==0 || (i>=29 && i<=35))
+			{}
+			else
+			{
+				sig1[i] = fftLtfOut1[i] / H_NL[i][0];
+			}
+		}
+		gr_complex tmpPilotSum = std::conj(sig1[7] - sig1[21] + sig1[43] + sig1[57]);
+		float tmpPilotSumAbs = std::abs(tmpPilotSum);
+		int j=26;
+		for(int i=0;i<64;i++)
+		{
+			if(i==0 || (i>=29 && i<=35) || i==7 || i==21 || i==43 || i==57)
+			{}
+			else
+			{
+				sigVhtBQam0[j] = sig1[i] * tmpPilotSum / tmpPilotSumAbs;
+				sigVhtB20IntedLlr[j] = sigVhtBQam0[j].real();
+				j++;
+				if(j >= 52){j = 0;}
+			}
+		}
+	}
+	else if(tmpTwo)
+	{
+		fftDemod(&in1[C8P_SYM_SAMP_SHIFT], fftLtfOut1);
+		fftDemod(&in2[C8P_SYM_SAMP_SHIFT], fftLtfOut2);
+		procEq2Apply(&eq2, fftLtfOut1, fftLtfOut2, sig1, sig2);
+		gr_complex tmpPilotSum = std::conj(
+			sig1[7]*pilotNlLtf[2] -
+			sig1[21]*pilotNlLtf[3] +
+			sig1[43]*pilotNlLtf[0] +
+			sig1[57]*pilotNlLtf[1] +
+			sig2[7]*pilotNlLtf2[2] -
+			sig2[21]*pilotNlLtf2[3] +
+			sig2[43]*pilotNlLtf2[0] +
+			sig2[57]*pilotNlLtf2[1]);
+		float tmpPilotSumAbs = std::abs(tmpPilotSum);
+		int j=26;
+		for(int i=0;i<64;i++)
+		{
+			if(i==0 || (i>=29 && i<=35) || i==7 || i==21 || i==43 || i==57)
+			{}
+			else
+			{
+				sigVhtBQam0[j] = sig1[i] * tmpPilotSum / tmpPilotSumAbs;
+				sigVhtBQam1[j] = sig2[i] * tmpPilotSum / tmpPilotSumAbs;
+				sigVhtB20IntedLlr[j] = (sigVhtBQam0[j].real() + sigVhtBQam1[j].real())/2.0f;
+				j++;
+				if(j >= 52){j = 0;}
+			}
+		}
+	}
+	else
+	{
+		memset(sigVhtB20Bits, 0, 26);
+		return;
+	}
+
+	for(int i=0;i<52;i++)
+	{
+		sigVhtB20CodedLlr[mapDeintVhtSigB20[i]] = sigVhtB20IntedLlr[i];
+	}
+	decoder.decode(sigVhtB20CodedLlr, sigVhtB20Bits, 26);
+
+	// re-encode the sig b to get the snr of each stream from its error
+	bccEncoder(sigVhtB20Bits, sigVhtB20BitsCoded, 26);
+	procIntelVhtB20(sigVhtB20BitsCoded, sigVhtB20BitsInted);
+	double tmpNoisePower0 = 0.0;
+	double tmpNoisePower1 = 0.0;
+	for(int i=0;i<52;i++)
+	{
+		gr_complex tmpRef = sigVhtB20BitsInted[i] ? gr_complex(1.0f, 0.0f) : gr_complex(-1.0f, 0.0f);
+		sigVhtBQam0[i] -= tmpRef;
+		tmpNoisePower0 += (double)(sigVhtBQam0[i].real()*sigVhtBQam0[i].real() + sigVhtBQam0[i].imag() * sigVhtBQam0[i].imag());
+		if(tmpTwo)
+		{
+			sigVhtBQam1[i] -= tmpRef;
+			tmpNoisePower1 += (double)(sigVhtBQam1[i].real()*sigVhtBQam1[i].real() + sigVhtBQam1[i].imag() * sigVhtBQam1[i].imag());
+		}
+	}
+	sssnr0 = (float)(log10(52.0/tmpNoisePower0) * 10.0);
+	if(tmpTwo)
+	{
+		sssnr1 = (float)(log10(52.0/tmpNoisePower1) * 10.0);
+	}
+}
+
+void c8pRxDemod::legacyChanUpdate(const gr_complex* fft1)
+{
+	for(int i=0;i<64;i++)
+	{
+		if(i==0 || (i>=27 && i<=37))
+		{}
+		else
+		{
+			sig1[i] = fft1[i] / HL[i];
+		}
+	}
+	gr_complex tmpPilotSum = std::conj(sig1[7]*pilot[2]*PILOT_P[pilotP] + sig1[21]*pilot[3]*PILOT_P[pilotP] + sig1[43]*pilot[0]*PILOT_P[pilotP] + sig1[57]*pilot[1]*PILOT_P[pilotP]);
+	pilotP = (pilotP + 1) % 127;
+	float tmpPilotSumAbs = std::abs(tmpPilotSum);
+	int j=24;
+	for(int i=0;i<64;i++)
+	{
+		if(i==0 || (i>=27 && i<=37) || i==7 || i==21 || i==43 || i==57)
+		{}
+		else
+		{
+			qam[0][j] = sig1[i] * tmpPilotSum / tmpPilotSumAbs;
+			j++;
+			if(j >= 48){j = 0;}
+		}
+	}
+}
+
+void c8pRxDemod::fftDemod(const gr_complex* sig, gr_complex* res)
+{
+	memcpy(fft.get_inbuf(), sig, sizeof(gr_complex)*64);
+	fft.execute();
+	memcpy(res, fft.get_outbuf(), sizeof(gr_complex)*64);
+}
+
+void c8pRxDemod::pilotShift(float* pilots)
+{
+	float tmpPilot = pilots[0];
+	pilots[0] = pilots[1];
+	pilots[1] = pilots[2];
+	pilots[2] = pilots[3];
+	pilots[3] = tmpPilot;
+}
+
+void c8pMpduParser::init(int f, int l, int t)
+{
+	format = f;
+	len = l;
+	trellis = t;
+	bitP = 16;
+	done = false;
+	fcs = 0;
+	fcsDone = 0;
+}
+
+void c8pMpduParser::subframes(const svDataDecoder* dec, const std::function<void(const uint8_t*, int, uint32_t)>& pub)
+{
+	// n and ac ampdu, each subframe is assembled once all its bits are descrambled
+	int tmpEndBit = (format == C8P_F_VHT) ? trellis : (16 + len * 8);
+	while(!done)
+	{
+		if((bitP + 32) > tmpEndBit)
+		{
+			done = true;
+			break;
+		}
+		if((bitP + 32) > dec->dsDone)
+		{
+			break;
+		}
+		const uint8_t* tmpByteP = &dec->unCodedBytes[bitP / 8];
+		int tmpEof = 0, tmpLen = 0, tmpSubBits;
+		uint8_t tmpDelBits[24];
+		for(int i=0;i<24;i++)
+		{
+			tmpDelBits[i] = (tmpByteP[i/8] >> (i%8)) & 1;
+		}
+		if(tmpByteP[3] != 0x4e || !checkBitCrc8(tmpDelBits, 16, &tmpDelBits[16]))
+		{
+			// corrupted delimiter, delimiters are 4 byte aligned so search the next 4 bytes
+			bitP += 32;
+			continue;
+		}
+		tmpLen = (tmpByteP[0] >> 4) | (((int)tmpByteP[1]) << 4);
+		if(format == C8P_F_VHT)
+		{
+			tmpEof = tmpByteP[0] & 1;
+			tmpLen |= ((tmpByteP[0] >> 2) & 3) << 12;
+		}
+		if(tmpLen == 0)
+		{
+			// padding delimiter, or eof padding of ac
+			bitP += 32;
+			if(tmpEof)
+			{
+				done = true;
+				break;
+			}
+			continue;
+		}
+		// last n subframe is not padded
+		tmpSubBits = std::min((tmpLen/4 + ((tmpLen%4)!=0))*4*8, tmpEndBit - bitP - 32);
+		if(tmpLen > C8P_RX_MPDU_MAX || tmpLen * 8 > tmpSubBits)
+		{
+			done = true;
+			break;
+		}
+		if((bitP + 32 + tmpSubBits) > dec->dsDone)
+		{
+			break;
+		}
+		bitP += (32 + tmpSubBits);
+		pub(&tmpByteP[4], tmpLen, gr::ieee80211::utils::crc32_update(0, &tmpByteP[4], tmpLen));
+
+		if(tmpEof)
+		{
+			done = true;
+			break;
+		}
+	}
+}
+
+void c8pMpduParser::fcsUpdate(const svDataDecoder* dec)
+{
+	// extends the crc over the psdu bytes descrambled since the last call
+	int tmpAvail = std::min(len, dec->dsDone / 8 - 2);
+	if(tmpAvail > fcsDone)
+	{
+		fcs = gr::ieee80211::utils::crc32_update(fcs, &dec->unCodedBytes[2 + fcsDone], tmpAvail - fcsDone);
+		fcsDone = tmpAvail;
+	}
+}
+
+bool c8pRxFrame::run(c8pRxDemod* rx, std::vector<uint8_t>* llr, int llrType, const gr_complex* in1, const gr_complex* in2, int nSamp, int sigMcs, int sigLen, const gr_complex* chan, float snr)
+{
+	rx->init(sigMcs, sigLen, chan);
+	int tmpOff = 0;
+	if(sigMcs > 0 || rx->format(in1) == C8P_F_L)
+	{
+		rx->legacy();
+	}
+	else
+	{
+		tmpOff = C8P_RX_NL_SIG_SAMP;
+		// a packet that fits in the legacy length has all of its fields in the span
+		if((tmpOff + rx->nonLegacySamp()) > nSamp || !rx->nonLegacy(&in1[tmpOff], &in2[tmpOff]))
+		{
+			return false;
+		}
+		tmpOff += rx->nonLegacySamp();
+	}
+	const c8p_mod& tmpM = rx->m;
+	if(rx->nTrellis > SV_T_MAX)
+	{
+		return false;
+	}
+
+	rx->prep(snr);
+	int tmpTotal = tmpM.nSym * tmpM.nCBPS;
+	int tmpItem = llrItemSize(llrType);
+	if((int)llr->size() < tmpTotal * tmpItem)
+	{
+		llr->resize(tmpTotal * tmpItem);
+	}
+	rx->demod(&in1[tmpOff], &in2[tmpOff], tmpM.nSym, llr->data());
+
+	format = tmpM.format;
+	mcs = tmpM.mcs;
+	nss = tmpM.nSS;
+	len = tmpM.len;
+	ampdu = tmpM.ampdu;
+	trellis = rx->nTrellis;
+	dec.init(trellis, tmpM.cr);
+	switch(llrType)
+	{
+		case C8P_LLR_I16:
+			dec.update((const int16_t*)llr->data(), tmpTotal);
+			break;
+		case C8P_LLR_I8:
+			dec.update((const int8_t*)llr->data(), tmpTotal);
+			break;
+		default:
+			dec.update((const float*)llr->data(), tmpTotal);
+	}
+	if(dec.t < trellis)
+	{
+		return false;
+	}
+	dec.end();
+	dec.descramble();
+	parser.init(format, len, trellis);
+	return true;
+}
+
+void c8pRxFrame::mpdus(const std::function<void(const uint8_t*, int)>& pub)
+{
+	if(format == C8P_F_VHT || ampdu)
+	{
+		parser.subframes(&dec, [&pub](const uint8_t* mpdu, int mpduLen, uint32_t crc){
+			if(crc == C8P_RX_FCS_RESIDUE)
+			{
+				pub(mpdu, mpduLen);
+			}
+		});
+	}
+	else
+	{
+		// a and n general packet, psdu after 2 bytes service field
+		parser.fcsUpdate(&dec);
+		if(parser.fcs == C8P_RX_FCS_RESIDUE)
+		{
+			pub(&dec.unCodedBytes[2], len);
+		}
+	}
+}
+
+c8pStfDetect::c8pStfDetect()
+{
+	size_t tmpAlign = volk_get_alignment();
+	prod = (gr_complex*)volk_malloc(sizeof(gr_complex) * (C8P_STF_CHUNK + C8P_STF_AC_LEN), tmpAlign);
+	mag2 = (float*)volk_malloc(sizeof(float) * (C8P_STF_CHUNK + C8P_STF_PWR_LEN), tmpAlign);
+	pwrOut = (float*)volk_malloc(sizeof(float) * C8P_STF_CHUNK, tmpAlign);
+	ac = (float*)volk_malloc(sizeof(float) * C8P_STF_CHUNK, tmpAlign);
+	reset();
+}
+
+c8pStfDetect::~c8pStfDetect()
+{
+	volk_free(prod);
+	volk_free(mag2);
+	volk_free(pwrOut);
+	volk_free(ac);
+}
+
+void c8pStfDetect::reset()
+{
+	nPlateau = 0;
+	fPlateau = 0;
+	fPlateauEnd = 0;
+	countDown = 0;
+	conjAc = 0.0f;
+}
+
+void c8pStfDetect::run(const gr_complex* sig, int n, uint8_t* trigger, gr_complex* conj)
+{
+	for(int tmpStart=0;tmpStart<n;tmpStart+=C8P_STF_CHUNK)
+	{
+		const gr_complex* tmpSig = sig + tmpStart;
+		gr_complex* tmpConj = conj + tmpStart;
+		uint8_t* tmpTrigger = trigger + tmpStart;
+		int tmpN = std::min(C8P_STF_CHUNK, n - tmpStart);
+
+		// products and powers of the chunk and of the window before it
+		// prod[j] is x[n-16] * conj(x[n]) and mag2[j] is |x[n]|^2 of n = j - window
+		volk_32fc_x2_multiply_conjugate_32fc(prod, tmpSig - C8P_STF_AC_LEN - C8P_STF_DELAY, tmpSig - C8P_STF_AC_LEN, tmpN + C8P_STF_AC_LEN);
+		volk_32fc_magnitude_squared_32f(mag2, tmpSig - C8P_STF_PWR_LEN, tmpN + C8P_STF_PWR_LEN);
+
+		// window sums of the sample before the chunk, redone each time so rounding never builds up
+		double tmpAcR = 0.0, tmpAcI = 0.0, tmpPwr = 0.0;
+		for(int j=0;j<C8P_STF_AC_LEN;j++)
+		{
+			tmpAcR += prod[j].real();
+			tmpAcI += prod[j].imag();
+		}
+		for(int j=0;j<C8P_STF_PWR_LEN;j++)
+		{
+			tmpPwr += mag2[j];
+		}
+
+		// sliding sums, the only serial part
+		for(int i=0;i<tmpN;i++)
+		{
+			tmpAcR += prod[i + C8P_STF_AC_LEN].real() - prod[i].real();
+			tmpAcI += prod[i + C8P_STF_AC_LEN].imag() - prod[i].imag();
+			tmpPwr += mag2[i + C8P_STF_PWR_LEN] - mag2[i];
+			tmpConj[i] = gr_complex((float)tmpAcR, (float)tmpAcI);
+			pwrOut[i] = (float)tmpPwr;
+		}
+		volk_32fc_magnitude_32f(ac, tmpConj, tmpN);
+		volk_32f_x2_divide_32f(ac, ac, pwrOut, tmpN);
+
+		for(int i=0;i<tmpN;i++)
+		{
+			tmpTrigger[i] = 0;
+			if(ac[i] > 0.3f)
+			{
+				nPlateau++;
+				if(ac[i] > conjAc)
+				{
+					conjAc = ac[i];
+					// indicate to update conjugate
+					tmpTrigger[i] |= 0x02;
+				}
+				if(nPlateau > 20 && (fPlateau+fPlateauEnd)==0)
+				{
+					fPlateau = 1;
+					fPlateauEnd = 1;
+					countDown = 80;
+				}
+			}
+			else
+			{
+				nPlateau = 0;
+				fPlateauEnd = 0;
+				conjAc = 0.0f;
+			}
+			if(fPlateau)
+			{
+				countDown--;
+				if(countDown==0)
+				{
+					fPlateau = 0;
+					tmpTrigger[i] |= 0x01;
+				}
+			}
+		}
+	}
+}
+
+c8pLtfSync::c8pLtfSync()
+{
+	conjMultiAvg = gr_complex(0.0f, 0.0f);
+	index = 0;
+	rad = 0.0f;
+	snr = 0.0f;
+	rssi = 0.0f;
+}
+
+bool c8pLtfSync::run(const gr_complex* sig)
+{
+	autoCorrelation(sig);
+	float* tmpMaxAcP = std::max_element(ac, ac + C8P_SYNC_RES_LEN);
+	if(*tmpMaxAcP > 0.5)  // some miss trigger not higher than 0.5
+	{
+		float tmpMaxAc = *tmpMaxAcP * 0.8;
+		double tmpMaxAcD = (double)(*tmpMaxAcP);
+		int tmpMaxIndex = std::distance(ac, tmpMaxAcP);
+		int tmpLIndex = tmpMaxIndex;
+		int tmpRIndex = tmpMaxIndex;
+		for(int j=tmpMaxIndex; j>=0; j--)
+		{
+			if(ac[j] < tmpMaxAc)
+			{
+				tmpLIndex = j;
+				break;
+			}
+		}
+		for(int j=tmpMaxIndex; j<C8P_SYNC_RES_LEN; j++)
+		{
+			if(ac[j] < tmpMaxAc)
+			{
+				tmpRIndex = j;
+				break;
+			}
+		}
+		index = (tmpLIndex+tmpRIndex)/2;
+		rad = cfo(&sig[index]);
+		snr = (float)(10.0 * log10(tmpMaxAcD / (1.0 - tmpMaxAcD)));
+		rssi = pwr[tmpMaxIndex] / 64.0f;
+		return true;
+	}
+	return false;
+}
+
+void c8pLtfSync::autoCorrelation(const gr_complex* sig)
+{
+	gr_complex tmpMultiSum = gr_complex(0.0f, 0.0f);
+	float tmpSig1Sum = 0.0f;
+	float tmpSig2Sum = 0.0f;
+	// for 20MHz, init part 64 samples
+	for(int i=0;i<64;i++)
+	{
+		tmpMultiSum += sig[i] * std::conj(sig[i+64]);
+		tmpSig1Sum += std::abs(sig[i])*std::abs(sig[i]);
+		tmpSig2Sum += std::abs(sig[i+64])*std::abs(sig[i+64]);
+	}
+	for(int i=0;i<C8P_SYNC_RES_LEN;i++)   // sliding window to compute auto correlation
+	{
+		ac[i] = std::abs(tmpMultiSum)/std::sqrt(tmpSig1Sum)/std::sqrt(tmpSig2Sum);
+		pwr[i] = tmpSig1Sum;
+		tmpMultiSum -= sig[i] * std::conj(sig[i+64]);
+		tmpSig1Sum -= std::abs(sig[i])*std::abs(sig[i]);
+		tmpSig2Sum -= std::abs(sig[i+64])*std::abs(sig[i+64]);
+		tmpMultiSum += sig[i+64] * std::conj(sig[i+64+64]);
+		tmpSig1Sum += std::abs(sig[i+64])*std::abs(sig[i+64]);
+		tmpSig2Sum += std::abs(sig[i+64+64])*std::abs(sig[i+64+64]);
+	}
+}
+
+float c8pLtfSync::cfo(const gr_complex* sig)
+{
+	// STF CFO with LTF residual CFO
+	gr_complex tmpConjSum = gr_complex(0.0f, 0.0f);
+	float tmpRadStepStf = atan2f(conjMultiAvg.imag(), conjMultiAvg.real()) / 16.0f;
+	for(int i=0;i<128;i++)
+	{
+		conjSamp[i] = sig[i] * gr_complex(cosf(i * tmpRadStepStf), sinf(i * tmpRadStepStf));
+	}
+	for(int i=0;i<64;i++)
+	{
+		tmpConjSum += conjSamp[i] * std::conj(conjSamp[i+64]);
+	}
+	float tmpRadStepLtf = atan2f((tmpConjSum/64.0f).imag(), (tmpConjSum/64.0f).real()) / 64.0f;
+	return (tmpRadStepStf + tmpRadStepLtf);
+}
+
+c8pRxPacket::c8pRxPacket(int llrType)
+	: llrType(llrType), rx(llrType)
+{
+	nCopied = 0;
+	snr = 0.0f;
+	cfoStep = gr_complex(1.0f, 0.0f);
+	cfoPhase1 = gr_complex(1.0f, 0.0f);
+	cfoPhase2 = gr_complex(1.0f, 0.0f);
+}
+
+bool c8pRxPacket::sig(const gr_complex* in, float rad, float pktSnr)
+{
+	if(!rxSig.run(in, rad))
+	{
+		return false;
+	}
+	if((int)arena1.size() < rxSig.nSamp + C8P_RX_PAD)
+	{
+		arena1.resize(rxSig.nSamp + C8P_RX_PAD);
+		arena2.resize(rxSig.nSamp + C8P_RX_PAD);
+	}
+	snr = pktSnr;
+	nCopied = 0;
+	cfoStep = std::polar(1.0f, rad);
+	cfoPhase1 = std::polar(1.0f, (float)C8P_RX_SIG_SAMP * rad);
+	cfoPhase2 = cfoPhase1;
+	return true;
+}
+
+int c8pRxPacket::copy(const gr_complex* in1, const gr_complex* in2, int n)
+{
+	// the cfo is removed on the way into the scratch, the phase carries over to the next call
+	int tmpNum = std::min(n, rxSig.nSamp - nCopied);
+	volk_32fc_s32fc_x2_rotator_32fc(&arena1[nCopied], in1, cfoStep, &cfoPhase1, tmpNum);
+	if(in2)
+	{
+		volk_32fc_s32fc_x2_rotator_32fc(&arena2[nCopied], in2, cfoStep, &cfoPhase2, tmpNum);
+	}
+	else
+	{
+		memset((uint8_t*)&arena2[nCopied], 0, sizeof(gr_complex) * tmpNum);
+	}
+	nCopied += tmpNum;
+	return tmpNum;
+}
+
+bool c8pRxPacket::decode()
+{
+	memset((uint8_t*)&arena1[nCopied], 0, sizeof(gr_complex) * C8P_RX_PAD);
+	memset((uint8_t*)&arena2[nCopied], 0, sizeof(gr_complex) * C8P_RX_PAD);
+	return frame.run(&rx, &llr, llrType, arena1.data(), arena2.data(), rxSig.nSamp, rxSig.mcs, rxSig.len, rxSig.h.data(), snr);
+}
@@ -0,0 +1,295 @@
+/*
+ *
+ *     GNU Radio IEEE 802.11a/g/n/ac 20M bw and upto 2x2
+ *     Per packet receiver stages, shared by the blocks and the workers
+ *     Copyright (C) June 1, 2022  Zelin Yun
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU Affero General Public License as published
+ *     by the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU Affero General Public License for more details.
+ *
+ *     You should have received a copy of the GNU Affero General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_CLOUD80211RX_H
+#define INCLUDED_CLOUD80211RX_H
+
+#include <functional>
+#include <vector>
+#include <gnuradio/fft/fft.h>
+#include "cloud80211phy.h"
+#include "cloud80211fft.h"
+#include "cloud80211viterbi.h"
+
+#define C8P_RX_SIG_SAMP 224		// sync index to the first sample after the legacy signal
+#define C8P_RX_NL_SIG_SAMP 160		// ht sig or vht sig a
+#define C8P_RX_MPDU_MAX 4095
+#define C8P_RX_PAD 320			// zero samples after a span, read by the format check of short packets
+#define C8P_RX_FCS_RESIDUE 0x2144DF1C	// crc32 of an mpdu with its correct fcs
+
+#define C8P_STF_DELAY 16		// stf period
+#define C8P_STF_AC_LEN 48		// autocorrelation window
+#define C8P_STF_PWR_LEN 64		// power window
+#define C8P_STF_HIST 64			// past samples needed, the longer window
+#define C8P_STF_CHUNK 4096		// samples per vector pass
+
+#define C8P_SYNC_BUF_LEN 240		// samples from the trigger searched for the ltf
+#define C8P_SYNC_RES_LEN (C8P_SYNC_BUF_LEN - 128 - 1)
+
+/*
+ * STF detection over a stream. sig has C8P_STF_HIST past samples before it,
+ * for each of the n samples conj gets the 48 sample autocorrelation at lag 16
+ * and trigger the plateau flags, 0x01 once the plateau has lasted, 0x02 when
+ * the normalized autocorrelation reaches a new max of the plateau. The
+ * plateau state carries over to the next call.
+ */
+class c8pStfDetect
+{
+	private:
+	gr_complex* prod;	/* x[n-16] * conj(x[n]) from 48 samples back */
+	float* mag2;		/* |x[n]|^2 from 64 samples back */
+	float* pwrOut;
+	float* ac;
+	int nPlateau;
+	int fPlateau;
+	int fPlateauEnd;
+	int countDown;
+	float conjAc;
+
+	public:
+	c8pStfDetect();
+	~c8pStfDetect();
+	void reset();
+	void run(const gr_complex* sig, int n, uint8_t* trigger, gr_complex* conj);
+};
+
+/*
+ * LTF sync after an STF trigger. conjMultiAvg is the stf autocorrelation
+ * of the last 0x02 trigger flag. run takes C8P_SYNC_BUF_LEN samples from the
+ * trigger and finds the middle of the ltf autocorrelation plateau, index is
+ * the sync index, the LTF start + 16, in the first C8P_SYNC_RES_LEN samples.
+ * rad is the stf cfo with the ltf residual, snr and rssi come from the
+ * plateau max.
+ */
+class c8pLtfSync
+{
+	private:
+	float ac[C8P_SYNC_RES_LEN];
+	float pwr[C8P_SYNC_RES_LEN];
+	gr_complex conjSamp[128];
+
+	void autoCorrelation(const gr_complex* sig);
+	float cfo(const gr_complex* sig);
+
+	public:
+	gr_complex conjMultiAvg;
+	int index;
+	float rad;
+	float snr;
+	float rssi;
+
+	c8pLtfSync();
+	bool run(const gr_complex* sig);
+};
+
+/*
+ * Legacy signal of a packet. sig is at the sync index, the LTF start + 16,
+ * rad the cfo in rad per sample. The two LTF symbols give the legacy
+ * channel h and the signal symbol is decoded with it. nSamp is the span of
+ * the data field after the signal, C8P_RX_SIG_SAMP samples from the sync.
+ */
+class c8pRxSig
+{
+	private:
+	gr::fft::fft_complex_fwd fft1;
+	gr::fft::fft_complex_fwd fft2;
+	gr::fft::fft_complex_fwd ffts;
+	svSigDecoder decoder;
+	float llr[48];
+	uint8_t bits[24];
+
+	public:
+	int mcs;
+	int len;
+	int nDBPS;
+	int nSym;
+	int nSamp;
+	std::vector<gr_complex> h;
+
+	c8pRxSig();
+	bool run(const gr_complex* sig, float rad);
+};
+
+/*
+ * Demodulation of one packet after the legacy signal, cfo already removed.
+ * init takes the legacy signal and channel, format reads the HT-SIG or
+ * VHT-SIG-A symbols, nonLegacy the NL-STF, NL-LTFs and VHT-SIG-B from the
+ * NL-STF on and checks the packet fits the legacy length, or legacy sets up
+ * a legacy packet. prep then sets the llr weights and demod turns nSym data
+ * symbols into deinterleaved llr in llrType, nCBPS items per symbol. Each
+ * step reads only the samples it is given, a block can feed them as they
+ * arrive and a worker in one go. A null in2 is a single antenna, it takes
+ * one stream packets, the VHT MU-MIMO user at muPos and the NDP of a 2x2
+ * sounding, whose two LTF symbols are kept in ndpChan.
+ */
+class c8pRxDemod
+{
+	private:
+	int llrType;
+	int muPos;
+	int sigLMcs;
+	int sigLLen;
+	std::vector<gr_complex> HL;
+	// sig fields
+	svSigDecoder decoder;
+	gr_complex sig1[64];
+	gr_complex sig2[64];
+	float sigHtCodedLlr[96];
+	float sigVhtACodedLlr[96];
+	float sigVhtB20IntedLlr[52];
+	float sigVhtB20CodedLlr[52];
+	uint8_t sigHtBits[48];
+	uint8_t sigVhtABits[48];
+	uint8_t sigVhtB20Bits[26];
+	gr_complex sigVhtBQam0[52];
+	gr_complex sigVhtBQam1[52];
+	uint8_t sigVhtB20BitsCoded[52];
+	uint8_t sigVhtB20BitsInted[52];
+	// fft
+	gr::fft::fft_complex_fwd fft;
+	c8pFftBatch fftBatch1;
+	c8pFftBatch fftBatch2;
+	gr_complex fftLtfOut1[64];
+	gr_complex fftLtfOut2[64];
+	gr_complex fftLtfOut12[64];
+	gr_complex fftLtfOut22[64];
+	// pilot
+	int pilotP;
+	float pilot[4];
+	float pilot2[4];
+	gr_complex pilotNlLtf[4];
+	gr_complex pilotNlLtf2[4];
+	// non-legacy channel
+	gr_complex H_NL[64][4];
+	c8p_eq2 eq2;
+	gr_complex qam[2][52];
+	float llrInted[2][416];		/* interleaved llr of each stream */
+	float llrScale;
+	float csi[2][52];		/* llr weight of each qam */
+	float llrDeint[832];
+	const int* deintGat;		/* deinterleave and deparse gather of the packet, set in prep */
+
+	void nonLegacyChanEstimate(const gr_complex* in1, const gr_complex* in2);
+	void vhtChanUpdate(const gr_complex* fft1, const gr_complex* fft2);
+	void htChanUpdate(const gr_complex* fft1, const gr_complex* fft2);
+	void legacyChanUpdate(const gr_complex* fft1);
+	void vhtSigBDemod(const gr_complex* in1, const gr_complex* in2);
+	void fftDemod(const gr_complex* sig, gr_complex* res);
+	void pilotShift(float* pilots);
+
+	public:
+	c8p_mod m;
+	c8p_sigHt sigHt;
+	c8p_sigVhtA sigVhtA;
+	int nTrellis;
+	int nSymProcd;
+	float sssnr0;		/* spatial stream snr only for vht */
+	float sssnr1;
+	gr_complex ndpChan[128];
+
+	c8pRxDemod(int llrType, int muPos = 0);
+	void init(int mcs, int len, const gr_complex* chan);
+	int format(const gr_complex* sig);
+	int nonLegacySamp();
+	bool nonLegacy(const gr_complex* in1, const gr_complex* in2);
+	void legacy();
+	void prep(float snr);
+	void demod(const gr_complex* in1, const gr_complex* in2, int nSym, void* llr);
+};
+
+/*
+ * MPDUs of a psdu from the descrambled bytes of svDataDecoder, called again
+ * as more bytes are committed. A-MPDU subframes of n and ac are passed to
+ * pub once all their bits are there, a plain psdu of a and n keeps the
+ * running crc32 in fcs and is passed by the caller when it is done. The crc
+ * handed to pub covers the whole mpdu with its fcs.
+ */
+class c8pMpduParser
+{
+	public:
+	int format;
+	int len;
+	int trellis;
+	int bitP;		/* next delimiter, bit pos in unCodedBytes */
+	bool done;
+	uint32_t fcs;		/* running crc32 of the psdu bytes descrambled so far */
+	int fcsDone;
+
+	void init(int format, int len, int trellis);
+	void subframes(const svDataDecoder* dec, const std::function<void(const uint8_t*, int, uint32_t)>& pub);
+	void fcsUpdate(const svDataDecoder* dec);
+};
+
+/*
+ * Demodulation and decoding of one packet whose data span is in memory,
+ * from the first sample after the legacy signal with the cfo removed and
+ * C8P_RX_PAD zeros after it. run fills the decoder with the descrambled
+ * psdu and returns false when the packet can not be decoded. mpdus then
+ * passes the mpdus with a correct fcs to pub, without the A-MPDU framing.
+ */
+class c8pRxFrame
+{
+	public:
+	int format;
+	int mcs;
+	int nss;
+	int len;
+	int ampdu;
+	int trellis;
+	c8pMpduParser parser;
+	svDataDecoder dec;
+
+	bool run(c8pRxDemod* rx, std::vector<uint8_t>* llr, int llrType, const gr_complex* in1, const gr_complex* in2, int nSamp, int sigMcs, int sigLen, const gr_complex* chan, float snr);
+	void mpdus(const std::function<void(const uint8_t*, int)>& pub);
+};
+
+/*
+ * One packet from its sync index, fed as the samples arrive. sig decodes the
+ * legacy signal from C8P_RX_SIG_SAMP samples at the sync, copy then takes
+ * the data span, removes the cfo on the way into the scratch and returns the
+ * samples used. Once copied, decode runs frame over the span. A null in2 is
+ * a single antenna, its scratch stays zero and 2 stream packets fail.
+ */
+class c8pRxPacket
+{
+	private:
+	int llrType;
+	c8pRxDemod rx;
+	std::vector<gr_complex> arena1;
+	std::vector<gr_complex> arena2;
+	std::vector<uint8_t> llr;
+	int nCopied;
+	float snr;
+	gr_complex cfoStep;
+	gr_complex cfoPhase1;
+	gr_complex cfoPhase2;
+
+	public:
+	c8pRxSig rxSig;
+	c8pRxFrame frame;
+
+	c8pRxPacket(int llrType);
+	bool sig(const gr_complex* in, float rad, float pktSnr);
+	int copy(const gr_complex* in1, const gr_complex* in2, int n);
+	bool copied() const { return nCopied >= rxSig.nSamp; }
+	bool decode();
+};
+
+#endif /* INCLUDED_CLOUD80211RX_H */
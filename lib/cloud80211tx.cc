@@ -0,0 +1,372 @@
+/*
+ *
+ *     GNU Radio IEEE 802.11a/g/n/ac 20M bw and upto 2x2
+ *     Per packet transmitter stages, shared by the blocks and phy::Transmitter
+ *     Copyright (C) June 1, 2022  Zelin Yun
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU Affero General Public License as published
+ *     by the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU Affero General Public License for more details.
+ *
+ *     You should have received a copy of the GNU Affero General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "cloud80211tx.h"
+#include <gnuradio/fft/fft.h>
+
+void c8pTxEncoder::run(int format, int mcs, int nss, const uint8_t* psdu, int len)
+{
+	// signal part
+	formatToModSu(&m, format, mcs, nss, len);
+	if(format == C8P_F_L)
+	{
+		legacySigBitsGen(sigBitsL, sigBitsCodedL, m.mcs, m.len);
+		procIntelLegacyBpsk(sigBitsCodedL, sigIntedL);
+		memset(bits0, 0, 16);	// service bits
+	}
+	else if(format == C8P_F_VHT)
+	{
+		vhtSigABitsGen(sigBitsNL, sigBitsCodedNL, &m);
+		procIntelLegacyBpsk(&sigBitsCodedNL[0], &sigIntedNL[0]);
+		procIntelLegacyBpsk(&sigBitsCodedNL[48], &sigIntedNL[48]);
+		memset(bits0, 0, 8);
+		vhtSigB20BitsGenSU(sigBitsB0, sigBitsCodedB0, &bits0[8], &m);	// servcie bits sig b crc
+		procIntelVhtB20(sigBitsCodedB0, sigIntedB0);
+		// legacy training 16, legacy sig 4, vhtsiga 8, vht training 4+4n, vhtsigb, payload, no short GI
+		int tmpTxTime = 20 + 8 + 4 + m.nLTF * 4 + 4 + m.nSym * 4;
+		int tmpLegacyLen = ((tmpTxTime - 20) / 4 + (((tmpTxTime - 20) % 4) != 0)) * 3 - 3;
+		legacySigBitsGen(sigBitsL, sigBitsCodedL, 0, tmpLegacyLen);
+		procIntelLegacyBpsk(sigBitsCodedL, sigIntedL);
+	}
+	else
+	{
+		htSigBitsGen(sigBitsNL, sigBitsCodedNL, &m);
+		procIntelLegacyBpsk(&sigBitsCodedNL[0], &sigIntedNL[0]);
+		procIntelLegacyBpsk(&sigBitsCodedNL[48], &sigIntedNL[48]);
+		// legacy training and sig 20, htsig 8, ht training 4+4n, payload, no short GI
+		int tmpTxTime = 20 + 8 + 4 + m.nLTF * 4 + m.nSym * 4;
+		int tmpLegacyLen = ((tmpTxTime - 20) / 4 + (((tmpTxTime - 20) % 4) != 0)) * 3 - 3;
+		legacySigBitsGen(sigBitsL, sigBitsCodedL, 0, tmpLegacyLen);
+		procIntelLegacyBpsk(sigBitsCodedL, sigIntedL);
+		memset(bits0, 0, 16);	// service bits
+	}
+
+	// psdu
+	if(m.len > 0)
+	{
+		int tmpDataP = 16;
+		for(int i=0;i<m.len;i++)
+		{
+			for(int j=0;j<8;j++)
+			{
+				bits0[tmpDataP] = (psdu[i] >> j) & 0x01;
+				tmpDataP++;
+			}
+		}
+		if(m.format == C8P_F_VHT)
+		{
+			int tmpPsduLen = (m.nSym * m.nDBPS - 16 - 6) / 8;	// 20M 2x2, nES is still 1
+			for(int i=0;i<((tmpPsduLen - m.len)/4);i++)
+			{
+				memcpy(&bits0[tmpDataP], EOF_PAD_SUBFRAME, sizeof(uint8_t) * 32);	// eof padding
+				tmpDataP += 32;
+			}
+			memset(&bits0[tmpDataP], 0, ((tmpPsduLen - m.len)%4) * 8 * sizeof(uint8_t));	// padding octets
+			tmpDataP += (((tmpPsduLen - m.len)%4) * 8);
+			memset(&bits0[tmpDataP], 0, (m.nSym * m.nDBPS - tmpPsduLen*8 - 16));	// padding bits and tail
+			scramEncoder2(bits0, (m.nSym * m.nDBPS - 6), 93);	// scrambling
+		}
+		else
+		{
+			memset(&bits0[tmpDataP], 0, 6);	// legacy and ht tail
+			tmpDataP += 6;
+			memset(&bits0[tmpDataP], 0, (m.nSym * m.nDBPS - 22 - m.len*8));	// legacy and ht pad
+			scramEncoder2(bits0, (m.nSym * m.nDBPS), 93);
+			memset(&bits0[m.len * 8 + 16], 0, 6);
+		}
+		bccEncoder(bits0, bitsCoded, m.nSym * m.nDBPS);	// binary convolutional coding
+		punctEncoder(bitsCoded, bitsPunct, m.nSym * m.nDBPS * 2, &m);	// puncturing
+		if(m.nSS == 1)
+		{
+			if(m.format == C8P_F_L)
+			{
+				for(int i=0;i<m.nSym;i++)
+				{
+					procSymIntelL2(&bitsPunct[i*m.nCBPS], &bitsInted0[i*m.nCBPS], &m);
+				}
+			}
+			else
+			{
+				for(int i=0;i<m.nSym;i++)
+				{
+					procSymIntelNL2SS1(&bitsPunct[i*m.nCBPS], &bitsInted0[i*m.nCBPS], &m);
+				}
+			}
+			bitsToChips(bitsInted0, chips0, &m);
+		}
+		else
+		{
+			// stream parser first
+			streamParser2(bitsPunct, bitsStream0, bitsStream1, m.nSym * m.nCBPS, &m);
+			// interleave
+			for(int i=0;i<m.nSym;i++)
+			{
+				procSymIntelNL2SS1(&bitsStream0[i*m.nCBPSS], &bitsInted0[i*m.nCBPSS], &m);
+				procSymIntelNL2SS2(&bitsStream1[i*m.nCBPSS], &bitsInted1[i*m.nCBPSS], &m);
+			}
+			bitsToChips(bitsInted0, chips0, &m);
+			bitsToChips(bitsInted1, chips1, &m);
+		}
+	}
+}
+
+c8pTxModulator::c8pTxModulator()
+{
+	// prepare training fields
+	gr_complex tmpSig[64];
+	memset((uint8_t*)sigl, 0, sizeof(gr_complex) * 64);
+	memset((uint8_t*)signl, 0, sizeof(gr_complex) * 384);
+	memset((uint8_t*)signl0, 0, sizeof(gr_complex) * 448);
+	memset((uint8_t*)signl1, 0, sizeof(gr_complex) * 448);
+	memset((uint8_t*)signl1vht, 0, sizeof(gr_complex) * 448);
+	// non legacy stf
+	memcpy(signl+192, C8P_STF_F, sizeof(gr_complex) * 64);
+	memcpy(signl0+192, C8P_STF_F, sizeof(gr_complex) * 64);
+	memcpy(tmpSig, C8P_STF_F, sizeof(gr_complex) * 64);
+	procCSD(tmpSig, -200);
+	memcpy(signl1+192, tmpSig, sizeof(gr_complex) * 64);
+	memcpy(signl1vht+192, tmpSig, sizeof(gr_complex) * 64);
+	// non legacy ltf
+	memcpy(signl+256, C8P_LTF_NL_F, sizeof(gr_complex) * 64);
+	memcpy(signl0+256, C8P_LTF_NL_F, sizeof(gr_complex) * 64);
+	memcpy(signl0+320, C8P_LTF_NL_F_N, sizeof(gr_complex) * 64);
+	memcpy(tmpSig, C8P_LTF_NL_F, sizeof(gr_complex) * 64);
+	procCSD(tmpSig, -400);
+	memcpy(signl1+256, tmpSig, sizeof(gr_complex) * 64);
+	memcpy(signl1+320, tmpSig, sizeof(gr_complex) * 64);
+	memcpy(signl1vht+256, tmpSig, sizeof(gr_complex) * 64);
+	memcpy(tmpSig, C8P_LTF_NL_F_VHT22, sizeof(gr_complex) * 64);
+	procCSD(tmpSig, -400);
+	memcpy(signl1vht+320, tmpSig, sizeof(gr_complex) * 64);
+	gr_complex tmpPilotL[4] = {gr_complex(1.0f, 0.0f), gr_complex(1.0f, 0.0f), gr_complex(1.0f, 0.0f), gr_complex(-1.0f, 0.0f)};
+	gr_complex tmpPilotNL[4] = {gr_complex(1.0f, 0.0f), gr_complex(1.0f, 0.0f), gr_complex(1.0f, 0.0f), gr_complex(-1.0f, 0.0f)};
+	gr_complex tmpPilotHT20[4] = {gr_complex(1.0f, 0.0f), gr_complex(1.0f, 0.0f), gr_complex(-1.0f, 0.0f), gr_complex(-1.0f, 0.0f)};
+	gr_complex tmpPilotHT21[4] = {gr_complex(1.0f, 0.0f), gr_complex(-1.0f, 0.0f), gr_complex(-1.0f, 0.0f), gr_complex(1.0f, 0.0f)};
+	for(int i=0;i<C8P_TX_PILOT_MAX;i++)
+	{
+		for(int j=0;j<4;j++)
+		{
+			pilotsL[i][j] = tmpPilotL[j] * PILOT_P[(i+1)%127];
+			pilotsHT[i][j] = tmpPilotNL[j] * PILOT_P[(i+3)%127];
+			pilotsVHT[i][j] = tmpPilotNL[j] * PILOT_P[(i+4)%127];
+			pilotsHT20[i][j] = tmpPilotHT20[j] * PILOT_P[(i+3)%127];
+			pilotsHT21[i][j] = tmpPilotHT21[j] * PILOT_P[(i+3)%127];
+		}
+		gr_complex tmpPilot;
+		tmpPilot = tmpPilotNL[0];
+		tmpPilotNL[0] = tmpPilotNL[1];
+		tmpPilotNL[1] = tmpPilotNL[2];
+		tmpPilotNL[2] = tmpPilotNL[3];
+		tmpPilotNL[3] = tmpPilot;
+		tmpPilot = tmpPilotHT20[0];
+		tmpPilotHT20[0] = tmpPilotHT20[1];
+		tmpPilotHT20[1] = tmpPilotHT20[2];
+		tmpPilotHT20[2] = tmpPilotHT20[3];
+		tmpPilotHT20[3] = tmpPilot;
+		tmpPilot = tmpPilotHT21[0];
+		tmpPilotHT21[0] = tmpPilotHT21[1];
+		tmpPilotHT21[1] = tmpPilotHT21[2];
+		tmpPilotHT21[2] = tmpPilotHT21[3];
+		tmpPilotHT21[3] = tmpPilot;
+	}
+}
+
+int c8pTxModulator::sig(const c8p_mod* m, const uint8_t* sigL, const uint8_t* sigNL, const uint8_t* sigB0, const gr_complex** sig0, const gr_complex** sig1)
+{
+	gr_complex tmpSigPilots[4] = {gr_complex(1.0f, 0.0f), gr_complex(1.0f, 0.0f), gr_complex(1.0f, 0.0f), gr_complex(-1.0f, 0.0f)};
+	if(m->format == C8P_F_VHT)
+	{
+		if(m->nSS == 2)
+		{
+			procChipsToQamNonShiftedScL(&sigL[0], signl0, C8P_QAM_BPSK);
+			procChipsToQamNonShiftedScL(&sigNL[0], signl0+64, C8P_QAM_BPSK);
+			procChipsToQamNonShiftedScL(&sigNL[48], signl0+128, C8P_QAM_QBPSK);
+			procChipsToQamNonShiftedScNL(&sigB0[0], signl0+384, C8P_QAM_BPSK);
+			procInsertPilots(signl0, tmpSigPilots);
+			procInsertPilots(signl0+64, tmpSigPilots);
+			procInsertPilots(signl0+128, tmpSigPilots);
+			procInsertPilots(signl0+384, tmpSigPilots);
+			memcpy((uint8_t*)signl1vht, (uint8_t*)signl0, sizeof(gr_complex)*192);
+			memcpy((uint8_t*)(signl1vht+384), (uint8_t*)(signl0+384), sizeof(gr_complex)*64);
+			procCSD(signl1vht, -200);
+			procCSD(signl1vht+64, -200);
+			procCSD(signl1vht+128, -200);
+			procCSD(signl1vht+384, -400);
+			*sig0 = signl0;
+			*sig1 = signl1vht;
+			return 448;
+		}
+		procChipsToQamNonShiftedScL(&sigL[0], signl, C8P_QAM_BPSK);
+		procChipsToQamNonShiftedScL(&sigNL[0], signl+64, C8P_QAM_BPSK);
+		procChipsToQamNonShiftedScL(&sigNL[48], signl+128, C8P_QAM_QBPSK);
+		procChipsToQamNonShiftedScNL(&sigB0[0], signl+320, C8P_QAM_BPSK);
+		procInsertPilots(signl, tmpSigPilots);
+		procInsertPilots(signl+64, tmpSigPilots);
+		procInsertPilots(signl+128, tmpSigPilots);
+		procInsertPilots(signl+320, tmpSigPilots);
+		*sig0 = signl;
+		*sig1 = nullptr;
+		return 384;
+	}
+	else if(m->format == C8P_F_HT)
+	{
+		if(m->nSS == 2)
+		{
+			procChipsToQamNonShiftedScL(&sigL[0], signl0, C8P_QAM_BPSK);
+			procChipsToQamNonShiftedScL(&sigNL[0], signl0+64, C8P_QAM_QBPSK);
+			procChipsToQamNonShiftedScL(&sigNL[48], signl0+128, C8P_QAM_QBPSK);
+			procInsertPilots(signl0, tmpSigPilots);
+			procInsertPilots(signl0+64, tmpSigPilots);
+			procInsertPilots(signl0+128, tmpSigPilots);
+			memcpy((uint8_t*)signl1, (uint8_t*)signl0, sizeof(gr_complex)*192);
+			procCSD(signl1, -200);
+			procCSD(signl1+64, -200);
+			procCSD(signl1+128, -200);
+			*sig0 = signl0;
+			*sig1 = signl1;
+			return 384;
+		}
+		procChipsToQamNonShiftedScL(&sigL[0], signl, C8P_QAM_BPSK);
+		procChipsToQamNonShiftedScL(&sigNL[0], signl+64, C8P_QAM_QBPSK);
+		procChipsToQamNonShiftedScL(&sigNL[48], signl+128, C8P_QAM_QBPSK);
+		procInsertPilots(signl, tmpSigPilots);
+		procInsertPilots(signl+64, tmpSigPilots);
+		procInsertPilots(signl+128, tmpSigPilots);
+		*sig0 = signl;
+		*sig1 = nullptr;
+		return 320;
+	}
+	procChipsToQamNonShiftedScL(&sigL[0], sigl, C8P_QAM_BPSK);
+	procInsertPilots(sigl, tmpSigPilots);
+	*sig0 = sigl;
+	*sig1 = nullptr;
+	return 64;
+}
+
+void c8pTxModulator::sym(const c8p_mod* m, const uint8_t* chips0, const uint8_t* chips1, int iSym, gr_complex* out0, gr_complex* out1)
+{
+	if(m->format == C8P_F_L)
+	{
+		procChipsToQamNonShiftedScL(chips0, out0, m->mod);
+		procInsertPilots(out0, pilotsL[iSym]);
+		memset((uint8_t*)out0, 0, sizeof(gr_complex) * 6);
+		memset((uint8_t*)(out0 + 59), 0, sizeof(gr_complex) * 5);
+	}
+	else if(m->format == C8P_F_VHT)
+	{
+		procChipsToQamNonShiftedScNL(chips0, out0, m->mod);
+		procInsertPilots(out0, pilotsVHT[iSym]);
+		if(m->nSS == 2)
+		{
+			procChipsToQamNonShiftedScNL(chips1, out1, m->mod);
+			procInsertPilots(out1, pilotsVHT[iSym]);
+			procCSD(out1, -400);
+		}
+	}
+	else
+	{
+		procChipsToQamNonShiftedScNL(chips0, out0, m->mod);
+		if(m->nSS == 2)
+		{
+			procChipsToQamNonShiftedScNL(chips1, out1, m->mod);
+			procInsertPilots(out0, pilotsHT20[iSym]);
+			procInsertPilots(out1, pilotsHT21[iSym]);
+			procCSD(out1, -400);
+		}
+		else
+		{
+			procInsertPilots(out0, pilotsHT[iSym]);
+		}
+	}
+}
+
+c8pTxPad::c8pTxPad()
+{
+	gr::fft::fft_complex_rev tmpFft(64, 1);
+	for(int i=0;i<240;i++)
+	{
+		scaleMask[i] = 1.0f / sqrtf(52.0f) / C8P_TX_SCALE;
+	}
+	for(int i=240;i<320;i++)
+	{
+		scaleMask[i] = 1.0f / sqrtf(12.0f) / C8P_TX_SCALE;
+	}
+	memset((uint8_t*)pre0, 0, sizeof(gr_complex)*80);
+	memset((uint8_t*)pre1, 0, sizeof(gr_complex)*80);
+	memcpy(tmpFft.get_inbuf(), &C8P_STF_F[32], sizeof(gr_complex)*32);
+	memcpy(tmpFft.get_inbuf()+32, &C8P_STF_F[0], sizeof(gr_complex)*32);
+	tmpFft.execute();
+	memcpy(pre0+80, tmpFft.get_outbuf()+32, sizeof(gr_complex)*32);
+	memcpy(pre0+112, tmpFft.get_outbuf(), sizeof(gr_complex)*64);
+	memcpy(pre0+176, tmpFft.get_outbuf(), sizeof(gr_complex)*64);
+	procCSD(tmpFft.get_inbuf(), -200);
+	tmpFft.execute();
+	memcpy(pre1+80, tmpFft.get_outbuf()+32, sizeof(gr_complex)*32);
+	memcpy(pre1+112, tmpFft.get_outbuf(), sizeof(gr_complex)*64);
+	memcpy(pre1+176, tmpFft.get_outbuf(), sizeof(gr_complex)*64);
+	memcpy(tmpFft.get_inbuf(), &C8P_LTF_L_F[32], sizeof(gr_complex)*32);
+	memcpy(tmpFft.get_inbuf()+32, &C8P_LTF_L_F[0], sizeof(gr_complex)*32);
+	tmpFft.execute();
+	memcpy(pre0+240, tmpFft.get_outbuf()+32, sizeof(gr_complex)*32);
+	memcpy(pre0+272, tmpFft.get_outbuf(), sizeof(gr_complex)*64);
+	memcpy(pre0+336, tmpFft.get_outbuf(), sizeof(gr_complex)*64);
+	procCSD(tmpFft.get_inbuf(), -200);
+	tmpFft.execute();
+	memcpy(pre1+240, tmpFft.get_outbuf()+32, sizeof(gr_complex)*32);
+	memcpy(pre1+272, tmpFft.get_outbuf(), sizeof(gr_complex)*64);
+	memcpy(pre1+336, tmpFft.get_outbuf(), sizeof(gr_complex)*64);
+	pre0[80] *= 0.5f;
+	pre0[239] *= 0.5f;
+	pre0[240] *= 0.5f;
+	pre0[399] *= 0.5f;
+	pre1[80] *= 0.5f;
+	pre1[239] *= 0.5f;
+	pre1[240] *= 0.5f;
+	pre1[399] *= 0.5f;
+	for(int i=80;i<240;i++)
+	{
+		pre0[i] = pre0[i] / sqrtf(12.0f) / C8P_TX_SCALE;
+		pre1[i] = pre1[i] / sqrtf(12.0f) / C8P_TX_SCALE;
+	}
+	for(int i=240;i<400;i++)
+	{
+		pre0[i] = pre0[i] / sqrtf(52.0f) / C8P_TX_SCALE;
+		pre1[i] = pre1[i] / sqrtf(52.0f) / C8P_TX_SCALE;
+	}
+}
+
+int c8pTxPad::sigSamp(int format)
+{
+	// legacy signal, or up to the end of the non-legacy stf, in scaleMask
+	if(format == C8P_F_L)
+	{
+		return 80;
+	}
+	return 320;
+}
+
+float c8pTxPad::dataScale(int format)
+{
+	if(format == C8P_F_L)
+	{
+		return 1.0f / sqrt(52.0f) / C8P_TX_SCALE;
+	}
+	return 1.0f / sqrt(56.0f) / C8P_TX_SCALE;
+}
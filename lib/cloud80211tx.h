@@ -0,0 +1,111 @@
+/*
+ *
+ *     GNU Radio IEEE 802.11a/g/n/ac 20M bw and upto 2x2
+ *     Per packet transmitter stages, shared by the blocks and phy::Transmitter
+ *     Copyright (C) June 1, 2022  Zelin Yun
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU Affero General Public License as published
+ *     by the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU Affero General Public License for more details.
+ *
+ *     You should have received a copy of the GNU Affero General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_CLOUD80211TX_H
+#define INCLUDED_CLOUD80211TX_H
+
+#include "cloud80211phy.h"
+
+#define C8P_TX_CHIPS_MAX 65728		// chips of the longest packet and the gap after it
+#define C8P_TX_PILOT_MAX 1408		// pilot polarities of the data symbols
+#define C8P_TX_PAD_SYM 2		// zero symbols after the data
+#define C8P_TX_PRE_SAMP 400		// zeros, L-STF and L-LTF before the legacy signal
+#define C8P_TX_SCALE 5.333333f
+
+/*
+ * Bits of one single user packet, as encode2. run takes the psdu, for vht
+ * the A-MPDU with its delimiters, and gives the interleaved bits of the
+ * legacy signal, the ht sig or vht sig a and the vht sig b, and the chips
+ * of each spatial stream, nSym * nSD each in the symbol order.
+ */
+class c8pTxEncoder
+{
+	private:
+	uint8_t sigBitsL[24];
+	uint8_t sigBitsCodedL[48];
+	uint8_t sigBitsNL[48];
+	uint8_t sigBitsCodedNL[96];
+	uint8_t sigBitsB0[26];
+	uint8_t sigBitsCodedB0[52];
+	uint8_t bits0[C8P_TX_CHIPS_MAX];
+	uint8_t bitsCoded[C8P_TX_CHIPS_MAX];
+	uint8_t bitsPunct[C8P_TX_CHIPS_MAX];
+	uint8_t bitsStream0[C8P_TX_CHIPS_MAX];
+	uint8_t bitsStream1[C8P_TX_CHIPS_MAX];
+	uint8_t bitsInted0[C8P_TX_CHIPS_MAX];
+	uint8_t bitsInted1[C8P_TX_CHIPS_MAX];
+
+	public:
+	c8p_mod m;
+	uint8_t sigIntedL[48];
+	uint8_t sigIntedNL[96];
+	uint8_t sigIntedB0[52];
+	uint8_t chips0[C8P_TX_CHIPS_MAX];
+	uint8_t chips1[C8P_TX_CHIPS_MAX];
+
+	void run(int format, int mcs, int nss, const uint8_t* psdu, int len);
+};
+
+/*
+ * Frequency domain symbols of one single user packet, as modulation2, 64
+ * bins with dc at 32. sig maps the signal fields into the templates of
+ * the non-legacy training fields and points sig0 and sig1 at the symbols of
+ * each antenna up to the data, it returns their number of bins. sym maps
+ * the nSD chips of each stream of data symbol iSym. The second antenna
+ * is cyclic shifted, only used with 2 streams.
+ */
+class c8pTxModulator
+{
+	public:
+	gr_complex sigl[64];		/* legacy */
+	gr_complex signl[384];		/* nl siso */
+	gr_complex signl0[448];		/* nl 2x2 */
+	gr_complex signl1[448];
+	gr_complex signl1vht[448];
+	gr_complex pilotsL[C8P_TX_PILOT_MAX][4];
+	gr_complex pilotsVHT[C8P_TX_PILOT_MAX][4];
+	gr_complex pilotsHT[C8P_TX_PILOT_MAX][4];
+	gr_complex pilotsHT20[C8P_TX_PILOT_MAX][4];
+	gr_complex pilotsHT21[C8P_TX_PILOT_MAX][4];
+
+	c8pTxModulator();
+	int sig(const c8p_mod* m, const uint8_t* sigL, const uint8_t* sigNL, const uint8_t* sigB0, const gr_complex** sig0, const gr_complex** sig1);
+	void sym(const c8p_mod* m, const uint8_t* chips0, const uint8_t* chips1, int iSym, gr_complex* out0, gr_complex* out1);
+};
+
+/*
+ * Legacy preamble and scaling of pad2. pre0 and pre1 are the samples before
+ * the legacy signal of each antenna, 80 zeros, the L-STF and the L-LTF, the
+ * ones of antenna 1 cyclic shifted. The signal fields after it are scaled
+ * by scaleMask, the rest of the packet by dataScale of its format.
+ */
+class c8pTxPad
+{
+	public:
+	gr_complex pre0[C8P_TX_PRE_SAMP];
+	gr_complex pre1[C8P_TX_PRE_SAMP];
+	float scaleMask[320];
+
+	c8pTxPad();
+	static int sigSamp(int format);
+	static float dataScale(int format);
+};
+
+#endif /* INCLUDED_CLOUD80211TX_H */
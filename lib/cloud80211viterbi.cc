@@ -0,0 +1,759 @@
+/*
+ *
+ *     GNU Radio IEEE 802.11a/g/n/ac 20M bw and upto 2x2
+ *     Viterbi ACS kernels and soft decoder of the data field
+ *     Copyright (C) June 1, 2022  Zelin Yun
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU Affero General Public License as published
+ *     by the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU Affero General Public License for more details.
+ *
+ *     You should have received a copy of the GNU Affero General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "cloud80211viterbi.h"
+#include "cloud80211phy.h"
+#include <algorithm>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SV_ACS_X86 1
+#include <immintrin.h>
+#endif
+
+/*
+ * Butterfly j joins predecessors 2j and 2j+1 into states j and j+32. Both
+ * generators tap the newest and the oldest register, so the outputs of 2j+1
+ * are the complement of 2j and the b=1 outputs the complement of b=0. Only
+ * the two bits of SV_STATE_OUTPUT[2j][0] are needed: X = c0*t0 + c1*t1 is
+ * the metric of 2j->j and 2j+1->j+32, Y = !c0*t0 + !c1*t1 of 2j+1->j and
+ * 2j->j+32.
+ */
+struct svAcsTable
+{
+	uint32_t x0[32];
+	uint32_t x1[32];
+	uint32_t y0[32];
+	uint32_t y1[32];
+	float fx0[32];
+	float fx1[32];
+	float fy0[32];
+	float fy1[32];
+	int16_t hx0[32];
+	int16_t hx1[32];
+
+	svAcsTable()
+	{
+		for(int j=0;j<32;j++)
+		{
+			int c = SV_STATE_OUTPUT[j*2][0];
+			x0[j] = (c & 2) ? 0xffffffffu : 0u;
+			x1[j] = (c & 1) ? 0xffffffffu : 0u;
+			y0[j] = ~x0[j];
+			y1[j] = ~x1[j];
+			fx0[j] = (c & 2) ? 1.0f : 0.0f;
+			fx1[j] = (c & 1) ? 1.0f : 0.0f;
+			fy0[j] = 1.0f - fx0[j];
+			fy1[j] = 1.0f - fx1[j];
+			hx0[j] = (c & 2) ? -1 : 0;
+			hx1[j] = (c & 1) ? -1 : 0;
+		}
+	}
+};
+
+static const svAcsTable& svAcsTab()
+{
+	static const svAcsTable tab;
+	return tab;
+}
+
+/*
+ * Scrambler sequence of each state taken after the 7 service bits, packed
+ * lsb first from bit 0 of the psdu. 8 periods of 127 bits are 127 bytes,
+ * 7 more bytes let 8 bytes be read from any position.
+ */
+struct svScramTable
+{
+	uint8_t seq[128][127 + 7];
+
+	svScramTable()
+	{
+		for(int s=0;s<128;s++)
+		{
+			for(int k=0;k<127+7;k++)
+			{
+				seq[s][k] = 0;
+				for(int b=0;b<8;b++)
+				{
+					seq[s][k] |= C8P_SCRAMBLE_SEQ[s][((k % 127) * 8 + b + 120) % 127] << b;
+				}
+			}
+		}
+	}
+};
+
+static const svScramTable& svScramTab()
+{
+	static const svScramTable tab;
+	return tab;
+}
+
+static void svAcsRunScalar(const float* bm, int nStep, float* pm, uint64_t* dec)
+{
+	const svAcsTable& tab = svAcsTab();
+	float tmpPm[64];
+	uint32_t tmpDec[64];
+	for(int t=0;t<nStep;t++)
+	{
+		float t0 = bm[t*2];
+		float t1 = bm[t*2+1];
+		// branch free so that the compiler can still use the baseline simd
+		for(int j=0;j<32;j++)
+		{
+			float x = tab.fx0[j] * t0 + tab.fx1[j] * t1;
+			float y = tab.fy0[j] * t0 + tab.fy1[j] * t1;
+			float e = pm[j*2];
+			float o = pm[j*2+1];
+			float m0 = e + x;
+			float m1 = o + y;
+			tmpDec[j] = m1 > m0;
+			tmpPm[j] = m1 > m0 ? m1 : m0;
+			m0 = e + y;
+			m1 = o + x;
+			tmpDec[j+32] = m1 > m0;
+			tmpPm[j+32] = m1 > m0 ? m1 : m0;
+		}
+		uint64_t tmpWord = 0;
+		for(int n=0;n<64;n++)
+		{
+			tmpWord |= (uint64_t)tmpDec[n] << n;
+		}
+		memcpy(pm, tmpPm, sizeof(float)*64);
+		dec[t] = tmpWord;
+	}
+}
+
+static void svAcsRunScalarI16(const int16_t* bm, int nStep, int16_t* pm, uint64_t* dec)
+{
+	const svAcsTable& tab = svAcsTab();
+	int16_t tmpPm[64];
+	uint32_t tmpDec[64];
+	for(int t=0;t<nStep;t++)
+	{
+		int16_t t0 = bm[t*2];
+		int16_t t1 = bm[t*2+1];
+		for(int j=0;j<32;j++)
+		{
+			int16_t x = (int16_t)((tab.hx0[j] & t0) + (tab.hx1[j] & t1));
+			int16_t y = (int16_t)((~tab.hx0[j] & t0) + (~tab.hx1[j] & t1));
+			int16_t e = pm[j*2];
+			int16_t o = pm[j*2+1];
+			int16_t m0 = (int16_t)(e + x);
+			int16_t m1 = (int16_t)(o + y);
+			tmpDec[j] = (int16_t)(m1 - m0) > 0;
+			tmpPm[j] = tmpDec[j] ? m1 : m0;
+			m0 = (int16_t)(e + y);
+			m1 = (int16_t)(o + x);
+			tmpDec[j+32] = (int16_t)(m1 - m0) > 0;
+			tmpPm[j+32] = tmpDec[j+32] ? m1 : m0;
+		}
+		uint64_t tmpWord = 0;
+		for(int n=0;n<64;n++)
+		{
+			tmpWord |= (uint64_t)tmpDec[n] << n;
+		}
+		memcpy(pm, tmpPm, sizeof(int16_t)*64);
+		dec[t] = tmpWord;
+	}
+}
+
+#ifdef SV_ACS_X86
+
+__attribute__((target("avx2")))
+static void svAcsRunAvx2(const float* bm, int nStep, float* pm, uint64_t* dec)
+{
+	const svAcsTable& tab = svAcsTab();
+	__m256 x0[4], x1[4], y0[4], y1[4], m[8];
+	for(int k=0;k<4;k++)
+	{
+		x0[k] = _mm256_castsi256_ps(_mm256_loadu_si256((const __m256i*)&tab.x0[k*8]));
+		x1[k] = _mm256_castsi256_ps(_mm256_loadu_si256((const __m256i*)&tab.x1[k*8]));
+		y0[k] = _mm256_castsi256_ps(_mm256_loadu_si256((const __m256i*)&tab.y0[k*8]));
+		y1[k] = _mm256_castsi256_ps(_mm256_loadu_si256((const __m256i*)&tab.y1[k*8]));
+	}
+	for(int r=0;r<8;r++)
+	{
+		m[r] = _mm256_loadu_ps(&pm[r*8]);
+	}
+	for(int t=0;t<nStep;t++)
+	{
+		__m256 t0 = _mm256_set1_ps(bm[t*2]);
+		__m256 t1 = _mm256_set1_ps(bm[t*2+1]);
+		__m256 e[4], o[4];
+		for(int k=0;k<4;k++)
+		{
+			// even and odd predecessors of states 8k to 8k+7
+			__m256 a = m[k*2];
+			__m256 b = m[k*2+1];
+			e[k] = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(a, b, 0x88)), 0xd8));
+			o[k] = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(a, b, 0xdd)), 0xd8));
+		}
+		uint64_t tmpDec = 0;
+		for(int k=0;k<4;k++)
+		{
+			__m256 x = _mm256_add_ps(_mm256_and_ps(x0[k], t0), _mm256_and_ps(x1[k], t1));
+			__m256 y = _mm256_add_ps(_mm256_and_ps(y0[k], t0), _mm256_and_ps(y1[k], t1));
+			__m256 m0 = _mm256_add_ps(e[k], x);
+			__m256 m1 = _mm256_add_ps(o[k], y);
+			__m256 d = _mm256_cmp_ps(m1, m0, _CMP_GT_OQ);
+			m[k] = _mm256_blendv_ps(m0, m1, d);
+			tmpDec |= (uint64_t)_mm256_movemask_ps(d) << (k*8);
+			m0 = _mm256_add_ps(e[k], y);
+			m1 = _mm256_add_ps(o[k], x);
+			d = _mm256_cmp_ps(m1, m0, _CMP_GT_OQ);
+			m[k+4] = _mm256_blendv_ps(m0, m1, d);
+			tmpDec |= (uint64_t)_mm256_movemask_ps(d) << (k*8+32);
+		}
+		dec[t] = tmpDec;
+	}
+	for(int r=0;r<8;r++)
+	{
+		_mm256_storeu_ps(&pm[r*8], m[r]);
+	}
+}
+
+__attribute__((target("avx512f")))
+static void svAcsRunAvx512(const float* bm, int nStep, float* pm, uint64_t* dec)
+{
+	const svAcsTable& tab = svAcsTab();
+	const __m512i idxE = _mm512_set_epi32(30, 28, 26, 24, 22, 20, 18, 16, 14, 12, 10, 8, 6, 4, 2, 0);
+	const __m512i idxO = _mm512_set_epi32(31, 29, 27, 25, 23, 21, 19, 17, 15, 13, 11, 9, 7, 5, 3, 1);
+	__mmask16 x0[2], x1[2];
+	__m512 m[4];
+	for(int k=0;k<2;k++)
+	{
+		x0[k] = 0;
+		x1[k] = 0;
+		for(int j=0;j<16;j++)
+		{
+			x0[k] |= (tab.x0[k*16+j] & 1) << j;
+			x1[k] |= (tab.x1[k*16+j] & 1) << j;
+		}
+	}
+	for(int r=0;r<4;r++)
+	{
+		m[r] = _mm512_loadu_ps(&pm[r*16]);
+	}
+	for(int t=0;t<nStep;t++)
+	{
+		__m512 t0 = _mm512_set1_ps(bm[t*2]);
+		__m512 t1 = _mm512_set1_ps(bm[t*2+1]);
+		__m512 e[2], o[2];
+		for(int k=0;k<2;k++)
+		{
+			e[k] = _mm512_permutex2var_ps(m[k*2], idxE, m[k*2+1]);
+			o[k] = _mm512_permutex2var_ps(m[k*2], idxO, m[k*2+1]);
+		}
+		uint64_t tmpDec = 0;
+		for(int k=0;k<2;k++)
+		{
+			__m512 x = _mm512_add_ps(_mm512_maskz_mov_ps(x0[k], t0), _mm512_maskz_mov_ps(x1[k], t1));
+			__m512 y = _mm512_add_ps(_mm512_maskz_mov_ps((__mmask16)~x0[k], t0), _mm512_maskz_mov_ps((__mmask16)~x1[k], t1));
+			__m512 m0 = _mm512_add_ps(e[k], x);
+			__m512 m1 = _mm512_add_ps(o[k], y);
+			__mmask16 d = _mm512_cmp_ps_mask(m1, m0, _CMP_GT_OQ);
+			m[k] = _mm512_mask_blend_ps(d, m0, m1);
+			tmpDec |= (uint64_t)d << (k*16);
+			m0 = _mm512_add_ps(e[k], y);
+			m1 = _mm512_add_ps(o[k], x);
+			d = _mm512_cmp_ps_mask(m1, m0, _CMP_GT_OQ);
+			m[k+2] = _mm512_mask_blend_ps(d, m0, m1);
+			tmpDec |= (uint64_t)d << (k*16+32);
+		}
+		dec[t] = tmpDec;
+	}
+	for(int r=0;r<4;r++)
+	{
+		_mm512_storeu_ps(&pm[r*16], m[r]);
+	}
+}
+
+__attribute__((target("avx2")))
+static void svAcsRunAvx2I16(const int16_t* bm, int nStep, int16_t* pm, uint64_t* dec)
+{
+	const svAcsTable& tab = svAcsTab();
+	// evens of each 128 bit lane to its low half, odds to its high half
+	const __m256i split = _mm256_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15,
+		0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15);
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i x0[2], x1[2], m[4];
+	for(int k=0;k<2;k++)
+	{
+		x0[k] = _mm256_loadu_si256((const __m256i*)&tab.hx0[k*16]);
+		x1[k] = _mm256_loadu_si256((const __m256i*)&tab.hx1[k*16]);
+	}
+	for(int r=0;r<4;r++)
+	{
+		m[r] = _mm256_loadu_si256((const __m256i*)&pm[r*16]);
+	}
+	for(int t=0;t<nStep;t++)
+	{
+		__m256i t0 = _mm256_set1_epi16(bm[t*2]);
+		__m256i t1 = _mm256_set1_epi16(bm[t*2+1]);
+		__m256i e[2], o[2];
+		for(int k=0;k<2;k++)
+		{
+			// even and odd predecessors of states 16k to 16k+15
+			__m256i a = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(m[k*2], split), 0xd8);
+			__m256i b = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(m[k*2+1], split), 0xd8);
+			e[k] = _mm256_permute2x128_si256(a, b, 0x20);
+			o[k] = _mm256_permute2x128_si256(a, b, 0x31);
+		}
+		uint64_t tmpDec = 0;
+		for(int k=0;k<2;k++)
+		{
+			__m256i x = _mm256_add_epi16(_mm256_and_si256(x0[k], t0), _mm256_and_si256(x1[k], t1));
+			__m256i y = _mm256_add_epi16(_mm256_andnot_si256(x0[k], t0), _mm256_andnot_si256(x1[k], t1));
+			__m256i m0 = _mm256_add_epi16(e[k], x);
+			__m256i m1 = _mm256_add_epi16(o[k], y);
+			__m256i dA = _mm256_cmpgt_epi16(_mm256_sub_epi16(m1, m0), zero);
+			m[k] = _mm256_blendv_epi8(m0, m1, dA);
+			m0 = _mm256_add_epi16(e[k], y);
+			m1 = _mm256_add_epi16(o[k], x);
+			__m256i dB = _mm256_cmpgt_epi16(_mm256_sub_epi16(m1, m0), zero);
+			m[k+2] = _mm256_blendv_epi8(m0, m1, dB);
+			uint32_t tmpBits = (uint32_t)_mm256_movemask_epi8(_mm256_permute4x64_epi64(_mm256_packs_epi16(dA, dB), 0xd8));
+			tmpDec |= (uint64_t)(tmpBits & 0xffff) << (k*16);
+			tmpDec |= (uint64_t)(tmpBits >> 16) << (k*16+32);
+		}
+		dec[t] = tmpDec;
+	}
+	for(int r=0;r<4;r++)
+	{
+		_mm256_storeu_si256((__m256i*)&pm[r*16], m[r]);
+	}
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static void svAcsRunAvx512I16(const int16_t* bm, int nStep, int16_t* pm, uint64_t* dec)
+{
+	const svAcsTable& tab = svAcsTab();
+	int16_t tmpIdx[64];
+	for(int j=0;j<32;j++)
+	{
+		tmpIdx[j] = j*2;
+		tmpIdx[j+32] = j*2+1;
+	}
+	const __m512i idxE = _mm512_loadu_si512(&tmpIdx[0]);
+	const __m512i idxO = _mm512_loadu_si512(&tmpIdx[32]);
+	const __m512i zero = _mm512_setzero_si512();
+	__mmask32 x0 = 0, x1 = 0;
+	for(int j=0;j<32;j++)
+	{
+		x0 |= (__mmask32)(tab.hx0[j] & 1) << j;
+		x1 |= (__mmask32)(tab.hx1[j] & 1) << j;
+	}
+	__m512i m[2];
+	m[0] = _mm512_loadu_si512(&pm[0]);
+	m[1] = _mm512_loadu_si512(&pm[32]);
+	for(int t=0;t<nStep;t++)
+	{
+		__m512i t0 = _mm512_set1_epi16(bm[t*2]);
+		__m512i t1 = _mm512_set1_epi16(bm[t*2+1]);
+		__m512i e = _mm512_permutex2var_epi16(m[0], idxE, m[1]);
+		__m512i o = _mm512_permutex2var_epi16(m[0], idxO, m[1]);
+		__m512i x = _mm512_add_epi16(_mm512_maskz_mov_epi16(x0, t0), _mm512_maskz_mov_epi16(x1, t1));
+		__m512i y = _mm512_add_epi16(_mm512_maskz_mov_epi16(~x0, t0), _mm512_maskz_mov_epi16(~x1, t1));
+		__m512i m0 = _mm512_add_epi16(e, x);
+		__m512i m1 = _mm512_add_epi16(o, y);
+		__mmask32 dA = _mm512_cmpgt_epi16_mask(_mm512_sub_epi16(m1, m0), zero);
+		m[0] = _mm512_mask_blend_epi16(dA, m0, m1);
+		m0 = _mm512_add_epi16(e, y);
+		m1 = _mm512_add_epi16(o, x);
+		__mmask32 dB = _mm512_cmpgt_epi16_mask(_mm512_sub_epi16(m1, m0), zero);
+		m[1] = _mm512_mask_blend_epi16(dB, m0, m1);
+		dec[t] = (uint64_t)dA | ((uint64_t)dB << 32);
+	}
+	_mm512_storeu_si512(&pm[0], m[0]);
+	_mm512_storeu_si512(&pm[32], m[1]);
+}
+
+#endif
+
+static int svAcsDetect()
+{
+#ifdef SV_ACS_X86
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx512f"))
+	{
+		return SV_ACS_AVX512;
+	}
+	if(__builtin_cpu_supports("avx2"))
+	{
+		return SV_ACS_AVX2;
+	}
+#endif
+	return SV_ACS_SCALAR;
+}
+
+int svAcsKernel()
+{
+	static const int kernel = svAcsDetect();
+	return kernel;
+}
+
+const char* svAcsKernelName(int kernel)
+{
+	switch(kernel)
+	{
+		case SV_ACS_AVX2:
+			return "avx2";
+		case SV_ACS_AVX512:
+			return "avx512";
+		default:
+			return "scalar";
+	}
+}
+
+void svAcsRunKernel(int kernel, const float* bm, int nStep, float* pm, uint64_t* dec)
+{
+	if(kernel > svAcsKernel())
+	{
+		kernel = svAcsKernel();
+	}
+	switch(kernel)
+	{
+#ifdef SV_ACS_X86
+		case SV_ACS_AVX512:
+			svAcsRunAvx512(bm, nStep, pm, dec);
+			return;
+		case SV_ACS_AVX2:
+			svAcsRunAvx2(bm, nStep, pm, dec);
+			return;
+#endif
+		default:
+			svAcsRunScalar(bm, nStep, pm, dec);
+			return;
+	}
+}
+
+void svAcsRun(const float* bm, int nStep, float* pm, uint64_t* dec)
+{
+	svAcsRunKernel(svAcsKernel(), bm, nStep, pm, dec);
+}
+
+static bool svAcsAvx512Bw()
+{
+#ifdef SV_ACS_X86
+	static const bool bw = __builtin_cpu_supports("avx512bw");
+	return bw;
+#else
+	return false;
+#endif
+}
+
+void svAcsRunKernelI16(int kernel, const int16_t* bm, int nStep, int16_t* pm, uint64_t* dec)
+{
+	if(kernel > svAcsKernel())
+	{
+		kernel = svAcsKernel();
+	}
+	if(kernel == SV_ACS_AVX512 && !svAcsAvx512Bw())
+	{
+		kernel = SV_ACS_AVX2;
+	}
+	switch(kernel)
+	{
+#ifdef SV_ACS_X86
+		case SV_ACS_AVX512:
+			svAcsRunAvx512I16(bm, nStep, pm, dec);
+			return;
+		case SV_ACS_AVX2:
+			svAcsRunAvx2I16(bm, nStep, pm, dec);
+			return;
+#endif
+		default:
+			svAcsRunScalarI16(bm, nStep, pm, dec);
+			return;
+	}
+}
+
+void svAcsRunI16(const int16_t* bm, int nStep, int16_t* pm, uint64_t* dec)
+{
+	svAcsRunKernelI16(svAcsKernel(), bm, nStep, pm, dec);
+}
+
+void svDataDecoder::init(int trellisLen, int cr)
+{
+	for(int i=0;i<SV_N_STATE;i++)
+	{
+		pm[i] = SV_METRIC_INIT;
+		pmI[i] = SV_METRIC_INIT_I16;
+	}
+	pm[0] = 0;
+	pmI[0] = 0;
+	fixedPoint = false;
+	trellis = trellisLen;
+	memset(scramBytes, 0, (trellisLen + 7) / 8);
+	t = 0;
+	tbDone = 0;
+	dsDone = 0;
+	dsState = 0;
+	puncP = 0;
+	switch(cr)
+	{
+		case C8P_CR_23:
+			puncLen = 4;
+			punc = SV_PUNC_23;
+			break;
+		case C8P_CR_34:
+			puncLen = 6;
+			punc = SV_PUNC_34;
+			break;
+		case C8P_CR_56:
+			puncLen = 10;
+			punc = SV_PUNC_56;
+			break;
+		default:
+			puncLen = 2;
+			punc = SV_PUNC_12;
+			break;
+	}
+	puncUsed = 0;
+	for(int i=0;i<puncLen;i++)
+	{
+		puncKeep[i] = punc[i];
+		puncSrc[i] = punc[i] ? puncUsed : 0;
+		puncUsed += punc[i];
+	}
+}
+
+void svDataDecoder::initSegment(int cr, int warm, int begin, int last)
+{
+	init(last, cr);
+	if(warm > 0)
+	{
+		// state at the start of the segment is unknown
+		for(int i=0;i<SV_N_STATE;i++)
+		{
+			pm[i] = 0.0f;
+			pmI[i] = 0;
+		}
+	}
+	t = warm;
+	tbDone = begin;
+	puncP = (warm % (puncLen / 2)) * 2;
+}
+
+svSegment svSegmentSplit(int trellis, int seg, int nSeg, int overlap)
+{
+	svSegment tmpSeg;
+	tmpSeg.begin = (int)((int64_t)trellis * seg / nSeg) & ~7;
+	tmpSeg.end = (seg == nSeg - 1) ? trellis : ((int)((int64_t)trellis * (seg + 1) / nSeg) & ~7);
+	tmpSeg.warm = std::max(0, tmpSeg.begin - overlap);
+	tmpSeg.last = std::min(trellis, tmpSeg.end + overlap);
+	return tmpSeg;
+}
+
+int svDataDecoder::llrPos(int step)
+{
+	// punctured llr consumed before the step
+	int period = 0, pos = 0;
+	for(int i=0;i<puncLen;i++)
+	{
+		period += punc[i];
+	}
+	pos = (step / (puncLen / 2)) * period;
+	for(int i=0;i<(step % (puncLen / 2)) * 2;i++)
+	{
+		pos += punc[i];
+	}
+	return pos;
+}
+
+static inline float svLlrScale(float llr, int /*shift*/)
+{
+	return llr;
+}
+
+static inline int16_t svLlrScale(int llr, int shift)
+{
+	return (int16_t)(llr >> shift);
+}
+
+template<typename T, typename B>
+int svDataDecoder::depuncture(const T* llr, int len, int shift, B* b, int& used)
+{
+	// depuncture into llr pairs of at most one acs chunk
+	int step = 0;
+	int periodSteps = puncLen / 2;
+	while(step < SV_ACS_CHUNK && (t + step) < trellis && (used + punc[puncP] + punc[puncP+1]) <= len)
+	{
+		if(puncP == 0 && (step + periodSteps) <= SV_ACS_CHUNK && (t + step + periodSteps) <= trellis && (used + puncUsed) <= len)
+		{
+			// whole periods through the table, no branch on the pattern
+			for(int j=0;j<puncLen;j++)
+			{
+				b[step*2+j] = (B)(svLlrScale(llr[used + puncSrc[j]], shift) * puncKeep[j]);
+			}
+			used += puncUsed;
+			step += periodSteps;
+			continue;
+		}
+		if(punc[puncP])
+		{
+			b[step*2] = svLlrScale(llr[used], shift);
+			used++;
+		}
+		else
+		{
+			b[step*2] = 0;
+		}
+		if(punc[puncP+1])
+		{
+			b[step*2+1] = svLlrScale(llr[used], shift);
+			used++;
+		}
+		else
+		{
+			b[step*2+1] = 0;
+		}
+		puncP += 2;
+		if(puncP >= puncLen)
+		{
+			puncP = 0;
+		}
+		step++;
+	}
+	return step;
+}
+
+int svDataDecoder::update(const float* llr, int len)
+{
+	int used = 0;
+	int step;
+	while(t < trellis)
+	{
+		step = depuncture(llr, len, 0, bm, used);
+		if(step == 0)
+		{
+			break;
+		}
+		svAcsRun(bm, step, pm, &his[t+1]);
+		t += step;
+	}
+	return used;
+}
+
+int svDataDecoder::update(const int16_t* llr, int len)
+{
+	int used = 0;
+	int step;
+	fixedPoint = true;
+	while(t < trellis)
+	{
+		step = depuncture(llr, len, SV_LLR_I16_SHIFT, bmI, used);
+		if(step == 0)
+		{
+			break;
+		}
+		svAcsRunI16(bmI, step, pmI, &his[t+1]);
+		t += step;
+	}
+	return used;
+}
+
+int svDataDecoder::update(const int8_t* llr, int len)
+{
+	int used = 0;
+	int step;
+	fixedPoint = true;
+	while(t < trellis)
+	{
+		step = depuncture(llr, len, 0, bmI, used);
+		if(step == 0)
+		{
+			break;
+		}
+		svAcsRunI16(bmI, step, pmI, &his[t+1]);
+		t += step;
+	}
+	return used;
+}
+
+void svDataDecoder::traceback(int end)
+{
+	// start from the best state, bits beyond end are only used to converge
+	int state = 0;
+	for(int i=1;i<SV_N_STATE;i++)
+	{
+		if(fixedPoint ? ((int16_t)(pmI[i] - pmI[state]) > 0) : (pm[i] > pm[state]))
+		{
+			state = i;
+		}
+	}
+	for(int j=t;j>end;j--)
+	{
+		state = ((state & 31) << 1) | (int)((his[j] >> state) & 1);
+	}
+	for(int j=end;j>tbDone;j--)
+	{
+		scramBytes[(j-1)>>3] |= (uint8_t)((state >> 5) << ((j-1) & 7));
+		state = ((state & 31) << 1) | (int)((his[j] >> state) & 1);
+	}
+	tbDone = end;
+}
+
+void svDataDecoder::end()
+{
+	// the final state should be 0, the bit decoded at each step is the top bit of the state it ends in
+	int state = 0;
+	for(int j=trellis;j>tbDone;j--)
+	{
+		scramBytes[(j-1)>>3] |= (uint8_t)((state >> 5) << ((j-1) & 7));
+		state = ((state & 31) << 1) | (int)((his[j] >> state) & 1);
+	}
+	tbDone = trellis;
+}
+
+void svDataDecoder::descramble()
+{
+	// the first 7 bits of service field are zeros, they give the scrambler state
+	if(tbDone < 7)
+	{
+		return;
+	}
+	if(dsDone == 0)
+	{
+		dsState = 0;
+		for(int i=0;i<7;i++)
+		{
+			if((scramBytes[0] >> i) & 1)
+			{
+				dsState |= 1 << (6 - i);
+			}
+		}
+	}
+	int end = (tbDone >= trellis) ? ((trellis + 7) / 8) : (tbDone / 8);
+	const uint8_t* seq = svScramTab().seq[dsState];
+	int k = dsDone / 8;
+	uint64_t a, b;
+	for(;(k+8)<=end;k+=8)
+	{
+		memcpy(&a, &scramBytes[k], 8);
+		memcpy(&b, &seq[k % 127], 8);
+		a ^= b;
+		memcpy(&unCodedBytes[k], &a, 8);
+	}
+	for(;k<end;k++)
+	{
+		unCodedBytes[k] = scramBytes[k] ^ seq[k % 127];
+	}
+	dsDone = (tbDone >= trellis) ? trellis : (end * 8);
+}
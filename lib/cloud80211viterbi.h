@@ -0,0 +1,130 @@
+/*
+ *
+ *     GNU Radio IEEE 802.11a/g/n/ac 20M bw and upto 2x2
+ *     Viterbi ACS kernels and soft decoder of the data field
+ *     Copyright (C) June 1, 2022  Zelin Yun
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU Affero General Public License as published
+ *     by the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU Affero General Public License for more details.
+ *
+ *     You should have received a copy of the GNU Affero General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_CLOUD80211VITERBI_H
+#define INCLUDED_CLOUD80211VITERBI_H
+
+#include <cstdint>
+
+#define SV_N_STATE 64
+#define SV_METRIC_INIT -1000000000000000.0f
+#define SV_METRIC_INIT_I16 -8192
+#define SV_LLR_I16_SHIFT 7		// int16 llr to the 9 bit branch range of the integer acs
+#define SV_T_MAX 32782			// max trellis len, psdu * 8 + 22
+#define SV_B_MAX ((SV_T_MAX + 7) / 8)
+#define SV_ACS_CHUNK 256		// trellis steps depunctured per acs call
+
+#define SV_ACS_SCALAR 0
+#define SV_ACS_AVX2 1
+#define SV_ACS_AVX512 2
+
+/*
+ * Path metrics are 64 floats indexed by state, larger is better, the same
+ * convention as SV_STATE_NEXT and SV_STATE_OUTPUT. Each trellis step takes a
+ * depunctured LLR pair (t0, t1) from bm and writes one survivor word to dec:
+ * bit n is set when state n survived from predecessor ((n & 31) << 1) | 1
+ * instead of (n & 31) << 1, the decoded bit of a step ending in n is n >> 5.
+ */
+void svAcsRun(const float* bm, int nStep, float* pm, uint64_t* dec);
+void svAcsRunKernel(int kernel, const float* bm, int nStep, float* pm, uint64_t* dec);
+int svAcsKernel();
+const char* svAcsKernelName(int kernel);
+
+/*
+ * Integer kernels keep 16 bit path metrics that are left to wrap around,
+ * two metrics are compared by the sign of their 16 bit difference. With
+ * branch LLRs within +-256 the spread of the metrics stays below 2^14 and
+ * the comparison is exact, the AVX2 kernel does 16 states and the AVX-512
+ * kernel 32 states per instruction.
+ */
+void svAcsRunI16(const int16_t* bm, int nStep, int16_t* pm, uint64_t* dec);
+void svAcsRunKernelI16(int kernel, const int16_t* bm, int nStep, int16_t* pm, uint64_t* dec);
+
+/*
+ * Soft Viterbi of the data field for CR 12, 23, 34 and 56. LLRs can be fed
+ * in pieces. Bits are committed into scramBytes either by a windowed
+ * traceback from the best state or by the final one from the zero tail
+ * state, and descrambled into unCodedBytes as they are committed. Both are
+ * packed lsb first, bit i of the trellis is bit i % 8 of byte i / 8, so
+ * the psdu starts at byte 2 after the service field.
+ *
+ * A segment decoder only runs steps warm to last of a longer trellis and
+ * commits the bits from begin on. Steps before begin warm up the metrics
+ * from an unknown state, steps after the segment let the traceback from
+ * the best state converge, unless last is the end of the trellis.
+ *
+ * Float LLRs go through the float kernels, int16 and int8 LLRs through the
+ * integer ones, all the LLRs of one packet must have the same type.
+ */
+class svDataDecoder
+{
+	private:
+	float pm[SV_N_STATE];
+	float bm[SV_ACS_CHUNK * 2];
+	int16_t pmI[SV_N_STATE];
+	int16_t bmI[SV_ACS_CHUNK * 2];
+	bool fixedPoint;
+	uint64_t his[SV_T_MAX + 1];		/* survivor word of each step */
+	const int* punc;
+	int puncP, puncLen;
+	int puncUsed;			/* llr of one puncture period */
+	int puncSrc[10];		/* llr of each period position, 0 when punctured */
+	int puncKeep[10];
+	int dsState;
+
+	template<typename T, typename B>
+	int depuncture(const T* llr, int len, int shift, B* b, int& used);
+
+	public:
+	int trellis;
+	int t;			/* trellis steps done */
+	int tbDone;		/* bits traced back */
+	int dsDone;		/* bits descrambled, whole bytes until the end */
+	uint8_t scramBytes[SV_B_MAX];
+	uint8_t unCodedBytes[SV_B_MAX];
+
+	void init(int trellisLen, int cr);
+	void initSegment(int cr, int warm, int begin, int last);
+	int llrPos(int step);
+	int update(const float* llr, int len);
+	int update(const int16_t* llr, int len);
+	int update(const int8_t* llr, int len);
+	void traceback(int end);
+	void end();
+	void descramble();
+};
+
+/*
+ * Segment seg of a trellis cut into nSeg for initSegment. The segment
+ * commits the bits begin to end, the cuts are multiples of 8 so the
+ * segments fill whole bytes of scramBytes, and it runs the steps warm to
+ * last, up to overlap steps on each side of the bits it commits.
+ */
+struct svSegment
+{
+	int warm;
+	int begin;
+	int end;
+	int last;
+};
+
+svSegment svSegmentSplit(int trellis, int seg, int nSeg, int overlap);
+
+#endif /* INCLUDED_CLOUD80211VITERBI_H */
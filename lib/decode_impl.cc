@@ -24,22 +24,42 @@
 namespace gr {
   namespace ieee80211 {
     decode::sptr
-    decode::make(bool ifdebug)
+    decode::make(bool ifdebug, int tbdepth, int nworkers, int nsegments, int llrtype)
     {
-      return gnuradio::make_block_sptr<decode_impl>(ifdebug
+      return gnuradio::make_block_sptr<decode_impl>(ifdebug, tbdepth, nworkers, nsegments, llrtype
         );
     }
 
-    decode_impl::decode_impl(bool ifdebug)
+    decode_impl::decode_impl(bool ifdebug, int tbdepth, int nworkers, int nsegments, int llrtype)
       : gr::block("decode",
-              gr::io_signature::make(1, 1, sizeof(float)),
+              gr::io_signature::make(1, 1, llrItemSize(llrtype)),
               gr::io_signature::make(0, 0, 0)),
               d_debug(ifdebug)
     {
-      message_port_register_out(pmt::mp("out"));
+      d_pmtOut = pmt::mp("out");
+      d_pmtLen = pmt::mp("len");
+      d_pmtSeq = pmt::mp("seq");
+      message_port_register_out(d_pmtOut);
 
       d_sDecode = DECODE_S_IDLE;
       d_nPktCorrect = 0;
+      d_tbDepth = std::max(0, tbdepth);
+      d_nWorker = std::min(std::max(0, nworkers), DECODE_W_MAX);
+      d_nSegment = d_nWorker ? std::max(1, nsegments) : 1;
+      d_llrType = llrtype;
+      d_llrSize = llrItemSize(llrtype);
+      d_stop = false;
+      // without workers one job is decoded in place, otherwise two per worker can be queued
+      for(int i=0;i<std::max(1, d_nWorker * 2);i++)
+      {
+        d_jobs.push_back(new decodeJob());
+        d_jobFree.push_back(d_jobs.back());
+      }
+      d_job = d_jobs[0];
+      for(int i=0;i<d_nWorker;i++)
+      {
+        d_segDecs.push_back(new svDataDecoder());
+      }
       memset(d_vhtMcsCount, 0, sizeof(uint64_t) * 10);
       memset(d_legacyMcsCount, 0, sizeof(uint64_t) * 8);
       memset(d_htMcsCount, 0, sizeof(uint64_t) * 8);
@@ -49,6 +69,42 @@ namespace gr {
 
     decode_impl::~decode_impl()
     {
+      for(decodeJob* tmpJob : d_jobs)
+      {
+        delete tmpJob;
+      }
+      for(svDataDecoder* tmpDec : d_segDecs)
+      {
+        delete tmpDec;
+      }
+    }
+
+    bool
+    decode_impl::start()
+    {
+      d_stop = false;
+      for(int i=0;i<d_nWorker;i++)
+      {
+        d_workers.push_back(std::thread(&decode_impl::workerLoop, this, i));
+      }
+      return block::start();
+    }
+
+    bool
+    decode_impl::stop()
+    {
+      {
+        std::lock_guard<std::mutex> tmpLock(d_mutex);
+        d_stop = true;
+      }
+      d_cvQueue.notify_all();
+      for(auto& tmpWorker : d_workers)
+      {
+        tmpWorker.join();
+      }
+      d_workers.clear();
+      dout<<"ieee80211 decode, blob pool reused "<<d_blobPool.nHit<<" of "<<d_blobPool.nGet<<std::endl;
+      return block::stop();
     }
 
     void
@@ -63,94 +119,170 @@ namespace gr {
                        gr_vector_const_void_star &input_items,
                        gr_vector_void_star &output_items)
     {
-      const float* inSig = static_cast<const float*>(input_items[0]);
+      const uint8_t* inSig = static_cast<const uint8_t*>(input_items[0]);
       d_nProc = ninput_items[0];
       if(d_sDecode == DECODE_S_IDLE)
       {
         get_tags_in_range(tags, 0, nitems_read(0) , nitems_read(0) + 1);
-        if(tags.size())
+        c8p_pkt tmpPktCopy;
+        const c8p_pkt* tmpPkt = c8pPktFind(tags, &tmpPktCopy, d_debug);
+        if(tmpPkt)
         {
-          pmt::pmt_t d_meta = pmt::make_dict();
-          for (auto tag : tags){
-            d_meta = pmt::dict_add(d_meta, tag.key, tag.value);
+          if(d_nWorker)
+          {
+            // the workers always make progress, a job is freed once its packets are published
+            std::unique_lock<std::mutex> tmpLock(d_mutex);
+            d_cvFree.wait(tmpLock, [this]{return !d_jobFree.empty();});
+            d_job = d_jobFree.front();
+            d_jobFree.pop_front();
           }
-          t_format = pmt::to_long(pmt::dict_ref(d_meta, pmt::mp("format"), pmt::from_long(99999)));
-          t_len = pmt::to_long(pmt::dict_ref(d_meta, pmt::mp("len"), pmt::from_long(99999)));
-          t_nTotal = pmt::to_long(pmt::dict_ref(d_meta, pmt::mp("total"), pmt::from_long(99999)));
-          t_cr = pmt::to_long(pmt::dict_ref(d_meta, pmt::mp("cr"), pmt::from_long(99999)));
-          t_mcs = pmt::to_long(pmt::dict_ref(d_meta, pmt::mp("mcs"), pmt::from_long(99999)));
-          t_ampdu = pmt::to_long(pmt::dict_ref(d_meta, pmt::mp("ampdu"), pmt::from_long(99999)));
-          v_trellis = pmt::to_long(pmt::dict_ref(d_meta, pmt::mp("trellis"), pmt::from_long(99999)));
-          t_cfo = pmt::to_float(pmt::dict_ref(d_meta, pmt::mp("cfo"), pmt::from_float(0.0f)));
-          t_snr = pmt::to_float(pmt::dict_ref(d_meta, pmt::mp("snr"), pmt::from_float(0.0f)));
-          t_sssnr0 = pmt::to_float(pmt::dict_ref(d_meta, pmt::mp("sssnr0"), pmt::from_float(0.0f)));
-          t_sssnr1 = pmt::to_float(pmt::dict_ref(d_meta, pmt::mp("sssnr1"), pmt::from_float(0.0f)));
-          t_rssi = pmt::to_float(pmt::dict_ref(d_meta, pmt::mp("rssi"), pmt::from_float(0.0f)));
+          d_job->seq = tmpPkt->seq;
+          d_job->format = tmpPkt->format;
+          d_job->len = tmpPkt->len;
+          d_job->total = tmpPkt->total;
+          d_job->cr = tmpPkt->cr;
+          d_job->mcs = tmpPkt->mcs;
+          d_job->ampdu = tmpPkt->ampdu;
+          d_job->trellis = tmpPkt->trellis;
+          d_job->cfo = tmpPkt->cfo;
+          d_job->snr = tmpPkt->snr;
+          d_job->sssnr0 = tmpPkt->sssnr0;
+          d_job->sssnr1 = tmpPkt->sssnr1;
+          d_job->rssi = tmpPkt->rssi;
+          d_job->nLlr = 0;
+          d_job->done = false;
+          d_job->parser.init(d_job->format, d_job->len, d_job->trellis);
+          d_nTotal = d_job->total;
+          d_nProcd = 0;
           d_sDecode = DECODE_S_DECODE;
-          t_nProcd = 0;
-          // dout<<"ieee80211 decode, tag f:"<<t_format<<", ampdu:"<<t_ampdu<<", len:"<<t_len<<", total:"<<t_nTotal<<", cr:"<<t_cr<<", tr:"<<v_trellis<<std::endl;
+          // dout<<"ieee80211 decode, tag f:"<<d_job->format<<", ampdu:"<<d_job->ampdu<<", len:"<<d_job->len<<", total:"<<d_job->total<<", cr:"<<d_job->cr<<", tr:"<<d_job->trellis<<std::endl;
           
-          if(t_len > DECODE_B_MAX || v_trellis > DECODE_T_MAX)
+          if(d_job->len > DECODE_B_MAX || d_job->trellis > DECODE_T_MAX)
           {
-            // dout<<"ieee80211 decode, packet len " << t_len << " or trellis len "<< v_trellis <<" not supported." << std::endl;
+            // dout<<"ieee80211 decode, packet len " << d_job->len << " or trellis len "<< d_job->trellis <<" not supported." << std::endl;
             d_sDecode = DECODE_S_CLEAN;
+            if(d_nWorker)
+            {
+              std::lock_guard<std::mutex> tmpLock(d_mutex);
+              d_jobFree.push_back(d_job);
+            }
           }
-          else
+          else if(d_job->trellis == 0)
           {
-            if(v_trellis == 0)
+            d_sDecode = DECODE_S_CLEAN;
+            int tmpLen = sizeof(float)*256;
+            // the 128 channel values go straight into the payload as float pairs
+            pmt::pmt_t tmpPayload = pmt::make_u8vector(tmpLen+3, 0);
+            size_t tmpBlobLen;
+            uint8_t* tmpBytes = pmt::u8vector_writable_elements(tmpPayload, tmpBlobLen);
+            tmpBytes[0] = C8P_F_VHT_CHAN;
+            tmpBytes[1] = tmpLen%256;  // byte 1-2 packet len
+            tmpBytes[2] = tmpLen/256;
+            memcpy(&tmpBytes[3], tmpPkt->chan, sizeof(gr_complex) * std::min(tmpPkt->nChan, 128));
+            // dout<<"ieee80211 decode, vht NDP 2x1 channel report:"<<tmpLen<<std::endl;
+            pmt::pmt_t tmpMeta = pmt::dict_add(pmt::make_dict(), d_pmtLen, pmt::from_long(tmpLen+3));
+            d_job->ndp = pmt::cons(tmpMeta, tmpPayload);
+            if(d_nWorker)
             {
-              d_sDecode = DECODE_S_CLEAN;
-              d_tagMu2x1Chan = pmt::c32vector_elements(pmt::dict_ref(d_meta, pmt::mp("mu2x1chan"), pmt::PMT_NIL));
-              std::copy(d_tagMu2x1Chan.begin(), d_tagMu2x1Chan.end(), d_mu2x1Chan);
-              int tmpLen = sizeof(float)*256;
-              d_mu2x1ChanFloatBytes[0] = C8P_F_VHT_CHAN;
-              d_mu2x1ChanFloatBytes[1] = tmpLen%256;  // byte 1-2 packet len
-              d_mu2x1ChanFloatBytes[2] = tmpLen/256;
-              float* tmpFloatPointer = (float*)&d_mu2x1ChanFloatBytes[3];
-              for(int i=0;i<128;i++)
-              {
-                // dout<<"chan "<<i<<" "<<d_mu2x1Chan[i]<<std::endl;
-                tmpFloatPointer[i*2] = d_mu2x1Chan[i].real();
-                tmpFloatPointer[i*2+1] = d_mu2x1Chan[i].imag();
-              }
-              // dout<<"ieee80211 decode, vht NDP 2x1 channel report:"<<tmpLen<<std::endl;
-              pmt::pmt_t tmpMeta = pmt::make_dict();
-              tmpMeta = pmt::dict_add(tmpMeta, pmt::mp("len"), pmt::from_long(tmpLen+3));
-              pmt::pmt_t tmpPayload = pmt::make_blob((uint8_t*)d_mu2x1ChanFloatBytes, tmpLen+3);
-              message_port_pub(pmt::mp("out"), pmt::cons(tmpMeta, tmpPayload));
+              // keep the report in order with the packets still being decoded
+              std::lock_guard<std::mutex> tmpLock(d_mutex);
+              d_job->done = true;
+              d_jobOrder.push_back(d_job);
+              jobPublish();
+            }
+            else
+            {
+              packetAssemble(d_job);
             }
-            vstb_init();
+          }
+          else if(d_nWorker)
+          {
+            d_sDecode = DECODE_S_GATHER;
+            if((int)d_job->llr.size() < d_job->total * d_llrSize)
+            {
+              d_job->llr.resize(d_job->total * d_llrSize);
+            }
+          }
+          else
+          {
+            d_job->dec.init(d_job->trellis, d_job->cr);
           }
         }
         consume_each(0);
         return 0;
       }
+      else if(d_sDecode == DECODE_S_GATHER)
+      {
+        // copy the llr of the whole packet and hand it to the workers
+        int tmpNum = std::min(d_nProc, d_job->total - d_job->nLlr);
+        memcpy(&d_job->llr[d_job->nLlr * d_llrSize], inSig, d_llrSize * tmpNum);
+        d_job->nLlr += tmpNum;
+        if(d_job->nLlr >= d_job->total)
+        {
+          d_job->nSeg = std::max(1, std::min(d_nSegment, d_job->trellis / DECODE_SEG_MIN));
+          d_job->segNext = 0;
+          d_job->segLeft = d_job->nSeg;
+          d_job->segFailed = false;
+          d_job->dec.init(d_job->trellis, d_job->cr);
+          std::lock_guard<std::mutex> tmpLock(d_mutex);
+          d_jobOrder.push_back(d_job);
+          d_jobQueue.push_back(d_job);
+          d_cvQueue.notify_one();
+          d_sDecode = DECODE_S_IDLE;
+        }
+        if(d_sDecode == DECODE_S_IDLE && tmpNum == d_nProc)
+        {
+          jobDrain();
+        }
+        consume_each(tmpNum);
+        return 0;
+      }
       else if(d_sDecode == DECODE_S_DECODE)
       {
-        int tmpProcd = vstb_update(inSig, d_nProc);
-        if(v_t >= v_trellis)
+        svDataDecoder& tmpDec = d_job->dec;
+        int tmpProcd = decUpdate(&tmpDec, inSig, d_nProc);
+        if(tmpDec.t >= tmpDec.trellis)
         {
           d_sDecode = DECODE_S_CLEAN;
-          vstb_end();
-          descramble();
-          packetAssemble();
+          tmpDec.end();
+          tmpDec.descramble();
+          packetAssemble(d_job);
         }
-        t_nProcd += tmpProcd;
+        else if(d_tbDepth && (tmpDec.t - d_tbDepth - tmpDec.tbDone) >= DECODE_TB_STEP)
+        {
+          // windowed mode, commit the bits older than the traceback depth
+          tmpDec.traceback(tmpDec.t - d_tbDepth);
+          tmpDec.descramble();
+          if(d_job->format == C8P_F_VHT || d_job->ampdu)
+          {
+            packetAssemble(d_job);
+          }
+          else
+          {
+            d_job->parser.fcsUpdate(&d_job->dec);
+          }
+        }
+        d_nProcd += tmpProcd;
         consume_each(tmpProcd);
         return 0;
       }
       else if(d_sDecode == DECODE_S_CLEAN)
       {
-        if(d_nProc >= (t_nTotal - t_nProcd))
+        if(d_nProc >= (d_nTotal - d_nProcd))
         {
           d_sDecode = DECODE_S_IDLE;
-          // dout<<"ieee80211 decode, clean:"<<(t_nTotal - t_nProcd)<<std::endl;
-          consume_each((t_nTotal - t_nProcd));
+          if(d_nProc == (d_nTotal - d_nProcd))
+          {
+            jobDrain();
+          }
+          // dout<<"ieee80211 decode, clean:"<<(d_nTotal - d_nProcd)<<std::endl;
+          consume_each((d_nTotal - d_nProcd));
           return 0;
         }
         else
         {
-          t_nProcd += d_nProc;
+          d_nProcd += d_nProc;
+          jobDrain();
           // dout<<"ieee80211 decode, clean:"<<d_nProc<<std::endl;
           consume_each(d_nProc);
           return 0;
@@ -161,362 +293,233 @@ namespace gr {
       return 0;
     }
 
-    void
-    decode_impl::vstb_init()
+    int
+    decode_impl::decUpdate(svDataDecoder* dec, const uint8_t* llr, int len)
     {
-      // init and input 
-      for (int i = 0; i < 64; i++)
+      switch(d_llrType)
       {
-        for (int j = 0; j <= v_trellis; j++)
-        {
-          v_state_his[i][j] = 0;
-        }
-        v_accum_err0[i] = -1000000000000000.0f;
-        v_accum_err1[i] = -1000000000000000.0f;
-      }
-      v_accum_err0[0] = 0;
-      v_ae_pCur = &v_accum_err1[0];
-      v_ae_pPre = &v_accum_err0[0];
-      v_t = 0;
-      v_cr_p = 0;
-      switch(t_cr)
-      {
-        case C8P_CR_12:
-          v_cr_len = 2;
-          v_cr_punc = SV_PUNC_12;
-          break;
-        case C8P_CR_23:
-          v_cr_len = 4;
-          v_cr_punc = SV_PUNC_23;
-          break;
-        case C8P_CR_34:
-          v_cr_len = 6;
-          v_cr_punc = SV_PUNC_34;
-          break;
-        case C8P_CR_56:
-          v_cr_len = 10;
-          v_cr_punc = SV_PUNC_56;
-          break;
+        case C8P_LLR_I16:
+          return dec->update((const int16_t*)llr, len);
+        case C8P_LLR_I8:
+          return dec->update((const int8_t*)llr, len);
         default:
-          break;
+          return dec->update((const float*)llr, len);
       }
     }
 
-    int
-    decode_impl::vstb_update(const float* llr, int len)
+    void
+    decode_impl::workerLoop(int id)
     {
-      int tmpUsed=0;
-
-      while((tmpUsed + v_cr_punc[v_cr_p] + v_cr_punc[v_cr_p+1])<=len)
+      svDataDecoder* tmpSegDec = d_segDecs[id];
+      while(true)
       {
-        if(v_cr_punc[v_cr_p])
-        {
-          v_t0 = llr[tmpUsed];
-          tmpUsed++;
-        }
-        else
-        {
-          v_t0 = 0.0f;
-        }
-        if(v_cr_punc[v_cr_p+1])
+        decodeJob* tmpJob;
+        int tmpSeg;
         {
-          v_t1 = llr[tmpUsed];
-          tmpUsed++;
+          std::unique_lock<std::mutex> tmpLock(d_mutex);
+          d_cvQueue.wait(tmpLock, [this]{return d_stop || !d_jobQueue.empty();});
+          if(d_jobQueue.empty())
+          {
+            return;
+          }
+          tmpJob = d_jobQueue.front();
+          tmpSeg = tmpJob->segNext++;
+          if(tmpJob->segNext >= tmpJob->nSeg)
+          {
+            d_jobQueue.pop_front();
+          }
+          else
+          {
+            d_cvQueue.notify_one();
+          }
         }
-        else
+        if(tmpJob->nSeg == 1)
         {
-          v_t1 = 0.0f;
+          decUpdate(&tmpJob->dec, tmpJob->llr.data(), tmpJob->nLlr);
+          if(tmpJob->dec.t >= tmpJob->trellis)
+          {
+            tmpJob->dec.end();
+            tmpJob->dec.descramble();
+          }
+          std::lock_guard<std::mutex> tmpLock(d_mutex);
+          tmpJob->done = true;
+          jobPublish();
+          continue;
         }
 
-        v_tab_t[0] = 0.0f;
-        v_tab_t[1] = v_t1;
-        v_tab_t[2] = v_t0;
-        v_tab_t[3] = v_t1+v_t0;
-
-        /* repeat for each possible state */
-        for (int i = 0; i < 64; i++)
+        // one segment of a long trellis, the margins overlap the neighbour segments
+        // boundaries are byte aligned so the packed bits are stitched by bytes
+        svSegment tmpSpan = svSegmentSplit(tmpJob->trellis, tmpSeg, tmpJob->nSeg, DECODE_SEG_OVERLAP);
+        tmpSegDec->initSegment(tmpJob->cr, tmpSpan.warm, tmpSpan.begin, tmpSpan.last);
+        int tmpPos = std::min(tmpSegDec->llrPos(tmpSpan.warm), tmpJob->nLlr);
+        decUpdate(tmpSegDec, &tmpJob->llr[tmpPos * d_llrSize], tmpJob->nLlr - tmpPos);
+        bool tmpSegOk = (tmpSegDec->t >= tmpSpan.last);
+        if(tmpSegOk)
         {
-          v_op0 = SV_STATE_OUTPUT[i][0];
-          v_op1 = SV_STATE_OUTPUT[i][1];
-
-          v_acc_tmp0 = v_ae_pPre[i] + v_tab_t[v_op0];
-          v_acc_tmp1 = v_ae_pPre[i] + v_tab_t[v_op1];
-
-          v_next0 = SV_STATE_NEXT[i][0];
-          v_next1 = SV_STATE_NEXT[i][1];
-
-          if (v_acc_tmp0 > v_ae_pCur[v_next0])
+          if(tmpSpan.last == tmpJob->trellis)
           {
-            v_ae_pCur[v_next0] = v_acc_tmp0;
-            v_state_his[v_next0][v_t+1] = i;
+            tmpSegDec->end();
           }
-
-          if (v_acc_tmp1 > v_ae_pCur[v_next1])
+          else
           {
-            v_ae_pCur[v_next1] = v_acc_tmp1;
-            v_state_his[v_next1][v_t+1] = i;
+            tmpSegDec->traceback(tmpSpan.end);
           }
+          memcpy(&tmpJob->dec.scramBytes[tmpSpan.begin / 8], &tmpSegDec->scramBytes[tmpSpan.begin / 8], (tmpSpan.end - tmpSpan.begin + 7) / 8);
         }
-
-        /* update accum_err_metric array */
-        float* tmp = v_ae_pPre;
-        v_ae_pPre = v_ae_pCur;
-        v_ae_pCur = tmp;
-
-        for (int i = 0; i < 64; i++)
+        bool tmpSegAll;
         {
-          v_ae_pCur[i] = -1000000000000000.0f;
+          std::lock_guard<std::mutex> tmpLock(d_mutex);
+          tmpJob->segFailed |= !tmpSegOk;
+          tmpJob->segLeft--;
+          tmpSegAll = (tmpJob->segLeft == 0);
         }
-        v_cr_p += 2;
-        if(v_cr_p >= v_cr_len)
-        {v_cr_p = 0;}
-
-        v_t++;
-        if(v_t >= v_trellis)
+        if(tmpSegAll)
         {
-          break;
+          // the last segment done descrambles the whole packet
+          if(!tmpJob->segFailed)
+          {
+            tmpJob->dec.t = tmpJob->trellis;
+            tmpJob->dec.tbDone = tmpJob->trellis;
+            tmpJob->dec.descramble();
+          }
+          std::lock_guard<std::mutex> tmpLock(d_mutex);
+          tmpJob->done = true;
+          jobPublish();
         }
-      } // end of t loop
-      return tmpUsed;
+      }
     }
+
     void
-    decode_impl::vstb_end()
+    decode_impl::jobDrain()
     {
-      // The final state should be 0
-      v_state_seq[v_trellis] = 0;
-      for (int j = v_trellis; j > 0; j--)
+      // caught up with the input, the packets in flight go out now so none is left on a worker when a finite stream ends
+      if(d_nWorker)
       {
-        v_state_seq[j-1] = v_state_his[v_state_seq[j]][j];
+        std::unique_lock<std::mutex> tmpLock(d_mutex);
+        d_cvFree.wait(tmpLock, [this]{return d_jobOrder.empty();});
       }
-      for (int j = 0; j < v_trellis; j++)
+    }
+
+    void
+    decode_impl::jobPublish()
+    {
+      // called with d_mutex held, only the oldest finished jobs can go out
+      while(!d_jobOrder.empty() && d_jobOrder.front()->done)
       {
-        if (v_state_seq[j+1] == SV_STATE_NEXT[v_state_seq[j]][1])
-        {
-          v_scramBits[j] = 1;
-        }
-        else
+        decodeJob* tmpJob = d_jobOrder.front();
+        d_jobOrder.pop_front();
+        if(tmpJob->trellis == 0 || tmpJob->dec.dsDone >= tmpJob->trellis)
         {
-          v_scramBits[j] = 0;
+          packetAssemble(tmpJob);
         }
+        d_jobFree.push_back(tmpJob);
+        d_cvFree.notify_one();
       }
     }
 
     void
-    decode_impl::descramble()
+    decode_impl::packetAssemble(decodeJob* job)
     {
-      int state = 0;
-      int feedback;
-      for (int i = 0; i < 7; i++)
+      if(job->trellis == 0)
       {
-        if (v_scramBits[i])
-        {
-          state |= 1 << (6 - i);
-        }
+        // vht NDP channel report
+        message_port_pub(d_pmtOut, job->ndp);
+      }
+      else if(job->format == C8P_F_VHT || job->ampdu)
+      {
+        // n and ac ampdu, each subframe is assembled once all its bits are descrambled
+        job->parser.subframes(&job->dec, [this, job](const uint8_t* mpdu, int len, uint32_t crc){
+          mpduPublish(job, mpdu, len, crc);
+        });
       }
-      memset(v_unCodedBits, 0, 7);
-      for (int i=7; i<v_trellis; i++)
+      else
       {
-        feedback = ((!!(state & 64))) ^ (!!(state & 8));
-        v_unCodedBits[i] = feedback ^ (v_scramBits[i] & 0x1);
-        state = ((state << 1) & 0x7e) | feedback;
+        // a and n general packet, psdu after 2 bytes service field
+        job->parser.fcsUpdate(&job->dec);
+        mpduPublish(job, &job->dec.unCodedBytes[2], job->len, job->parser.fcs);
       }
     }
 
     void
-    decode_impl::packetAssemble()
+    decode_impl::mpduPublish(decodeJob* job, const uint8_t* mpdu, int len, uint32_t crc)
     {
-      int tmpBitsProcd = 0;
-      if(t_format == C8P_F_VHT)
+      // crc is the crc32 of the whole mpdu, publishes it with the mcs appended when correct
+      bool tmpCorrect = (crc == DECODE_FCS_RESIDUE);
+      if(d_debug)
       {
-        // ac ampdu
-        tmpBitsProcd += 16;
-        if(tmpBitsProcd < v_trellis)
+        std::string dbgStr("ieee80211 decode, ");
+        int tmpNCount = 8;
+        uint64_t* tmpCount = d_legacyMcsCount;
+        if(job->format == C8P_F_VHT)
         {
-          uint8_t* tmpBitP = &v_unCodedBits[16];
-          int tmpEof, tmpLen=0;
-          while(true)
-          {
-            tmpBitsProcd += 32;
-            if(tmpBitsProcd > v_trellis)
-            {
-              //dout<<"ieee80211 decode, ampdu error"<<std::endl;
-              break;
-            }
-            tmpEof = tmpBitP[0];
-            tmpLen |= (((int)tmpBitP[2])<<12);
-            tmpLen |= (((int)tmpBitP[3])<<13);
-            for(int i=0;i<12;i++)
-            {
-              tmpLen |= (((int)tmpBitP[4+i])<<i);
-            }
-            tmpBitsProcd += ((tmpLen/4 + ((tmpLen%4)!=0))*4*8);
-            if(tmpBitsProcd > v_trellis)
-            {
-              //dout<<"ieee80211 decode, ampdu error"<<std::endl;
-              break;
-            }
-            tmpBitP += 32;
-            d_pktBytes[0] = t_format;    // byte 0 format
-            d_pktBytes[1] = tmpLen%256;  // byte 1-2 packet len
-            d_pktBytes[2] = tmpLen/256;
-            for(int i=0;i<tmpLen;i++)
-            {
-              d_pktBytes[i+3] = 0;
-              for(int j=0;j<8;j++)
-              {
-                d_pktBytes[i+3] |= (tmpBitP[i*8+j]<<j);
-              }
-            }
-            tmpBitP += ((tmpLen/4 + ((tmpLen%4)!=0))*4*8);
-
-            d_crc32.reset();
-            d_crc32.process_bytes(d_pktBytes + 3, tmpLen);
-            if (d_crc32.checksum() != 558161692) {
-              if(d_debug)
-              {
-                std::string dbgStr("ieee80211 decode, vht crc32 wrong, total:");
-                dbgStr += std::to_string(d_nPktCorrect);
-                for(int i=0;i<10;i++)
-                {
-                  dbgStr += (std::string(",") + std::to_string(i) + std::string(":") + std::to_string(d_vhtMcsCount[i]));
-                }
-                dbgStr += (std::string(",cfo:") + std::to_string(t_cfo));
-                dbgStr += (std::string(",snr:") + std::to_string(t_snr));
-                dbgStr += (std::string(",rssi:") + std::to_string(t_rssi));
-                dbgStr += (std::string(",sssnr0:") + std::to_string(t_sssnr0));
-                dbgStr += (std::string(",sssnr1:") + std::to_string(t_sssnr1));
-                dout << dbgStr << std::endl;
-              }
-            }
-            else
-            {
-              if(d_debug)
-              {
-                d_nPktCorrect++;
-                if(t_mcs >= 0 && t_mcs < 10)
-                {
-                  d_vhtMcsCount[t_mcs]++;
-                }
-                std::string dbgStr("ieee80211 decode, vht crc32 correct, total:");
-                dbgStr += std::to_string(d_nPktCorrect);
-                for(int i=0;i<10;i++)
-                {
-                  dbgStr += (std::string(",") + std::to_string(i) + std::string(":") + std::to_string(d_vhtMcsCount[i]));
-                }
-                dbgStr += (std::string(",cfo:") + std::to_string(t_cfo));
-                dbgStr += (std::string(",snr:") + std::to_string(t_snr));
-                dbgStr += (std::string(",rssi:") + std::to_string(t_rssi));
-                dbgStr += (std::string(",sssnr0:") + std::to_string(t_sssnr0));
-                dbgStr += (std::string(",sssnr1:") + std::to_string(t_sssnr1));
-                dout << dbgStr << std::endl;
-              }
-              // 1 byte packet format
-              d_pktBytes[tmpLen + 3] = t_mcs;
-              tmpLen += 4;
-              pmt::pmt_t tmpMeta = pmt::make_dict();
-              tmpMeta = pmt::dict_add(tmpMeta, pmt::mp("len"), pmt::from_long(tmpLen));
-              pmt::pmt_t tmpPayload = pmt::make_blob(d_pktBytes, tmpLen);
-              message_port_pub(pmt::mp("out"), pmt::cons(tmpMeta, tmpPayload));
-            }
-
-            if(tmpEof)
-            {
-              break;
-            }
-          }
+          dbgStr += "vht";
+          tmpNCount = 10;
+          tmpCount = d_vhtMcsCount;
         }
-      }
-      else
-      {
-        // a and n general packet
-        if(t_ampdu)
+        else if(job->format == C8P_F_HT)
         {
-          // n ampdu, to be added
+          dbgStr += "ht";
+          tmpCount = d_htMcsCount;
         }
         else
         {
-          uint8_t* tmpBitP = &v_unCodedBits[16];
-          d_pktBytes[0] = t_format;
-          d_pktBytes[1] = t_len%256;  // byte 1-2 packet len
-          d_pktBytes[2] = t_len/256;
-          for(int i=0;i<t_len;i++)
+          dbgStr += "legacy";
+        }
+        if(tmpCorrect)
+        {
+          d_nPktCorrect++;
+          if(job->format == C8P_F_HT)
           {
-            d_pktBytes[i+3] = 0;
-            for(int j=0;j<8;j++)
-            {
-              d_pktBytes[i+3] |= (tmpBitP[i*8+j]<<j);
-            }
+            tmpCount[job->mcs%8]++;
           }
-          
-          d_crc32.reset();
-          d_crc32.process_bytes(d_pktBytes + 3, t_len);
-          if (d_crc32.checksum() != 558161692) {
-            if(d_debug)
-            {
-              std::string dbgStr;
-              if(t_format == C8P_F_L){
-                dbgStr = std::string("ieee80211 decode, legacy crc32 wrong, total:");
-              }
-              else{
-                dbgStr = std::string("ieee80211 decode, ht crc32 wrong, total:");
-              }
-              dbgStr += std::to_string(d_nPktCorrect);
-              for(int i=0;i<8;i++)
-              {
-                dbgStr += (std::string(",") + std::to_string(i) + std::string(":"));
-                if(t_format == C8P_F_L){
-                  dbgStr += std::to_string(d_legacyMcsCount[i]);
-                }
-                else{
-                  dbgStr += std::to_string(d_htMcsCount[i]);
-                }
-              }
-              dbgStr += (std::string(",cfo:") + std::to_string(t_cfo));
-              dbgStr += (std::string(",snr:") + std::to_string(t_snr));
-              dbgStr += (std::string(",rssi:") + std::to_string(t_rssi));
-              dout << dbgStr << std::endl;
-            }
-          }
-          else
+          else if(job->mcs >= 0 && job->mcs < tmpNCount)
           {
-            if(d_debug)
-            {
-              d_nPktCorrect++;
-
-              std::string dbgStr;
-              if(t_format == C8P_F_L){
-                dbgStr = std::string("ieee80211 decode, legacy crc32 correct, total:");
-                d_legacyMcsCount[t_mcs]++;
-              }
-              else{
-                dbgStr = std::string("ieee80211 decode, ht crc32 correct, total:");
-                d_htMcsCount[t_mcs%8]++;
-              }
-              dbgStr += std::to_string(d_nPktCorrect);
-              for(int i=0;i<8;i++)
-              {
-                dbgStr += (std::string(",") + std::to_string(i) + std::string(":"));
-                if(t_format == C8P_F_L){
-                  dbgStr += std::to_string(d_legacyMcsCount[i]);
-                }
-                else{
-                  dbgStr += std::to_string(d_htMcsCount[i]);
-                }
-              }
-              dbgStr += (std::string(",cfo:") + std::to_string(t_cfo));
-              dbgStr += (std::string(",snr:") + std::to_string(t_snr));
-              dbgStr += (std::string(",rssi:") + std::to_string(t_rssi));
-              dout << dbgStr << std::endl;
-            }
-
-            d_pktBytes[3+t_len] = t_mcs;
-            pmt::pmt_t tmpMeta = pmt::make_dict();
-            tmpMeta = pmt::dict_add(tmpMeta, pmt::mp("len"), pmt::from_long(t_len+4));
-            pmt::pmt_t tmpPayload = pmt::make_blob(d_pktBytes, t_len+4);
-            message_port_pub(pmt::mp("out"), pmt::cons(tmpMeta, tmpPayload));
+            tmpCount[job->mcs]++;
           }
+          dbgStr += " crc32 correct, total:";
+        }
+        else
+        {
+          dbgStr += " crc32 wrong, total:";
+        }
+        dbgStr += std::to_string(d_nPktCorrect);
+        for(int i=0;i<tmpNCount;i++)
+        {
+          dbgStr += (std::string(",") + std::to_string(i) + std::string(":") + std::to_string(tmpCount[i]));
+        }
+        dbgStr += (std::string(",cfo:") + std::to_string(job->cfo));
+        dbgStr += (std::string(",snr:") + std::to_string(job->snr));
+        dbgStr += (std::string(",rssi:") + std::to_string(job->rssi));
+        if(job->format == C8P_F_VHT)
+        {
+          dbgStr += (std::string(",sssnr0:") + std::to_string(job->sssnr0));
+          dbgStr += (std::string(",sssnr1:") + std::to_string(job->sssnr1));
         }
+        dout << dbgStr << std::endl;
+      }
+      if(tmpCorrect)
+      {
+        pktPublish(job, mpdu, len);
+      }
+    }
+
+    void
+    decode_impl::pktPublish(decodeJob* job, const uint8_t* mpdu, int len)
+    {
+      // 1 byte format, 2 bytes len, mpdu and 1 byte mcs, written straight into the outgoing blob
+      pmt::pmt_t tmpPayload;
+      uint8_t* tmpBytes = d_blobPool.get(len + 4, tmpPayload);
+      tmpBytes[0] = job->format;
+      tmpBytes[1] = len%256;
+      tmpBytes[2] = len/256;
+      memcpy(&tmpBytes[3], mpdu, len);
+      tmpBytes[len + 3] = job->mcs;
+      pmt::pmt_t tmpMeta = pmt::dict_add(pmt::make_dict(), d_pmtLen, pmt::from_long(len + 4));
+      if(job->seq >= 0)
+      {
+        tmpMeta = pmt::dict_add(tmpMeta, d_pmtSeq, pmt::from_long(job->seq));
       }
+      message_port_pub(d_pmtOut, pmt::cons(tmpMeta, tmpPayload));
     }
 
   } /* namespace ieee80211 */
@@ -22,8 +22,15 @@
 #define INCLUDED_IEEE80211_DECODE_IMPL_H
 
 #include <gnuradio/ieee80211/decode.h>
-#include <boost/crc.hpp>
+#include <gnuradio/ieee80211/utils.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
 #include "cloud80211phy.h"
+#include "cloud80211viterbi.h"
+#include "cloud80211pkt.h"
+#include "cloud80211rx.h"
 
 
 #define dout d_debug&&std::cout
@@ -31,13 +38,50 @@
 #define DECODE_S_IDLE 0
 #define DECODE_S_DECODE 1
 #define DECODE_S_CLEAN 2
+#define DECODE_S_GATHER 3
 
 #define DECODE_B_MAX 4095     // max PSDU byte len
-#define DECODE_T_MAX 32782    // max trellis len, psdu * 8 + 22
+#define DECODE_T_MAX SV_T_MAX // max trellis len, psdu * 8 + 22
+#define DECODE_TB_STEP 64     // min bits committed per windowed traceback
+#define DECODE_W_MAX 64       // max decode workers
+#define DECODE_SEG_MIN 2048   // min trellis steps of a segment
+// warm up and traceback margin on each side of a segment, from 32 on the
+// bit errors of all code rates were the same as decoding the whole trellis,
+// qa_viterbi checks it from 64 on
+#define DECODE_SEG_OVERLAP 96
+#define DECODE_FCS_RESIDUE 0x2144DF1C // crc32 of an mpdu with its correct fcs
 
 namespace gr {
   namespace ieee80211 {
 
+    // one tagged packet, decoded in the block or by a worker
+    struct decodeJob
+    {
+      int seq;
+      int format;
+      int len;
+      int total;
+      int cr;
+      int mcs;
+      int ampdu;
+      int trellis;
+      float cfo;
+      float snr;
+      float sssnr0;
+      float sssnr1;
+      float rssi;
+      pmt::pmt_t ndp;       // vht NDP channel report, published as it is
+      std::vector<uint8_t> llr;    // llr of the packet in the input type
+      int nLlr;
+      bool done;
+      c8pMpduParser parser;
+      int nSeg;             // long trellis is split into segments for several workers
+      int segNext;
+      int segLeft;
+      bool segFailed;
+      svDataDecoder dec;
+    };
+
     class decode_impl : public decode
     {
     private:
@@ -47,43 +91,32 @@ namespace gr {
       int d_sDecode;
       bool d_debug;
       uint64_t d_nPktCorrect;
+      int d_nProcd;
+      int d_nTotal;
+      int d_tbDepth;        // 0 for full traceback at the end of trellis
       // tag
       std::vector<gr::tag_t> tags;
-      int t_len;
-      int t_format;
-      int t_ampdu;
-      int t_cr;
-      int t_nUnCoded;
-      int t_nTotal;
-      int t_nProcd;
-      int t_mcs;
-      float t_cfo;
-      float t_snr;
-      float t_sssnr0;
-      float t_sssnr1;
-      float t_rssi;
-      // NDP channel
-      gr_complex d_mu2x1Chan[128];
-      uint8_t d_mu2x1ChanFloatBytes[1027];
-      std::vector<gr_complex> d_tagMu2x1Chan;
-      // viterbi
-      float v_accum_err0[64];
-	    float v_accum_err1[64];
-      float *v_ae_pTmp, *v_ae_pPre, *v_ae_pCur;
-      int v_state_his[64][DECODE_T_MAX+1];
-      int v_state_seq[DECODE_T_MAX+1];
-      int v_op0, v_op1, v_next0, v_next1;
-      float v_acc_tmp0, v_acc_tmp1, v_t0, v_t1;
-      float v_tab_t[4];
-      int v_t;
-      int v_trellis;
-      const int *v_cr_punc;
-      int v_cr_p, v_cr_len;
-      uint8_t v_scramBits[DECODE_T_MAX];
-      uint8_t v_unCodedBits[DECODE_T_MAX];
-      boost::crc_32_type d_crc32;
-      uint8_t d_pktBytes[DECODE_B_MAX];
-      int d_dataLen;
+      decodeJob* d_job;
+      // workers, jobs are published in the order of their seq tags
+      int d_nWorker;
+      int d_nSegment;
+      int d_llrType;
+      int d_llrSize;
+      bool d_stop;
+      std::vector<std::thread> d_workers;
+      std::vector<decodeJob*> d_jobs;
+      std::vector<svDataDecoder*> d_segDecs;
+      std::deque<decodeJob*> d_jobFree;
+      std::deque<decodeJob*> d_jobQueue;
+      std::deque<decodeJob*> d_jobOrder;
+      std::mutex d_mutex;
+      std::condition_variable d_cvQueue;
+      std::condition_variable d_cvFree;
+      // packet, payloads are written into pooled blobs, meta keys are interned once
+      c8pBlobPool d_blobPool;
+      pmt::pmt_t d_pmtOut;
+      pmt::pmt_t d_pmtLen;
+      pmt::pmt_t d_pmtSeq;
       // debug
       uint64_t d_legacyMcsCount[8];
       uint64_t d_vhtMcsCount[10];
@@ -91,7 +124,7 @@ namespace gr {
 
 
     public:
-      decode_impl(bool ifdebug);
+      decode_impl(bool ifdebug, int tbdepth, int nworkers, int nsegments, int llrtype);
       ~decode_impl();
 
       // Where all the action really happens
@@ -102,11 +135,15 @@ namespace gr {
            gr_vector_const_void_star &input_items,
            gr_vector_void_star &output_items);
 
-      void vstb_init();
-      int vstb_update(const float* llr, int len);
-      void vstb_end();
-      void descramble();
-      void packetAssemble();
+      bool start();
+      bool stop();
+      void workerLoop(int id);
+      int decUpdate(svDataDecoder* dec, const uint8_t* llr, int len);
+      void jobDrain();
+      void jobPublish();
+      void packetAssemble(decodeJob* job);
+      void mpduPublish(decodeJob* job, const uint8_t* mpdu, int len, uint32_t crc);
+      void pktPublish(decodeJob* job, const uint8_t* mpdu, int len);
     };
 
   } // namespace ieee80211
@@ -22,8 +22,9 @@
 #define INCLUDED_IEEE80211_DEMOD2_IMPL_H
 
 #include <gnuradio/ieee80211/demod2.h>
-#include <gnuradio/fft/fft.h>
 #include "cloud80211phy.h"
+#include "cloud80211pkt.h"
+#include "cloud80211rx.h"
 
 #define dout d_debug&&std::cout
 
@@ -51,61 +52,19 @@ namespace gr {
       int d_sDemod;
       // received info from tag
       std::vector<gr::tag_t> tags;
+      c8pPktRing d_pktRing;
+      int d_nPktSeq;
       int d_nSigLMcs;
-      int d_nSigLLen;
-      std::vector<gr_complex> d_HL;
       int d_nSigLSamp;
       int d_nSampConsumed;
       float d_cfo;
       float d_snr;
       float d_rssi;
-      float d_sssnr0;    // spatial stream snr only for vht
-      float d_sssnr1;    // spatial stream snr only for vht
-      // check format
-      svSigDecoder d_decoder;
-      gr_complex d_sig1[64];
-      gr_complex d_sig2[64];
-      float d_sigHtIntedLlr[96];
-      float d_sigHtCodedLlr[96];
-      float d_sigVhtAIntedLlr[96];
-      float d_sigVhtACodedLlr[96];
-      float d_sigVhtB20IntedLlr[52];
-      float d_sigVhtB20CodedLlr[52];
-      uint8_t d_sigHtBits[48];
-      uint8_t d_sigVhtABits[48];
-      uint8_t d_sigVhtB20Bits[26];
-      gr_complex d_sigVhtBQam0[52];
-      gr_complex d_sigVhtBQam1[52];
-      uint8_t d_sigVhtB20BitsCoded[52];
-      uint8_t d_sigVhtB20BitsInted[52];
-      // fft
-      fft::fft_complex_fwd d_ofdm_fft;
-      gr_complex d_fftLtfOut1[64];
-      gr_complex d_fftLtfOut2[64];
-      gr_complex d_fftLtfOut12[64];
-      gr_complex d_fftLtfOut22[64];
-      // packet info
-      c8p_mod d_m;
-      c8p_sigHt d_sigHt;
-      c8p_sigVhtA d_sigVhtA;
-      int d_nSymProcd;
-      int d_unCoded;
-      int d_nTrellis;
-      // pilot
-      int d_pilotP;
-      float d_pilot[4];
-      float d_pilot2[4];
-      gr_complex d_pilotNlLtf[4];
-      gr_complex d_pilotNlLtf2[4];
-      // non-legacy channel
-      gr_complex d_H_NL[64][4];
-      gr_complex d_H_NL_INV[64][4];
-      gr_complex d_qam[2][52];
-      float d_llrInted[2][416];     // interleaved LLR
-      float d_llrSpasd[2][416];     // stream parsered LLR
+      // per packet demodulation
+      c8pRxDemod d_rx;
 
      public:
-      demod2_impl();
+      demod2_impl(int llrtype);
       ~demod2_impl();
 
       // Where all the action really happens
@@ -115,13 +74,6 @@ namespace gr {
            gr_vector_int &ninput_items,
            gr_vector_const_void_star &input_items,
            gr_vector_void_star &output_items);
-      void nonLegacyChanEstimate(const gr_complex* sig1, const gr_complex* sig2);
-      void vhtChanUpdate(const gr_complex* sig1, const gr_complex* sig2);
-      void htChanUpdate(const gr_complex* sig1, const gr_complex* sig2);
-      void legacyChanUpdate(const gr_complex* sig1);
-      void vhtSigBDemod(const gr_complex* sig1, const gr_complex* sig2);
-      void fftDemod(const gr_complex* sig, gr_complex* res);
-      void pilotShift(float* pilots);
 
     };
 
@@ -25,24 +25,22 @@ namespace gr {
   namespace ieee80211 {
 
     demod::sptr
-    demod::make(int mupos, int mugid)
+    demod::make(int mupos, int mugid, int llrtype)
     {
-      return gnuradio::make_block_sptr<demod_impl>(mupos, mugid
+      return gnuradio::make_block_sptr<demod_impl>(mupos, mugid, llrtype
         );
     }
 
-    demod_impl::demod_impl(int mupos, int mugid)
+    demod_impl::demod_impl(int mupos, int mugid, int llrtype)
       : gr::block("demod",
               gr::io_signature::make(1, 1, sizeof(gr_complex)),
-              gr::io_signature::make(1, 1, sizeof(float))),
-              d_muPos(mupos),
+              gr::io_signature::make(1, 1, llrItemSize(llrtype))),
               d_muGroupId(mugid),
-              d_ofdm_fft(64,1)
+              d_rx(llrtype, mupos)
     {
       d_nProc = 0;
       d_debug = false;
       d_sDemod = DEMOD_S_RDTAG;
-      d_HL = std::vector<gr_complex>(64, gr_complex(0.0f, 0.0f));
       set_tag_propagation_policy(block::TPP_DONT);
     }
 
@@ -63,7 +61,6 @@ namespace gr {
                        gr_vector_void_star &output_items)
     {
       const gr_complex* inSig1 = static_cast<const gr_complex*>(input_items[0]);
-      float* outLlrs = static_cast<float*>(output_items[0]);
       d_nProc = ninput_items[0];
       d_nGen = noutput_items;
 
@@ -73,21 +70,18 @@ namespace gr {
         {
           // tags, which input, start, end
           get_tags_in_range(tags, 0, nitems_read(0) , nitems_read(0) + 1);
-          if (tags.size())
+          c8p_pkt tmpPktCopy;
+          const c8p_pkt* tmpPkt = c8pPktFind(tags, &tmpPktCopy, d_debug);
+          if (tmpPkt)
           {
-            pmt::pmt_t d_meta = pmt::make_dict();
-            for (auto tag : tags){
-              d_meta = pmt::dict_add(d_meta, tag.key, tag.value);
-            }
-            d_cfo = pmt::to_float(pmt::dict_ref(d_meta, pmt::mp("cfo"), pmt::from_float(0.0f)));
-            d_snr = pmt::to_float(pmt::dict_ref(d_meta, pmt::mp("snr"), pmt::from_float(0.0f)));
-            d_rssi = pmt::to_float(pmt::dict_ref(d_meta, pmt::mp("rssi"), pmt::from_float(0.0f)));
-            int tmpPktSeq = pmt::to_long(pmt::dict_ref(d_meta, pmt::mp("seq"), pmt::from_long(-1)));
-            d_nSigLMcs = pmt::to_long(pmt::dict_ref(d_meta, pmt::mp("mcs"), pmt::from_long(-1)));
-            d_nSigLLen = pmt::to_long(pmt::dict_ref(d_meta, pmt::mp("len"), pmt::from_long(-1)));
-            d_nSigLSamp = pmt::to_long(pmt::dict_ref(d_meta, pmt::mp("nsamp"), pmt::from_long(-1)));
-            d_HL = pmt::c32vector_elements(pmt::dict_ref(d_meta, pmt::mp("chan"), pmt::PMT_NIL));
-            dout<<"ieee80211 demod, rd tag seq:"<<tmpPktSeq<<", mcs:"<<d_nSigLMcs<<", len:"<<d_nSigLLen<<", samp:"<<d_nSigLSamp<<std::endl;
+            d_cfo = tmpPkt->cfo;
+            d_snr = tmpPkt->snr;
+            d_rssi = tmpPkt->rssi;
+            d_nPktSeq = tmpPkt->seq;
+            d_nSigLMcs = tmpPkt->mcs;
+            d_nSigLSamp = tmpPkt->nSamp;
+            d_rx.init(tmpPkt->mcs, tmpPkt->len, tmpPkt->chan);
+            dout<<"ieee80211 demod, rd tag seq:"<<d_nPktSeq<<", mcs:"<<d_nSigLMcs<<", len:"<<tmpPkt->len<<", samp:"<<d_nSigLSamp<<std::endl;
             d_nSampConsumed = 0;
             d_nSigLSamp = d_nSigLSamp + 320;
             if(d_nSigLMcs > 0)
@@ -105,99 +99,59 @@ namespace gr {
 
         case DEMOD_S_FORMAT:
         {
-          if(d_nProc >= 160)
+          if(d_nProc >= C8P_RX_NL_SIG_SAMP)
           {
-            fftDemod(&inSig1[C8P_SYM_SAMP_SHIFT], d_fftLtfOut1);
-            fftDemod(&inSig1[C8P_SYM_SAMP_SHIFT+80], d_fftLtfOut2);
-            procNLSigDemodDeint(d_fftLtfOut1, d_fftLtfOut2, d_HL, d_sigHtCodedLlr, d_sigVhtACodedLlr);
-            d_decoder.decode(d_sigVhtACodedLlr, d_sigVhtABits, 48);
-            if(signalCheckVhtA(d_sigVhtABits))
+            int tmpFormat = d_rx.format(inSig1);
+            if(tmpFormat == C8P_F_VHT)
             {
               // go to vht
-              signalParserVhtA(d_sigVhtABits, &d_m, &d_sigVhtA);
-              dout<<"ieee80211 demod, vht a check pass nSS:"<<d_m.nSS<<", nLTF:"<<d_m.nLTF<<std::endl;
+              dout<<"ieee80211 demod, vht a check pass nSS:"<<d_rx.m.nSS<<" nLTF:"<<d_rx.m.nLTF<<std::endl;
               d_sDemod = DEMOD_S_VHT;
-              d_nSampConsumed += 160;
-              consume_each(160);
+              d_nSampConsumed += C8P_RX_NL_SIG_SAMP;
+              consume_each(C8P_RX_NL_SIG_SAMP);
               return 0;
             }
-            else
-            {
-              d_decoder.decode(d_sigHtCodedLlr, d_sigHtBits, 48);
-              if(signalCheckHt(d_sigHtBits))
-              {
-                // go to ht
-                signalParserHt(d_sigHtBits, &d_m, &d_sigHt);
-                dout<<"ieee80211 demod, ht check pass nSS:"<<d_m.nSS<<", nLTF:"<<d_m.nLTF<<", len:"<<d_m.len<<std::endl;
-                d_sDemod = DEMOD_S_HT;
-                d_nSampConsumed += 160;
-                consume_each(160);
-                return 0;
-              }
-              else
-              {
-                // go to legacy
-                d_sDemod = DEMOD_S_LEGACY;
-                consume_each(0);
-                return 0;
-              }
-            }
-          }
-          consume_each(0);
-          return 0;
-        }
-
-        case DEMOD_S_VHT:
-        {
-          if(d_nProc >= (80 + d_m.nLTF*80 + 80)) // STF, LTF, sig b
-          {
-            nonLegacyChanEstimate(&inSig1[80]);
-            vhtSigBDemod(&inSig1[80 + d_m.nLTF*80]);
-            signalParserVhtB(d_sigVhtB20Bits, &d_m);
-            dout<<"ieee80211 demod, vht b len:"<<d_m.len<<", mcs:"<<d_m.mcs<<", nSS:"<<d_m.nSS<<", nSym:"<<d_m.nSym<<std::endl;
-            int tmpNLegacySym = (d_nSigLLen*8 + 22 + 23)/24;
-            if(d_m.len >= 0 && d_m.len <= 4095 && d_m.nSS <= 2 && (tmpNLegacySym * 80) >= (d_m.nSym * d_m.nSymSamp + 160 + 80 + d_m.nLTF * 80 + 80))  // =0 for NDP
+            else if(tmpFormat == C8P_F_HT)
             {
-              d_unCoded = d_m.nSym * d_m.nDBPS;
-              d_nTrellis = d_m.nSym * d_m.nDBPS;
-              memcpy(d_pilot, PILOT_VHT, sizeof(float)*4);
-              d_pilotP = 4;
-              d_sDemod = DEMOD_S_WRTAG;
+              // go to ht
+              dout<<"ieee80211 demod, ht check pass nSS:"<<d_rx.m.nSS<<", nLTF:"<<d_rx.m.nLTF<<", len:"<<d_rx.m.len<<std::endl;
+              d_sDemod = DEMOD_S_HT;
+              d_nSampConsumed += C8P_RX_NL_SIG_SAMP;
+              consume_each(C8P_RX_NL_SIG_SAMP);
+              return 0;
             }
             else
             {
-              d_sDemod = DEMOD_S_CLEAN;
+              // go to legacy
+              d_sDemod = DEMOD_S_LEGACY;
+              consume_each(0);
+              return 0;
             }
-            // STF + n LTF + sig b
-            d_nSampConsumed += (80 + d_m.nLTF*80 + 80);
-            consume_each(80 + d_m.nLTF*80 + 80);
-            return 0;
           }
           consume_each(0);
           return 0;
         }
 
+        case DEMOD_S_VHT:
         case DEMOD_S_HT:
         {
-          if(d_nProc >= (80 + d_m.nLTF*80)) // STF, LTF, sig b
+          int tmpNSamp = d_rx.nonLegacySamp();    // STF, LTF, vht sig b
+          if(d_nProc >= tmpNSamp)
           {
-            nonLegacyChanEstimate(&inSig1[80]);
-            int tmpNLegacySym = (d_nSigLLen*8 + 22 + 23)/24;
-            if(d_m.len > 0 && d_m.len <= 4095 && d_m.nSS <= 2 && (tmpNLegacySym * 80) >= (d_m.nSym * d_m.nSymSamp + 160 + 80 + d_m.nLTF * 80))
+            if(d_rx.nonLegacy(inSig1, nullptr))
             {
-              d_unCoded = d_m.len * 8 + 22;
-              d_nTrellis = d_m.len * 8 + 22;
-              memcpy(d_pilot, PILOT_HT_1, sizeof(float)*4);
-              d_pilotP = 3;
               d_sDemod = DEMOD_S_WRTAG;
             }
             else
             {
-              dout<<"ieee80211 demod, ht packet length check fail"<<std::endl;
               d_sDemod = DEMOD_S_CLEAN;
             }
-            d_nSampConsumed += (80 + d_m.nLTF*80);
-            consume_each(80 + d_m.nLTF*80);
+            if(d_rx.m.format == C8P_F_VHT)
+            {
+              dout<<"ieee80211 demod, vht b len:"<<d_rx.m.len<<", mcs:"<<d_rx.m.mcs<<", nSS:"<<d_rx.m.nSS<<", nSym:"<<d_rx.m.nSym<<std::endl;
+            }
+            d_nSampConsumed += tmpNSamp;
+            consume_each(tmpNSamp);
             return 0;
           }
           consume_each(0);
@@ -206,12 +160,7 @@ namespace gr {
 
         case DEMOD_S_LEGACY:
         {
-          signalParserL(d_nSigLMcs, d_nSigLLen, &d_m);
-          d_unCoded = d_m.len*8 + 22;
-          d_nTrellis = d_m.len*8 + 22;
-          // config pilot
-          memcpy(d_pilot, PILOT_L, sizeof(float)*4);
-          d_pilotP = 1;
+          d_rx.legacy();
           dout<<"ieee80211 demod, legacy packet"<<std::endl;
           d_sDemod = DEMOD_S_WRTAG;
           consume_each(0);
@@ -220,49 +169,41 @@ namespace gr {
 
         case DEMOD_S_WRTAG:
         {
-          dout<<"ieee80211 demod, wr tag f:"<<d_m.format<<", ampdu:"<<d_m.ampdu<<", len:"<<d_m.len<<", mcs:"<<d_m.mcs<<", total:"<<d_m.nSym * d_m.nCBPS<<", tr:"<<d_nTrellis<<", nsym:"<<d_m.nSym<<", nSS:"<<d_m.nSS<<std::endl;
-          pmt::pmt_t dict = pmt::make_dict();
-          dict = pmt::dict_add(dict, pmt::mp("cfo"), pmt::from_float(d_cfo));
-          dict = pmt::dict_add(dict, pmt::mp("snr"), pmt::from_float(d_snr));
-          if(d_m.format == C8P_F_VHT)
+          c8p_mod& tmpM = d_rx.m;
+          dout<<"ieee80211 demod, wr tag f:"<<tmpM.format<<", ampdu:"<<tmpM.ampdu<<", len:"<<tmpM.len<<", mcs:"<<tmpM.mcs<<", total:"<<tmpM.nSym * tmpM.nCBPS<<", tr:"<<d_rx.nTrellis<<", nsym:"<<tmpM.nSym<<", nSS:"<<tmpM.nSS<<std::endl;
+          c8p_pkt* tmpPkt = d_pktRing.next();
+          tmpPkt->cfo = d_cfo;
+          tmpPkt->snr = d_snr;
+          tmpPkt->rssi = d_rssi;
+          if(tmpM.format == C8P_F_VHT)
           {
-            dict = pmt::dict_add(dict, pmt::mp("sssnr0"), pmt::from_float(d_sssnr));
+            tmpPkt->sssnr0 = d_rx.sssnr0;
           }
-          dict = pmt::dict_add(dict, pmt::mp("rssi"), pmt::from_float(d_rssi));
-          dict = pmt::dict_add(dict, pmt::mp("format"), pmt::from_long(d_m.format));
-          dict = pmt::dict_add(dict, pmt::mp("mcs"), pmt::from_long(d_m.mcs));
-          dict = pmt::dict_add(dict, pmt::mp("len"), pmt::from_long(d_m.len));
-          dict = pmt::dict_add(dict, pmt::mp("cr"), pmt::from_long(d_m.cr));
-          dict = pmt::dict_add(dict, pmt::mp("ampdu"), pmt::from_long(d_m.ampdu));
-          dict = pmt::dict_add(dict, pmt::mp("trellis"), pmt::from_long(d_nTrellis));
-          if(d_m.nSym == 0)
+          tmpPkt->format = tmpM.format;
+          tmpPkt->mcs = tmpM.mcs;
+          tmpPkt->len = tmpM.len;
+          tmpPkt->cr = tmpM.cr;
+          tmpPkt->ampdu = tmpM.ampdu;
+          tmpPkt->trellis = d_rx.nTrellis;
+          tmpPkt->seq = d_nPktSeq;
+          if(tmpM.nSym == 0)
           {
             // SISO has NDP
-            d_tagMu2x1Chan.clear();
-            d_tagMu2x1Chan.reserve(128);
-            for(int i=0;i<128;i++)
-            {
-              d_tagMu2x1Chan.push_back(d_mu2x1Chan[i]);
-            }
-            dict = pmt::dict_add(dict, pmt::mp("mu2x1chan"), pmt::init_c32vector(d_tagMu2x1Chan.size(), d_tagMu2x1Chan));
-            dict = pmt::dict_add(dict, pmt::mp("total"), pmt::from_long(1024));
+            tmpPkt->nChan = 128;
+            memcpy(tmpPkt->chan, d_rx.ndpChan, sizeof(gr_complex) * 128);
+            tmpPkt->total = 1024;
           }
           else
           {
-            dict = pmt::dict_add(dict, pmt::mp("total"), pmt::from_long(d_m.nSym * d_m.nCBPS));
-          }
-          
-          pmt::pmt_t pairs = pmt::dict_items(dict);
-          for (size_t i = 0; i < pmt::length(pairs); i++) {
-              pmt::pmt_t pair = pmt::nth(i, pairs);
-              add_item_tag(0,                   // output port index
-                            nitems_written(0),  // output sample index
-                            pmt::car(pair),
-                            pmt::cdr(pair),
-                            alias_pmt());
+            tmpPkt->total = tmpM.nSym * tmpM.nCBPS;
           }
+          add_item_tag(0,                   // output port index
+                        nitems_written(0),  // output sample index
+                        c8pPktKey(),
+                        d_pktRing.publish(nitems_written(0)),
+                        alias_pmt());
 
-          if(d_m.nSym == 0)
+          if(tmpM.nSym == 0)
           {
             // SISO has NDP
             d_sDemod = DEMOD_S_CLEAN;
@@ -270,7 +211,7 @@ namespace gr {
             return 1024;
           }
 
-          d_nSymProcd = 0;
+          d_rx.prep(d_snr);
           d_sDemod = DEMOD_S_DEMOD;
           consume_each(0);
           return 0;
@@ -278,39 +219,20 @@ namespace gr {
 
         case DEMOD_S_DEMOD:
         {
-          int o1 = 0;
-          int o2 = 0;
-          while(((o1 + d_m.nSymSamp) < d_nProc) && ((o2 + d_m.nCBPS) < d_nGen) && (d_nSymProcd < d_m.nSym))
+          const c8p_mod& tmpM = d_rx.m;
+          int tmpNSym = 0;
+          while((((tmpNSym + 1) * tmpM.nSymSamp) < d_nProc) && (((tmpNSym + 1) * tmpM.nCBPS) < d_nGen) && ((d_rx.nSymProcd + tmpNSym) < tmpM.nSym))
           {
-            if(d_m.format == C8P_F_L)
-            {
-              legacyChanUpdate(&inSig1[o1]);
-              procSymQamToLlr(d_qam, d_llrInted, &d_m);
-              procSymDeintL2(d_llrInted, &outLlrs[o2], &d_m);
-            }
-            else
-            {
-              nonLegacyChanUpdate(&inSig1[o1]);
-              procSymQamToLlr(d_qam, d_llrInted, &d_m);
-              procSymDeintNL2SS1(d_llrInted, &outLlrs[o2], &d_m);
-            }
-
-            d_nSymProcd += 1;
-            o1 += d_m.nSymSamp;
-            o2 += d_m.nCBPS;
-            if(d_nSymProcd >= d_m.nSym)
-            {
-              d_sDemod = DEMOD_S_CLEAN;
-              break;
-            }
+            tmpNSym++;
           }
-          if(d_nSymProcd >= d_m.nSym)
+          d_rx.demod(inSig1, nullptr, tmpNSym, output_items[0]);
+          if(d_rx.nSymProcd >= tmpM.nSym)
           {
             d_sDemod = DEMOD_S_CLEAN;
           }
-          d_nSampConsumed += o1;
-          consume_each (o1);
-          return (o2);
+          d_nSampConsumed += tmpNSym * tmpM.nSymSamp;
+          consume_each (tmpNSym * tmpM.nSymSamp);
+          return (tmpNSym * tmpM.nCBPS);
         }
 
         case DEMOD_S_CLEAN:
@@ -341,220 +263,5 @@ namespace gr {
       return (0);
     }
 
-    void
-    demod_impl::nonLegacyChanEstimate(const gr_complex* sig1)
-    {
-      if(d_m.format == C8P_F_VHT && d_m.sumu)
-      {
-        // mu-mimo 2x2
-        dout<<"non legacy mu-mimo channel estimate"<<std::endl;
-        fftDemod(&sig1[C8P_SYM_SAMP_SHIFT], d_fftLtfOut1);
-        fftDemod(&sig1[C8P_SYM_SAMP_SHIFT+80], d_fftLtfOut2);
-        if(d_muPos == 0)  // pos 0
-        {
-          for(int i=0;i<64;i++)
-          {
-            if(i==0 || (i>=29 && i<=35))
-            {}
-            else
-            {
-              // d_H_NL[i] = d_fftLtfOut1[i] / LTF_NL_28_F_FLOAT[i];
-              d_H_NL[i] = (d_fftLtfOut1[i]-d_fftLtfOut2[i]) / (LTF_NL_28_F_FLOAT[i] * 2.0f);
-            }
-          }
-        }
-        else  // pos 1
-        {
-          for(int i=0;i<64;i++)
-          {
-            if(i==0 || (i>=29 && i<=35))
-            {}
-            else
-            {
-              // d_H_NL[i] = d_fftLtfOut1[i] / LTF_NL_28_F_FLOAT[i];
-              d_H_NL[i] = (d_fftLtfOut1[i]/LTF_NL_28_F_FLOAT[i] + d_fftLtfOut2[i]/LTF_NL_28_F_FLOAT_VHT22[i]) / 2.0f;
-            }
-          }
-        }
-      }
-      else if(d_m.nSS == 1 && d_m.nLTF == 1)
-      {
-        fftDemod(&sig1[C8P_SYM_SAMP_SHIFT], d_fftLtfOut1);
-        for(int i=0;i<64;i++)
-        {
-          if(i==0 || (i>=29 && i<=35))
-          {}
-          else
-          {
-            d_H_NL[i] = d_fftLtfOut1[i] / LTF_NL_28_F_FLOAT[i];
-          }
-        }
-      }
-      else
-      {
-        // nSS larger than 1, only support 2x2 channel sounding now
-        dout<<"non legacy 2x2 mimo channel sounding"<<std::endl;
-        memcpy(&d_mu2x1Chan[0], &sig1[C8P_SYM_SAMP_SHIFT], sizeof(gr_complex) * 64);
-        memcpy(&d_mu2x1Chan[64], &sig1[C8P_SYM_SAMP_SHIFT+80], sizeof(gr_complex) * 64);
-        fftDemod(&sig1[C8P_SYM_SAMP_SHIFT], d_fftLtfOut1);
-        for(int i=0;i<64;i++)
-        {
-          if(i==0 || (i>=29 && i<=35))
-          {
-          }
-          else
-          {
-            d_H_NL[i] = d_fftLtfOut1[i] / LTF_NL_28_F_FLOAT[i];
-          }
-        }
-      }
-    }
-
-    void
-    demod_impl::nonLegacyChanUpdate(const gr_complex* sig1)
-    {
-      fftDemod(&sig1[C8P_SYM_SAMP_SHIFT], d_fftLtfOut1);
-      for(int i=0;i<64;i++)
-      {
-        if(i==0 || (i>=29 && i<=35))
-        {}
-        else
-        {
-          d_sig1[i] = d_fftLtfOut1[i] / d_H_NL[i];
-        }
-      }
-      gr_complex tmpPilotSum = std::conj(
-        d_sig1[7]*d_pilot[2]*PILOT_P[d_pilotP] + 
-        d_sig1[21]*d_pilot[3]*PILOT_P[d_pilotP] + 
-        d_sig1[43]*d_pilot[0]*PILOT_P[d_pilotP] + 
-        d_sig1[57]*d_pilot[1]*PILOT_P[d_pilotP]);
-      pilotShift(d_pilot);
-      d_pilotP = (d_pilotP + 1) % 127;
-      float tmpPilotSumAbs = std::abs(tmpPilotSum);
-      int j=26;
-      for(int i=0;i<64;i++)
-      {
-        if(i==0 || (i>=29 && i<=35) || i==7 || i==21 || i==43 || i==57)
-        {
-        }
-        else
-        {
-          d_qam[j] = d_sig1[i] * tmpPilotSum / tmpPilotSumAbs;
-          j++;
-          if(j >= 52){j = 0;}
-        }
-      }
-    }
-
-    void
-    demod_impl::vhtSigBDemod(const gr_complex* sig1)
-    {
-      if(d_m.nSS > 1)
-      {
-        dout<<"ieee80211 demod, 1 ant demod sig b check if NDP"<<std::endl;
-      }
-      fftDemod(&sig1[C8P_SYM_SAMP_SHIFT], d_fftLtfOut1);
-      for(int i=0;i<64;i++)
-      {
-        if(i==0 || (i>=29 && i<=35))
-        {}
-        else
-        {
-          d_sig1[i] = d_fftLtfOut1[i] / d_H_NL[i];
-        }
-      }
-      gr_complex tmpPilotSum = std::conj(d_sig1[7] - d_sig1[21] + d_sig1[43] + d_sig1[57]);
-      float tmpPilotSumAbs = std::abs(tmpPilotSum);
-      
-      int j=26;
-      for(int i=0;i<64;i++)
-      {
-        if(i==0 || (i>=29 && i<=35) || i==7 || i==21 || i==43 || i==57)
-        {}
-        else
-        {
-          d_sigVhtBQam[j] = d_sig1[i] * tmpPilotSum / tmpPilotSumAbs;
-          d_sigVhtB20IntedLlr[j] = d_sigVhtBQam[j].real();
-          j++;
-          if(j >= 52){j = 0;}
-        }
-      }
-      
-      for(int i=0;i<52;i++)
-      {
-        d_sigVhtB20CodedLlr[mapDeintVhtSigB20[i]] = d_sigVhtB20IntedLlr[i];
-      }
-      d_decoder.decode(d_sigVhtB20CodedLlr, d_sigVhtB20Bits, 26);
-
-      bccEncoder(d_sigVhtB20Bits, d_sigVhtB20BitsCoded, 26);
-      procIntelVhtB20(d_sigVhtB20BitsCoded, d_sigVhtB20BitsInted);
-      double tmpNoisePower = 0.0;
-      for(int i=0;i<52;i++)
-      {
-        if(d_sigVhtB20BitsInted[i])
-        {
-          d_sigVhtBQam[i] -= gr_complex(1.0f, 0.0f);
-        }
-        else
-        {
-          d_sigVhtBQam[i] -= gr_complex(-1.0f, 0.0f);
-        }
-        tmpNoisePower += (double)(d_sigVhtBQam[i].real()*d_sigVhtBQam[i].real() + d_sigVhtBQam[i].imag() * d_sigVhtBQam[i].imag());
-      }
-      d_sssnr = (float)(log10(52.0/tmpNoisePower) * 10.0);
-    }
-
-    void
-    demod_impl::legacyChanUpdate(const gr_complex* sig1)
-    {
-      fftDemod(&sig1[C8P_SYM_SAMP_SHIFT], d_fftLtfOut1);
-      for(int i=0;i<64;i++)
-      {
-        if(i==0 || (i>=27 && i<=37))
-        {}
-        else
-        {
-          d_sig1[i] = d_fftLtfOut1[i] / d_HL[i];
-        }
-      }
-      gr_complex tmpPilotSum = std::conj(
-        d_sig1[7]*d_pilot[2]*PILOT_P[d_pilotP] + 
-        d_sig1[21]*d_pilot[3]*PILOT_P[d_pilotP] + 
-        d_sig1[43]*d_pilot[0]*PILOT_P[d_pilotP] + 
-        d_sig1[57]*d_pilot[1]*PILOT_P[d_pilotP]);
-      d_pilotP = (d_pilotP + 1) % 127;
-      float tmpPilotSumAbs = std::abs(tmpPilotSum);
-      int j=24;
-      for(int i=0;i<64;i++)
-      {
-        if(i==0 || (i>=27 && i<=37) || i==7 || i==21 || i==43 || i==57)
-        {}
-        else
-        {
-          d_qam[j] = d_sig1[i] * tmpPilotSum / tmpPilotSumAbs;
-          j++;
-          if(j >= 48){j = 0;}
-        }
-      }
-    }
-
-    void
-    demod_impl::fftDemod(const gr_complex* sig, gr_complex* res)
-    {
-      memcpy(d_ofdm_fft.get_inbuf(), sig, sizeof(gr_complex)*64);
-      d_ofdm_fft.execute();
-      memcpy(res, d_ofdm_fft.get_outbuf(), sizeof(gr_complex)*64);
-    }
-
-    void
-    demod_impl::pilotShift(float* pilots)
-    {
-      float tmpPilot = pilots[0];
-      pilots[0] = pilots[1];
-      pilots[1] = pilots[2];
-      pilots[2] = pilots[3];
-      pilots[3] = tmpPilot;
-    }
-
   } /* namespace ieee80211 */
 } /* namespace gr */
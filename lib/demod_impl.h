@@ -22,8 +22,9 @@
 #define INCLUDED_IEEE80211_DEMOD_IMPL_H
 
 #include <gnuradio/ieee80211/demod.h>
-#include <gnuradio/fft/fft.h>
 #include "cloud80211phy.h"
+#include "cloud80211pkt.h"
+#include "cloud80211rx.h"
 
 #define dout d_debug&&std::cout
 
@@ -49,58 +50,22 @@ namespace gr {
       int d_nGen;
       int d_sDemod;
       // parameters
-      int d_muPos;
       int d_muGroupId;
       // received info from tag
       std::vector<gr::tag_t> tags;
+      c8pPktRing d_pktRing;
+      int d_nPktSeq;
       int d_nSigLMcs;
-      int d_nSigLLen;
-      std::vector<gr_complex> d_HL;
       int d_nSigLSamp;
       int d_nSampConsumed;
       float d_cfo;
       float d_snr;
       float d_rssi;
-      float d_sssnr;    // spatial stream snr only for vht
-      // check format
-      svSigDecoder d_decoder;
-      gr_complex d_sig1[64];
-      gr_complex d_sig2[64];
-      float d_sigHtIntedLlr[96];
-      float d_sigHtCodedLlr[96];
-      float d_sigVhtAIntedLlr[96];
-      float d_sigVhtACodedLlr[96];
-      float d_sigVhtB20IntedLlr[52];
-      float d_sigVhtB20CodedLlr[52];
-      uint8_t d_sigHtBits[48];
-      uint8_t d_sigVhtABits[48];
-      uint8_t d_sigVhtB20Bits[26];
-      gr_complex d_sigVhtBQam[52];
-      uint8_t d_sigVhtB20BitsCoded[52];
-      uint8_t d_sigVhtB20BitsInted[52];
-      // fft
-      fft::fft_complex_fwd d_ofdm_fft;
-      gr_complex d_fftLtfOut1[64];
-      gr_complex d_fftLtfOut2[64];
-      // packet info
-      c8p_mod d_m;
-      c8p_sigHt d_sigHt;
-      c8p_sigVhtA d_sigVhtA;
-      gr_complex d_mu2x1Chan[128];
-      std::vector<gr_complex> d_tagMu2x1Chan;
-      int d_nSymProcd;
-      int d_unCoded;
-      int d_nTrellis;
-      // pilot
-      int d_pilotP;
-      float d_pilot[4];
-      // non-legacy channel
-      gr_complex d_H_NL[64];
-      gr_complex d_qam[52];
-      float d_llrInted[416];
+      // per packet demodulation, one antenna
+      c8pRxDemod d_rx;
 
      public:
-      demod_impl(int mupos, int mugid);
+      demod_impl(int mupos, int mugid, int llrtype);
       ~demod_impl();
 
       // Where all the action really happens
@@ -110,12 +75,6 @@ namespace gr {
            gr_vector_int &ninput_items,
            gr_vector_const_void_star &input_items,
            gr_vector_void_star &output_items);
-      void nonLegacyChanEstimate(const gr_complex* sig1);
-      void nonLegacyChanUpdate(const gr_complex* sig1);
-      void legacyChanUpdate(const gr_complex* sig1);
-      void vhtSigBDemod(const gr_complex* sig1);
-      void fftDemod(const gr_complex* sig, gr_complex* res);
-      void pilotShift(float* pilots);
     };
 
   } // namespace ieee80211
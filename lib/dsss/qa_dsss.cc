@@ -63,6 +63,32 @@ BOOST_AUTO_TEST_CASE(test_fcs_validation)
     BOOST_CHECK(!utils::validate_fcs(frame, 100));
 }
 
+BOOST_AUTO_TEST_CASE(test_crc32_incremental)
+{
+    // Standard CRC-32 check value
+    const uint8_t check[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+    BOOST_CHECK_EQUAL(utils::calc_fcs(check, sizeof(check)), 0xCBF43926u);
+
+    // Long enough for the folding path, odd length for the tail bytes
+    std::vector<uint8_t> frame(1503);
+    for (size_t i = 0; i < frame.size(); i++) {
+        frame[i] = static_cast<uint8_t>(i * 37 + 11);
+    }
+    uint32_t fcs = utils::calc_fcs(frame.data(), frame.size());
+
+    // Any split fed in pieces gives the same CRC
+    for (size_t cut : { 0, 1, 7, 64, 77, 1000, 1503 }) {
+        uint32_t crc = utils::crc32_update(0, frame.data(), cut);
+        crc = utils::crc32_update(crc, frame.data() + cut, frame.size() - cut);
+        BOOST_CHECK_EQUAL(crc, fcs);
+    }
+
+    // CRC over the frame with its FCS is the fixed residue
+    frame.resize(frame.size() + 4);
+    memcpy(&frame[1503], &fcs, 4);
+    BOOST_CHECK_EQUAL(utils::crc32_update(0, frame.data(), frame.size()), 0x2144DF1Cu);
+}
+
 BOOST_AUTO_TEST_CASE(test_plcp_crc16)
 {
     // Test PLCP header CRC-16
@@ -202,6 +202,8 @@ namespace gr {
             procSymIntelNL2SS1(&d_bitsPunct[i*d_m.nCBPS], &d_bitsInted1[i*d_m.nCBPS], &d_m);
           }
           bitsToChips(d_bitsInted1, d_chips1, &d_m);
+          d_chipsP0 = d_chips0;
+          d_chipsP1 = d_chips1;
           d_nSampTotal = d_m.nSym * d_m.nSD + ENCODE_GR_PAD;
           d_nSampCopied = 0;
 
@@ -217,112 +219,19 @@ namespace gr {
         }
         else
         {
-          // signal part
-          formatToModSu(&d_m, d_pktFormat, d_pktMcs0, d_pktNss0, d_pktLen0);
-          if(d_pktFormat == C8P_F_L)
+          d_enc.run(d_pktFormat, d_pktMcs0, d_pktNss0, d_pkt, d_pktLen0);
+          d_m = d_enc.m;
+          d_chipsP0 = d_enc.chips0;
+          d_chipsP1 = d_enc.chips1;
+          if(d_pktFormat != C8P_F_L)
           {
-            legacySigBitsGen(d_sigBitsL, d_sigBitsCodedL, d_m.mcs, d_m.len);
-            procIntelLegacyBpsk(d_sigBitsCodedL, &d_sigBitsIntedL[0]);
-            memset(d_bits0, 0, 16);   // service bits
+            dict = pmt::dict_add(dict, pmt::mp("signl"), pmt::init_u8vector(96, d_enc.sigIntedNL));
           }
-          else if(d_pktFormat == C8P_F_VHT)
+          if(d_pktFormat == C8P_F_VHT)
           {
-            vhtSigABitsGen(d_sigBitsNL, d_sigBitsCodedNL, &d_m);
-            procIntelLegacyBpsk(&d_sigBitsCodedNL[0], &d_sigBitsIntedNL[0]);
-            procIntelLegacyBpsk(&d_sigBitsCodedNL[48], &d_sigBitsIntedNL[48]);
-            memset(d_bits0, 0, 8);
-            vhtSigB20BitsGenSU(d_sigBitsB0, d_sigBitsCodedB0, &d_bits0[8], &d_m);   // servcie bits sig b crc
-            procIntelVhtB20(d_sigBitsCodedB0, &d_sigBitsIntedB0[0]);
-            dict = pmt::dict_add(dict, pmt::mp("signl"), pmt::init_u8vector(d_sigBitsIntedNL.size(), d_sigBitsIntedNL));
-            dict = pmt::dict_add(dict, pmt::mp("sigb0"), pmt::init_u8vector(d_sigBitsIntedB0.size(), d_sigBitsIntedB0));
-            // legacy training 16, legacy sig 4, vhtsiga 8, vht training 4+4n, vhtsigb, payload, no short GI
-            int tmpTxTime = 20 + 8 + 4 + d_m.nLTF * 4 + 4 + d_m.nSym * 4;
-            int tmpLegacyLen = ((tmpTxTime - 20) / 4 + (((tmpTxTime - 20) % 4) != 0)) * 3 - 3;
-            legacySigBitsGen(d_sigBitsL, d_sigBitsCodedL, 0, tmpLegacyLen);
-            procIntelLegacyBpsk(d_sigBitsCodedL, &d_sigBitsIntedL[0]);
-          }
-          else
-          {
-            htSigBitsGen(d_sigBitsNL, d_sigBitsCodedNL, &d_m);
-            procIntelLegacyBpsk(&d_sigBitsCodedNL[0], &d_sigBitsIntedNL[0]);
-            procIntelLegacyBpsk(&d_sigBitsCodedNL[48], &d_sigBitsIntedNL[48]);
-            dict = pmt::dict_add(dict, pmt::mp("signl"), pmt::init_u8vector(d_sigBitsIntedNL.size(), d_sigBitsIntedNL));
-            // legacy training and sig 20, htsig 8, ht training 4+4n, payload, no short GI
-            int tmpTxTime = 20 + 8 + 4 + d_m.nLTF * 4 + d_m.nSym * 4;
-            int tmpLegacyLen = ((tmpTxTime - 20) / 4 + (((tmpTxTime - 20) % 4) != 0)) * 3 - 3;
-            legacySigBitsGen(d_sigBitsL, d_sigBitsCodedL, 0, tmpLegacyLen);
-            procIntelLegacyBpsk(d_sigBitsCodedL, &d_sigBitsIntedL[0]);
-            memset(d_bits0, 0, 16); // service bits
-          }
-          dict = pmt::dict_add(dict, pmt::mp("sigl"), pmt::init_u8vector(d_sigBitsIntedL.size(), d_sigBitsIntedL));
-
-          // psdu
-          if(d_m.len > 0)
-          {
-            int tmpDataP = 16;
-            for(int i=0;i<d_m.len;i++)
-            {
-              for(int j=0;j<8;j++)
-              {
-                d_bits0[tmpDataP] = (d_pkt[i] >> j) & 0x01;
-                tmpDataP++;
-              }
-            }
-            if(d_m.format == C8P_F_VHT)
-            {
-              int tmpPsduLen = (d_m.nSym * d_m.nDBPS - 16 - 6) / 8;           // 20M 2x2, nES is still 1
-              for(int i=0;i<((tmpPsduLen - d_m.len)/4);i++)
-              {
-                memcpy(&d_bits0[tmpDataP], EOF_PAD_SUBFRAME, sizeof(uint8_t) * 32);     // eof padding
-                tmpDataP += 32;
-              }
-              memset(&d_bits0[tmpDataP], 0, ((tmpPsduLen - d_m.len)%4) * 8 * sizeof(uint8_t));  // padding octets
-              tmpDataP += (((tmpPsduLen - d_m.len)%4) * 8);
-              memset(&d_bits0[tmpDataP], 0, (d_m.nSym * d_m.nDBPS - tmpPsduLen*8 - 16));        // padding bits and tail
-              scramEncoder2(d_bits0, (d_m.nSym * d_m.nDBPS - 6), 93);  // scrambling
-            }
-            else
-            {
-              memset(&d_bits0[tmpDataP], 0, 6);   // legacy and ht tail
-              tmpDataP += 6;
-              memset(&d_bits0[tmpDataP], 0, (d_m.nSym * d_m.nDBPS - 22 - d_m.len*8));   // legacy and ht pad
-              scramEncoder2(d_bits0, (d_m.nSym * d_m.nDBPS), 93);
-              memset(&d_bits0[d_m.len * 8 + 16], 0, 6);
-            }
-            bccEncoder(d_bits0, d_bitsCoded, d_m.nSym * d_m.nDBPS);   // binary convolutional coding
-            punctEncoder(d_bitsCoded, d_bitsPunct, d_m.nSym * d_m.nDBPS * 2, &d_m);   // puncturing
-            if(d_m.nSS == 1)
-            {
-              if(d_m.format == C8P_F_L)
-              {
-                for(int i=0;i<d_m.nSym;i++)
-                {
-                  procSymIntelL2(&d_bitsPunct[i*d_m.nCBPS], &d_bitsInted0[i*d_m.nCBPS], &d_m);
-                }
-              }
-              else
-              {
-                for(int i=0;i<d_m.nSym;i++)
-                {
-                  procSymIntelNL2SS1(&d_bitsPunct[i*d_m.nCBPS], &d_bitsInted0[i*d_m.nCBPS], &d_m);
-                }
-              }
-              bitsToChips(d_bitsInted0, d_chips0, &d_m);
-            }
-            else
-            {
-              // stream parser first
-              streamParser2(d_bitsPunct, d_bitsStream0, d_bitsStream1, d_m.nSym * d_m.nCBPS, &d_m);
-              // interleave
-              for(int i=0;i<d_m.nSym;i++)
-              {
-                procSymIntelNL2SS1(&d_bitsStream0[i*d_m.nCBPSS], &d_bitsInted0[i*d_m.nCBPSS], &d_m);
-                procSymIntelNL2SS2(&d_bitsStream1[i*d_m.nCBPSS], &d_bitsInted1[i*d_m.nCBPSS], &d_m);
-              }
-              bitsToChips(d_bitsInted0, d_chips0, &d_m);
-              bitsToChips(d_bitsInted1, d_chips1, &d_m);
-            }
+            dict = pmt::dict_add(dict, pmt::mp("sigb0"), pmt::init_u8vector(52, d_enc.sigIntedB0));
           }
+          dict = pmt::dict_add(dict, pmt::mp("sigl"), pmt::init_u8vector(48, d_enc.sigIntedL));
           d_nSampTotal = d_m.nSym * d_m.nSD + ENCODE_GR_PAD;
           d_nSampCopied = 0;
 
@@ -349,10 +258,10 @@ namespace gr {
       {
         if(d_nGen < (d_nSampTotal - d_nSampCopied))
         {
-          memcpy(outChips0, d_chips0 + d_nSampCopied, d_nGen * sizeof(uint8_t));
+          memcpy(outChips0, d_chipsP0 + d_nSampCopied, d_nGen * sizeof(uint8_t));
           if(d_m.nSS == 2)
           {
-            memcpy(outChips1, d_chips1 + d_nSampCopied, d_nGen * sizeof(uint8_t));
+            memcpy(outChips1, d_chipsP1 + d_nSampCopied, d_nGen * sizeof(uint8_t));
           }
 
           d_nPassed += d_nGen;
@@ -360,10 +269,10 @@ namespace gr {
         }
         else
         {
-          memcpy(outChips0, d_chips0 + d_nSampCopied, (d_nSampTotal - d_nSampCopied) * sizeof(uint8_t));
+          memcpy(outChips0, d_chipsP0 + d_nSampCopied, (d_nSampTotal - d_nSampCopied) * sizeof(uint8_t));
           if(d_m.nSS == 2)
           {
-            memcpy(outChips1, d_chips1 + d_nSampCopied, (d_nSampTotal - d_nSampCopied) * sizeof(uint8_t));
+            memcpy(outChips1, d_chipsP1 + d_nSampCopied, (d_nSampTotal - d_nSampCopied) * sizeof(uint8_t));
           }
           d_nPassed += (d_nSampTotal - d_nSampCopied);
           d_nSampCopied = d_nSampTotal;
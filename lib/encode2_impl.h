@@ -23,6 +23,7 @@
 
 #include <gnuradio/ieee80211/encode2.h>
 #include "cloud80211phy.h"
+#include "cloud80211tx.h"
 
 #define ENCODE_S_RDTAG 1
 #define ENCODE_S_RDPKT 2
@@ -73,14 +74,16 @@ namespace gr {
       uint8_t d_bits1[32864];
       uint8_t d_bitsCoded[65728];
       uint8_t d_bitsPunct[65728];
-      uint8_t d_bitsStream0[65728];
-      uint8_t d_bitsStream1[65728];
       uint8_t d_bitsInted0[65728];
       uint8_t d_bitsInted1[65728];
       uint8_t d_chips0[65728];
       uint8_t d_chips1[65728];
       c8p_mod d_m;
+      // single user packets
+      c8pTxEncoder d_enc;
       // copy samples out
+      uint8_t* d_chipsP0;
+      uint8_t* d_chipsP1;
       int d_nSampTotal;
       int d_nSampCopied;
 
@@ -44,65 +44,9 @@ namespace gr {
       d_debug = false;
       message_port_register_in(pmt::mp("pdus"));
       set_msg_handler(pmt::mp("pdus"), boost::bind(&modulation2_impl::msgRead, this, _1));
-      // prepare training fields
-      gr_complex tmpSig[64];
-      memset((uint8_t*)d_sigl, 0, sizeof(gr_complex) * 64);
-      memset((uint8_t*)d_signl, 0, sizeof(gr_complex) * 384);
-      memset((uint8_t*)d_signl0, 0, sizeof(gr_complex) * 448);
-      memset((uint8_t*)d_signl1, 0, sizeof(gr_complex) * 448);
-      memset((uint8_t*)d_signl1vht, 0, sizeof(gr_complex) * 448);
+      // training fields and pilots are in d_mod, the mu ones are set by the bfq message
       memset((uint8_t*)d_signl0mu, 0, sizeof(gr_complex) * 448);
       memset((uint8_t*)d_signl1mu, 0, sizeof(gr_complex) * 448);
-      // non legacy stf
-      memcpy(d_signl+192, C8P_STF_F, sizeof(gr_complex) * 64);
-      memcpy(d_signl0+192, C8P_STF_F, sizeof(gr_complex) * 64);
-      memcpy(tmpSig, C8P_STF_F, sizeof(gr_complex) * 64);
-      procCSD(tmpSig, -200);
-      memcpy(d_signl1+192, tmpSig, sizeof(gr_complex) * 64);
-      memcpy(d_signl1vht+192, tmpSig, sizeof(gr_complex) * 64);
-      // non legacy ltf
-      memcpy(d_signl+256, C8P_LTF_NL_F, sizeof(gr_complex) * 64);
-      memcpy(d_signl0+256, C8P_LTF_NL_F, sizeof(gr_complex) * 64);
-      memcpy(d_signl0+320, C8P_LTF_NL_F_N, sizeof(gr_complex) * 64);
-      memcpy(tmpSig, C8P_LTF_NL_F, sizeof(gr_complex) * 64);
-      procCSD(tmpSig, -400);
-      memcpy(d_signl1+256, tmpSig, sizeof(gr_complex) * 64);
-      memcpy(d_signl1+320, tmpSig, sizeof(gr_complex) * 64);
-      memcpy(d_signl1vht+256, tmpSig, sizeof(gr_complex) * 64);
-      memcpy(tmpSig, C8P_LTF_NL_F_VHT22, sizeof(gr_complex) * 64);
-      procCSD(tmpSig, -400);
-      memcpy(d_signl1vht+320, tmpSig, sizeof(gr_complex) * 64);
-      gr_complex tmpPilotL[4] = {gr_complex(1.0f, 0.0f), gr_complex(1.0f, 0.0f), gr_complex(1.0f, 0.0f), gr_complex(-1.0f, 0.0f)};
-      gr_complex tmpPilotNL[4] = {gr_complex(1.0f, 0.0f), gr_complex(1.0f, 0.0f), gr_complex(1.0f, 0.0f), gr_complex(-1.0f, 0.0f)};
-      gr_complex tmpPilotHT20[4] = {gr_complex(1.0f, 0.0f), gr_complex(1.0f, 0.0f), gr_complex(-1.0f, 0.0f), gr_complex(-1.0f, 0.0f)};
-      gr_complex tmpPilotHT21[4] = {gr_complex(1.0f, 0.0f), gr_complex(-1.0f, 0.0f), gr_complex(-1.0f, 0.0f), gr_complex(1.0f, 0.0f)};
-      for(int i=0;i<1408;i++)
-      {
-        for(int j=0;j<4;j++)
-        {
-          d_pilotsL[i][j] = tmpPilotL[j] * PILOT_P[(i+1)%127];
-          d_pilotsHT[i][j] = tmpPilotNL[j] * PILOT_P[(i+3)%127];
-          d_pilotsVHT[i][j] = tmpPilotNL[j] * PILOT_P[(i+4)%127];
-          d_pilotsHT20[i][j] = tmpPilotHT20[j] * PILOT_P[(i+3)%127];
-          d_pilotsHT21[i][j] = tmpPilotHT21[j] * PILOT_P[(i+3)%127];
-        }
-        gr_complex tmpPilot;
-        tmpPilot = tmpPilotNL[0];
-        tmpPilotNL[0] = tmpPilotNL[1];
-        tmpPilotNL[1] = tmpPilotNL[2];
-        tmpPilotNL[2] = tmpPilotNL[3];
-        tmpPilotNL[3] = tmpPilot;
-        tmpPilot = tmpPilotHT20[0];
-        tmpPilotHT20[0] = tmpPilotHT20[1];
-        tmpPilotHT20[1] = tmpPilotHT20[2];
-        tmpPilotHT20[2] = tmpPilotHT20[3];
-        tmpPilotHT20[3] = tmpPilot;
-        tmpPilot = tmpPilotHT21[0];
-        tmpPilotHT21[0] = tmpPilotHT21[1];
-        tmpPilotHT21[1] = tmpPilotHT21[2];
-        tmpPilotHT21[2] = tmpPilotHT21[3];
-        tmpPilotHT21[3] = tmpPilot;
-      }
     }
 
     void
@@ -118,8 +62,8 @@ namespace gr {
       {
         std::cout<<"ieee80211 mod, get bfq"<<std::endl;
         memcpy((uint8_t*) d_vhtMuBfQ, (tmpPkt + 1), sizeof(gr_complex) * 256);
-        memcpy(d_signl0mu+192, d_signl0+192, sizeof(gr_complex) * 192);
-        memcpy(d_signl1mu+192, d_signl1vht+192, sizeof(gr_complex) * 192);
+        memcpy(d_signl0mu+192, d_mod.signl0+192, sizeof(gr_complex) * 192);
+        memcpy(d_signl1mu+192, d_mod.signl1vht+192, sizeof(gr_complex) * 192);
         procNss2SymBfQ(d_signl0mu+192, d_signl1mu+192, d_vhtMuBfQ);
         procNss2SymBfQ(d_signl0mu+256, d_signl1mu+256, d_vhtMuBfQ);
         procNss2SymBfQ(d_signl0mu+320, d_signl1mu+320, d_vhtMuBfQ);
@@ -213,87 +157,20 @@ namespace gr {
             formatToModSu(&d_m, d_pktFormat, d_pktMcs0, d_pktNss0, d_pktLen0);
             d_nSymCopied = 0;
             d_nSampSigCopied = 0;
-            if(d_pktFormat == C8P_F_VHT)
-            {
-              d_sigBitsIntedNL = pmt::u8vector_elements(pmt::dict_ref(d_meta, pmt::mp("signl"), pmt::PMT_NIL));
-              d_sigBitsIntedB0 = pmt::u8vector_elements(pmt::dict_ref(d_meta, pmt::mp("sigb0"), pmt::PMT_NIL));
-              if(d_m.nSS == 2)
-              {
-                procChipsToQamNonShiftedScL(&d_sigBitsIntedL[0], d_signl0, C8P_QAM_BPSK);
-                procChipsToQamNonShiftedScL(&d_sigBitsIntedNL[0], d_signl0+64, C8P_QAM_BPSK);
-                procChipsToQamNonShiftedScL(&d_sigBitsIntedNL[48], d_signl0+128, C8P_QAM_QBPSK);
-                procChipsToQamNonShiftedScNL(&d_sigBitsIntedB0[0], d_signl0+384, C8P_QAM_BPSK);
-                procInsertPilots(d_signl0, tmpSigPilots);
-                procInsertPilots(d_signl0+64, tmpSigPilots);
-                procInsertPilots(d_signl0+128, tmpSigPilots);
-                procInsertPilots(d_signl0+384, tmpSigPilots);
-                memcpy((uint8_t*)d_signl1vht, (uint8_t*)d_signl0, sizeof(gr_complex)*192);
-                memcpy((uint8_t*)(d_signl1vht+384), (uint8_t*)(d_signl0+384), sizeof(gr_complex)*64);
-                procCSD(d_signl1vht, -200);
-                procCSD(d_signl1vht+64, -200);
-                procCSD(d_signl1vht+128, -200);
-                procCSD(d_signl1vht+384, -400);
-                d_sigP0 = d_signl0;
-                d_sigP1 = d_signl1vht;
-                d_nSampSigTotal = 448;
-                dict = pmt::dict_add(dict, pmt::mp("packet_len"), pmt::from_long(7+d_m.nSym+MODUL_N_PADSYM));
-              }
-              else
-              {
-                procChipsToQamNonShiftedScL(&d_sigBitsIntedL[0], d_signl, C8P_QAM_BPSK);
-                procChipsToQamNonShiftedScL(&d_sigBitsIntedNL[0], d_signl+64, C8P_QAM_BPSK);
-                procChipsToQamNonShiftedScL(&d_sigBitsIntedNL[48], d_signl+128, C8P_QAM_QBPSK);
-                procChipsToQamNonShiftedScNL(&d_sigBitsIntedB0[0], d_signl+320, C8P_QAM_BPSK);
-                procInsertPilots(d_signl, tmpSigPilots);
-                procInsertPilots(d_signl+64, tmpSigPilots);
-                procInsertPilots(d_signl+128, tmpSigPilots);
-                procInsertPilots(d_signl+320, tmpSigPilots);
-                d_sigP0 = d_signl;
-                d_nSampSigTotal = 384;
-                dict = pmt::dict_add(dict, pmt::mp("packet_len"), pmt::from_long(6+d_m.nSym+MODUL_N_PADSYM));
-              }
-            }
-            else if(d_pktFormat == C8P_F_HT)
+            if(d_pktFormat != C8P_F_L)
             {
               d_sigBitsIntedNL = pmt::u8vector_elements(pmt::dict_ref(d_meta, pmt::mp("signl"), pmt::PMT_NIL));
-              if(d_m.nSS == 2)
-              {
-                procChipsToQamNonShiftedScL(&d_sigBitsIntedL[0], d_signl0, C8P_QAM_BPSK);
-                procChipsToQamNonShiftedScL(&d_sigBitsIntedNL[0], d_signl0+64, C8P_QAM_QBPSK);
-                procChipsToQamNonShiftedScL(&d_sigBitsIntedNL[48], d_signl0+128, C8P_QAM_QBPSK);
-                procInsertPilots(d_signl0, tmpSigPilots);
-                procInsertPilots(d_signl0+64, tmpSigPilots);
-                procInsertPilots(d_signl0+128, tmpSigPilots);
-                memcpy((uint8_t*)d_signl1, (uint8_t*)d_signl0, sizeof(gr_complex)*192);
-                procCSD(d_signl1, -200);
-                procCSD(d_signl1+64, -200);
-                procCSD(d_signl1+128, -200);
-                d_sigP0 = d_signl0;
-                d_sigP1 = d_signl1;
-                d_nSampSigTotal = 384;
-                dict = pmt::dict_add(dict, pmt::mp("packet_len"), pmt::from_long(6+d_m.nSym+MODUL_N_PADSYM));
-              }
-              else
-              {
-                procChipsToQamNonShiftedScL(&d_sigBitsIntedL[0], d_signl, C8P_QAM_BPSK);
-                procChipsToQamNonShiftedScL(&d_sigBitsIntedNL[0], d_signl+64, C8P_QAM_QBPSK);
-                procChipsToQamNonShiftedScL(&d_sigBitsIntedNL[48], d_signl+128, C8P_QAM_QBPSK);
-                procInsertPilots(d_signl, tmpSigPilots);
-                procInsertPilots(d_signl+64, tmpSigPilots);
-                procInsertPilots(d_signl+128, tmpSigPilots);
-                d_sigP0 = d_signl;
-                d_nSampSigTotal = 320;
-                dict = pmt::dict_add(dict, pmt::mp("packet_len"), pmt::from_long(5+d_m.nSym+MODUL_N_PADSYM));
-              }
             }
-            else
+            if(d_pktFormat == C8P_F_VHT)
             {
-              procChipsToQamNonShiftedScL(&d_sigBitsIntedL[0], d_sigl, C8P_QAM_BPSK);
-              procInsertPilots(d_sigl, tmpSigPilots);
-              d_sigP0 = d_sigl;
-              d_nSampSigTotal = 64;
-              dict = pmt::dict_add(dict, pmt::mp("packet_len"), pmt::from_long(1+d_m.nSym+MODUL_N_PADSYM));
+              d_sigBitsIntedB0 = pmt::u8vector_elements(pmt::dict_ref(d_meta, pmt::mp("sigb0"), pmt::PMT_NIL));
             }
+            const gr_complex* tmpSigP0;
+            const gr_complex* tmpSigP1;
+            d_nSampSigTotal = d_mod.sig(&d_m, d_sigBitsIntedL.data(), d_sigBitsIntedNL.data(), d_sigBitsIntedB0.data(), &tmpSigP0, &tmpSigP1);
+            d_sigP0 = tmpSigP0;
+            d_sigP1 = tmpSigP1;
+            dict = pmt::dict_add(dict, pmt::mp("packet_len"), pmt::from_long(d_nSampSigTotal/64+d_m.nSym+MODUL_N_PADSYM));
             dict = pmt::dict_add(dict, pmt::mp("nss"), pmt::from_long(d_pktNss0));
           }
           pmt::pmt_t pairs = pmt::dict_items(dict);
@@ -357,43 +234,14 @@ namespace gr {
               {
                 procChipsToQamNonShiftedScNL(inChips0 + d_nProced, outSig0 + d_nGened, d_m.modMu[0]);
                 procChipsToQamNonShiftedScNL(inChips1 + d_nProced, outSig1 + d_nGened, d_m.modMu[1]);
-                procInsertPilots(outSig0 + d_nGened, d_pilotsVHT[d_nSymCopied]);
-                procInsertPilots(outSig1 + d_nGened, d_pilotsVHT[d_nSymCopied]);
+                procInsertPilots(outSig0 + d_nGened, d_mod.pilotsVHT[d_nSymCopied]);
+                procInsertPilots(outSig1 + d_nGened, d_mod.pilotsVHT[d_nSymCopied]);
                 procCSD(outSig1 + d_nGened, -400);
                 procNss2SymBfQ(outSig0 + d_nGened, outSig1 + d_nGened, d_vhtMuBfQ);
               }
-              else if(d_m.format == C8P_F_L)
-              {
-                procChipsToQamNonShiftedScL(inChips0 + d_nProced, outSig0 + d_nGened, d_m.mod);
-                procInsertPilots(outSig0 + d_nGened, d_pilotsL[d_nSymCopied]);
-                memset((uint8_t*)(outSig0 + d_nGened), 0, sizeof(gr_complex) * 6);
-                memset((uint8_t*)(outSig0 + d_nGened + 59), 0, sizeof(gr_complex) * 5);
-              }
-              else if(d_m.format == C8P_F_VHT)
-              {
-                procChipsToQamNonShiftedScNL(inChips0 + d_nProced, outSig0 + d_nGened, d_m.mod);
-                procInsertPilots(outSig0 + d_nGened, d_pilotsVHT[d_nSymCopied]);
-                if(d_m.nSS == 2)
-                {
-                  procChipsToQamNonShiftedScNL(inChips1 + d_nProced, outSig1 + d_nGened, d_m.mod);
-                  procInsertPilots(outSig1 + d_nGened, d_pilotsVHT[d_nSymCopied]);
-                  procCSD(outSig1 + d_nGened, -400);
-                }
-              }
               else
               {
-                procChipsToQamNonShiftedScNL(inChips0 + d_nProced, outSig0 + d_nGened, d_m.mod);
-                if(d_m.nSS == 2)
-                {
-                  procChipsToQamNonShiftedScNL(inChips1 + d_nProced, outSig1 + d_nGened, d_m.mod);
-                  procInsertPilots(outSig0 + d_nGened, d_pilotsHT20[d_nSymCopied]);
-                  procInsertPilots(outSig1 + d_nGened, d_pilotsHT21[d_nSymCopied]);
-                  procCSD(outSig1 + d_nGened, -400);
-                }
-                else
-                {
-                  procInsertPilots(outSig0 + d_nGened, d_pilotsHT[d_nSymCopied]);
-                }
+                d_mod.sym(&d_m, inChips0 + d_nProced, inChips1 + d_nProced, d_nSymCopied, outSig0 + d_nGened, outSig1 + d_nGened);
               }
               d_nSymCopied++;
               d_nProced+=d_m.nSD;
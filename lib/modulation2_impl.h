@@ -24,6 +24,7 @@
 #include <gnuradio/ieee80211/modulation2.h>
 #include <gnuradio/pdu.h>
 #include "cloud80211phy.h"
+#include "cloud80211tx.h"
 
 using namespace boost::placeholders;
 
@@ -65,23 +66,14 @@ namespace gr {
       std::vector<uint8_t> d_sigBitsIntedNL;
       std::vector<uint8_t> d_sigBitsIntedB0;
       std::vector<uint8_t> d_sigBitsIntedB1;
+      c8pTxModulator d_mod;      // training fields and pilots, su packets
       gr_complex d_vhtMuBfQ[256];
-      gr_complex d_sigl[64];     // legacy
-      gr_complex d_signl[384];    // nl siso
-      gr_complex d_signl0[448];   // nl 2x2
-      gr_complex d_signl1[448];   // nl 2x2
-      gr_complex d_signl1vht[448];   // nl 2x2
       gr_complex d_signl0mu[448];
       gr_complex d_signl1mu[448];
-      gr_complex *d_sigP0, *d_sigP1;
+      const gr_complex *d_sigP0, *d_sigP1;
       int d_nSampSigTotal;
       int d_nSampSigCopied;
       int d_nSymCopied;
-      gr_complex d_pilotsL[1408][4];
-      gr_complex d_pilotsVHT[1408][4];
-      gr_complex d_pilotsHT[1408][4];
-      gr_complex d_pilotsHT20[1408][4];
-      gr_complex d_pilotsHT21[1408][4];
       void msgRead(pmt::pmt_t msg);
 
      public:
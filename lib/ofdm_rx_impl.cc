@@ -0,0 +1,164 @@
+/*
+ *
+ *     GNU Radio IEEE 802.11a/g/n/ac 2x2
+ *     Fused receiver of 802.11a/g/n/ac 1x1 and 2x2 formats
+ *     Copyright (C) June 1, 2022  Zelin Yun
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU Affero General Public License as published
+ *     by the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU Affero General Public License for more details.
+ *
+ *     You should have received a copy of the GNU Affero General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gnuradio/io_signature.h>
+#include <volk/volk.h>
+#include "ofdm_rx_impl.h"
+
+namespace gr {
+  namespace ieee80211 {
+
+    ofdm_rx::sptr
+    ofdm_rx::make(int llrtype)
+    {
+      return gnuradio::make_block_sptr<ofdm_rx_impl>(llrtype
+        );
+    }
+
+    ofdm_rx_impl::ofdm_rx_impl(int llrtype)
+      : gr::block("ofdm_rx",
+              gr::io_signature::makev(3, 3, std::vector<int>{sizeof(uint8_t), sizeof(gr_complex), sizeof(gr_complex)}),
+              gr::io_signature::make(0, 0, 0)),
+              d_pkt(llrtype)
+    {
+      d_pmtOut = pmt::mp("out");
+      d_pmtLen = pmt::mp("len");
+      d_pmtSeq = pmt::mp("seq");
+      message_port_register_out(d_pmtOut);
+
+      d_sRx = OFDMRX_S_TRIGGER;
+      d_nPktSeq = 0;
+      set_tag_propagation_policy(block::TPP_DONT);
+    }
+
+    ofdm_rx_impl::~ofdm_rx_impl()
+    {
+    }
+
+    void
+    ofdm_rx_impl::forecast (int noutput_items, gr_vector_int &ninput_items_required)
+    {
+      ninput_items_required[0] = noutput_items + C8P_RX_SIG_SAMP;
+      ninput_items_required[1] = noutput_items + C8P_RX_SIG_SAMP;
+      ninput_items_required[2] = noutput_items + C8P_RX_SIG_SAMP;
+    }
+
+    int
+    ofdm_rx_impl::general_work (int noutput_items,
+                       gr_vector_int &ninput_items,
+                       gr_vector_const_void_star &input_items,
+                       gr_vector_void_star &output_items)
+    {
+      const uint8_t* sync = static_cast<const uint8_t*>(input_items[0]);
+      const gr_complex* inSig1 = static_cast<const gr_complex*>(input_items[1]);
+      const gr_complex* inSig2 = static_cast<const gr_complex*>(input_items[2]);
+      d_nProc = std::min(std::min(ninput_items[0], ninput_items[1]), ninput_items[2]);
+      d_nUsed = 0;
+
+      // all the packets in the input are handled in one call
+      int tmpUsed = -1;
+      while(d_nUsed > tmpUsed)
+      {
+        tmpUsed = d_nUsed;
+
+        if(d_sRx == OFDMRX_S_TRIGGER)
+        {
+          int i;
+          for(i=d_nUsed;i<d_nProc;i++)
+          {
+            if(sync[i])
+            {
+              get_tags_in_range(d_tags, 0, nitems_read(0) + i, nitems_read(0) + i + 1);
+              c8p_pkt tmpPktCopy;
+              const c8p_pkt* tmpPkt = c8pPktFind(d_tags, &tmpPktCopy);
+              if (tmpPkt)
+              {
+                d_cfoRad = tmpPkt->rad;
+                d_snr = tmpPkt->snr;
+                d_sRx = OFDMRX_S_SIG;
+              }
+              else
+              {
+                std::cout<<"ieee80211 ofdm_rx, error: input sync with no tag."<<std::endl;
+                i++;
+              }
+              break;
+            }
+          }
+          d_nUsed = i;
+        }
+
+        if(d_sRx == OFDMRX_S_SIG)
+        {
+          if((d_nProc - d_nUsed) >= C8P_RX_SIG_SAMP)
+          {
+            if(d_pkt.sig(&inSig1[d_nUsed], d_cfoRad, d_snr))
+            {
+              d_nPktSeq++;
+              if(d_nPktSeq >= 1000000000){d_nPktSeq = 0;}
+              d_sRx = OFDMRX_S_COPY;
+              d_nUsed += C8P_RX_SIG_SAMP;
+            }
+            else
+            {
+              d_sRx = OFDMRX_S_TRIGGER;
+              d_nUsed += 80;
+            }
+          }
+        }
+
+        if(d_sRx == OFDMRX_S_COPY)
+        {
+          d_nUsed += d_pkt.copy(&inSig1[d_nUsed], &inSig2[d_nUsed], d_nProc - d_nUsed);
+          if(d_pkt.copied())
+          {
+            if(d_pkt.decode())
+            {
+              d_pkt.frame.mpdus([this](const uint8_t* mpdu, int len){
+                pktPublish(mpdu, len);
+              });
+            }
+            d_sRx = OFDMRX_S_TRIGGER;
+          }
+        }
+      }
+
+      consume_each(d_nUsed);
+      return 0;
+    }
+
+    void
+    ofdm_rx_impl::pktPublish(const uint8_t* mpdu, int len)
+    {
+      // same message as decode, 1 byte format, 2 bytes len, mpdu and 1 byte mcs
+      pmt::pmt_t tmpPayload;
+      uint8_t* tmpBytes = d_blobPool.get(len + 4, tmpPayload);
+      tmpBytes[0] = d_pkt.frame.format;
+      tmpBytes[1] = len%256;
+      tmpBytes[2] = len/256;
+      memcpy(&tmpBytes[3], mpdu, len);
+      tmpBytes[len + 3] = d_pkt.frame.mcs;
+      pmt::pmt_t tmpMeta = pmt::dict_add(pmt::make_dict(), d_pmtLen, pmt::from_long(len + 4));
+      tmpMeta = pmt::dict_add(tmpMeta, d_pmtSeq, pmt::from_long(d_nPktSeq));
+      message_port_pub(d_pmtOut, pmt::cons(tmpMeta, tmpPayload));
+    }
+
+  } /* namespace ieee80211 */
+} /* namespace gr */
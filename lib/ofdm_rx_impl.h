@@ -0,0 +1,73 @@
+/*
+ *
+ *     GNU Radio IEEE 802.11a/g/n/ac 2x2
+ *     Fused receiver of 802.11a/g/n/ac 1x1 and 2x2 formats
+ *     Copyright (C) June 1, 2022  Zelin Yun
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU Affero General Public License as published
+ *     by the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU Affero General Public License for more details.
+ *
+ *     You should have received a copy of the GNU Affero General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_IEEE80211_OFDM_RX_IMPL_H
+#define INCLUDED_IEEE80211_OFDM_RX_IMPL_H
+
+#include <gnuradio/ieee80211/ofdm_rx.h>
+#include "cloud80211phy.h"
+#include "cloud80211pkt.h"
+#include "cloud80211rx.h"
+
+#define OFDMRX_S_TRIGGER 0
+#define OFDMRX_S_SIG 1
+#define OFDMRX_S_COPY 2
+
+namespace gr {
+  namespace ieee80211 {
+
+    class ofdm_rx_impl : public ofdm_rx
+    {
+     private:
+      // block
+      int d_sRx;
+      int d_nProc;
+      int d_nUsed;
+      int d_nPktSeq;
+      float d_cfoRad;
+      float d_snr;
+      std::vector<gr::tag_t> d_tags;
+      // signal, scratch of the span, demod and decode of one packet
+      c8pRxPacket d_pkt;
+      // packet
+      c8pBlobPool d_blobPool;
+      pmt::pmt_t d_pmtOut;
+      pmt::pmt_t d_pmtLen;
+      pmt::pmt_t d_pmtSeq;
+
+      void pktPublish(const uint8_t* mpdu, int len);
+
+     public:
+      ofdm_rx_impl(int llrtype);
+      ~ofdm_rx_impl();
+
+      // Where all the action really happens
+      void forecast (int noutput_items, gr_vector_int &ninput_items_required);
+
+      int general_work(int noutput_items,
+           gr_vector_int &ninput_items,
+           gr_vector_const_void_star &input_items,
+           gr_vector_void_star &output_items);
+    };
+
+  } // namespace ieee80211
+} // namespace gr
+
+#endif /* INCLUDED_IEEE80211_OFDM_RX_IMPL_H */
@@ -38,62 +38,9 @@ namespace gr {
     pad2_impl::pad2_impl()
       : gr::block("pad2",
               gr::io_signature::make(2, 2, sizeof(gr_complex)),
-              gr::io_signature::make(2, 2, sizeof(gr_complex))),
-              d_ofdm_fft(64,1)
+              gr::io_signature::make(2, 2, sizeof(gr_complex)))
     {
       d_sPad = PAD_S_TAG;
-      for(int i=0;i<240;i++)
-      {
-        d_scaleMask[i] = 1.0f / sqrtf(52.0f) / PAD_SCALE;
-        d_scaleMask[i] = 1.0f / sqrtf(52.0f) / PAD_SCALE;
-        d_scaleMask[i] = 1.0f / sqrtf(52.0f) / PAD_SCALE;
-      }
-      for(int i=240;i<320;i++)
-      {
-        d_scaleMask[i] = 1.0f / sqrtf(12.0f) / PAD_SCALE;
-      }
-      memset((uint8_t*)d_preamblel0, 0, sizeof(gr_complex)*80);
-      memset((uint8_t*)d_preamblel1, 0, sizeof(gr_complex)*80);
-      memcpy(d_ofdm_fft.get_inbuf(), &C8P_STF_F[32], sizeof(gr_complex)*32);
-      memcpy(d_ofdm_fft.get_inbuf()+32, &C8P_STF_F[0], sizeof(gr_complex)*32);
-      d_ofdm_fft.execute();
-      memcpy(d_preamblel0+80, d_ofdm_fft.get_outbuf()+32, sizeof(gr_complex)*32);
-      memcpy(d_preamblel0+112, d_ofdm_fft.get_outbuf(), sizeof(gr_complex)*64);
-      memcpy(d_preamblel0+176, d_ofdm_fft.get_outbuf(), sizeof(gr_complex)*64);
-      procCSD(d_ofdm_fft.get_inbuf(), -200);
-      d_ofdm_fft.execute();
-      memcpy(d_preamblel1+80, d_ofdm_fft.get_outbuf()+32, sizeof(gr_complex)*32);
-      memcpy(d_preamblel1+112, d_ofdm_fft.get_outbuf(), sizeof(gr_complex)*64);
-      memcpy(d_preamblel1+176, d_ofdm_fft.get_outbuf(), sizeof(gr_complex)*64);
-      memcpy(d_ofdm_fft.get_inbuf(), &C8P_LTF_L_F[32], sizeof(gr_complex)*32);
-      memcpy(d_ofdm_fft.get_inbuf()+32, &C8P_LTF_L_F[0], sizeof(gr_complex)*32);
-      d_ofdm_fft.execute();
-      memcpy(d_preamblel0+240, d_ofdm_fft.get_outbuf()+32, sizeof(gr_complex)*32);
-      memcpy(d_preamblel0+272, d_ofdm_fft.get_outbuf(), sizeof(gr_complex)*64);
-      memcpy(d_preamblel0+336, d_ofdm_fft.get_outbuf(), sizeof(gr_complex)*64);
-      procCSD(d_ofdm_fft.get_inbuf(), -200);
-      d_ofdm_fft.execute();
-      memcpy(d_preamblel1+240, d_ofdm_fft.get_outbuf()+32, sizeof(gr_complex)*32);
-      memcpy(d_preamblel1+272, d_ofdm_fft.get_outbuf(), sizeof(gr_complex)*64);
-      memcpy(d_preamblel1+336, d_ofdm_fft.get_outbuf(), sizeof(gr_complex)*64);
-      d_preamblel0[80] *= 0.5f;
-      d_preamblel0[239] *= 0.5f;
-      d_preamblel0[240] *= 0.5f;
-      d_preamblel0[399] *= 0.5f;
-      d_preamblel1[80] *= 0.5f;
-      d_preamblel1[239] *= 0.5f;
-      d_preamblel1[240] *= 0.5f;
-      d_preamblel1[399] *= 0.5f;
-      for(int i=80;i<240;i++)
-      {
-        d_preamblel0[i] = d_preamblel0[i] / sqrtf(12.0f) / PAD_SCALE;
-        d_preamblel1[i] = d_preamblel1[i] / sqrtf(12.0f) / PAD_SCALE;
-      }
-      for(int i=240;i<400;i++)
-      {
-        d_preamblel0[i] = d_preamblel0[i] / sqrtf(52.0f) / PAD_SCALE;
-        d_preamblel1[i] = d_preamblel1[i] / sqrtf(52.0f) / PAD_SCALE;
-      }
     }
 
     /*
@@ -139,16 +86,8 @@ namespace gr {
           d_pktLen = pmt::to_long(pmt::dict_ref(d_meta, pmt::mp("packet_len"), pmt::from_long(-1)));
           std::cout<<"ieee80211 pad, get tag format:"<<d_pktFormat<<", nss:"<<d_pktNss<<", len:"<<d_pktLen<<std::endl;
           d_nSampCopied = 0;
-          if(d_pktFormat == C8P_F_L)
-          {
-            d_scaleTotal = 80;
-            d_scaler = 1.0f / sqrt(52.0f) / PAD_SCALE;
-          }
-          else
-          {
-            d_scaleTotal = 320;
-            d_scaler = 1.0f / sqrt(56.0f) / PAD_SCALE;
-          }
+          d_scaleTotal = c8pTxPad::sigSamp(d_pktFormat);
+          d_scaler = c8pTxPad::dataScale(d_pktFormat);
           d_nSampTotal = (d_pktLen - d_scaleTotal);
 
           static const pmt::pmt_t time_key = pmt::string_to_symbol("tx_time");
@@ -174,12 +113,12 @@ namespace gr {
 
       if(d_sPad == PAD_S_PRE)
       {
-        if(d_nGen < (400 - d_nSampCopied))
+        if(d_nGen < (C8P_TX_PRE_SAMP - d_nSampCopied))
         {
-          memcpy(outSig0, d_preamblel0 + d_nSampCopied, d_nGen * sizeof(gr_complex));
+          memcpy(outSig0, d_pad.pre0 + d_nSampCopied, d_nGen * sizeof(gr_complex));
           if(d_pktNss == 2)
           {
-            memcpy(outSig1, d_preamblel1 + d_nSampCopied, d_nGen * sizeof(gr_complex));
+            memcpy(outSig1, d_pad.pre1 + d_nSampCopied, d_nGen * sizeof(gr_complex));
           }
           else
           {
@@ -190,16 +129,16 @@ namespace gr {
         }
         else
         {
-          memcpy(outSig0, d_preamblel0 + d_nSampCopied, (400 - d_nSampCopied) * sizeof(gr_complex));
+          memcpy(outSig0, d_pad.pre0 + d_nSampCopied, (C8P_TX_PRE_SAMP - d_nSampCopied) * sizeof(gr_complex));
           if(d_pktNss == 2)
           {
-            memcpy(outSig1, d_preamblel1 + d_nSampCopied, (400 - d_nSampCopied) * sizeof(gr_complex));
+            memcpy(outSig1, d_pad.pre1 + d_nSampCopied, (C8P_TX_PRE_SAMP - d_nSampCopied) * sizeof(gr_complex));
           }
           else
           {
-            memset((uint8_t*)outSig1, 0, sizeof(gr_complex) * (400 - d_nSampCopied));
+            memset((uint8_t*)outSig1, 0, sizeof(gr_complex) * (C8P_TX_PRE_SAMP - d_nSampCopied));
           }
-          d_nGened += (400 - d_nSampCopied);
+          d_nGened += (C8P_TX_PRE_SAMP - d_nSampCopied);
           d_nSampCopied = 0;
           d_sPad = PAD_S_SIG;
         }
@@ -214,8 +153,8 @@ namespace gr {
           {
             for(int i=0;i<tmpMin;i++)
             {
-              outSig0[d_nGened+i] = inSig0[i] * d_scaleMask[d_nSampCopied];
-              outSig1[d_nGened+i] = inSig1[i] * d_scaleMask[d_nSampCopied];
+              outSig0[d_nGened+i] = inSig0[i] * d_pad.scaleMask[d_nSampCopied];
+              outSig1[d_nGened+i] = inSig1[i] * d_pad.scaleMask[d_nSampCopied];
               d_nSampCopied++;
             }
           }
@@ -223,7 +162,7 @@ namespace gr {
           {
             for(int i=0;i<tmpMin;i++)
             {
-              outSig0[d_nGened+i] = inSig0[i] * d_scaleMask[d_nSampCopied];
+              outSig0[d_nGened+i] = inSig0[i] * d_pad.scaleMask[d_nSampCopied];
               outSig1[d_nGened+i] = gr_complex(0, 0);
               d_nSampCopied++;
             }
@@ -238,8 +177,8 @@ namespace gr {
           {
             for(int i=0;i<tmpMin;i++)
             {
-              outSig0[d_nGened+i] = inSig0[i] * d_scaleMask[d_nSampCopied];
-              outSig1[d_nGened+i] = inSig1[i] * d_scaleMask[d_nSampCopied];
+              outSig0[d_nGened+i] = inSig0[i] * d_pad.scaleMask[d_nSampCopied];
+              outSig1[d_nGened+i] = inSig1[i] * d_pad.scaleMask[d_nSampCopied];
               d_nSampCopied++;
             }
           }
@@ -247,7 +186,7 @@ namespace gr {
           {
             for(int i=0;i<tmpMin;i++)
             {
-              outSig0[d_nGened+i] = inSig0[i] * d_scaleMask[d_nSampCopied];
+              outSig0[d_nGened+i] = inSig0[i] * d_pad.scaleMask[d_nSampCopied];
               outSig1[d_nGened+i] = gr_complex(0, 0);
               d_nSampCopied++;
             }
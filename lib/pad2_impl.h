@@ -23,16 +23,14 @@
 
 #include <gnuradio/ieee80211/pad2.h>
 #include <uhd/types/time_spec.hpp>
-#include <gnuradio/fft/fft.h>
 #include "cloud80211phy.h"
+#include "cloud80211tx.h"
 
 #define PAD_S_TAG 0
 #define PAD_S_PRE 1
 #define PAD_S_SIG 2
 #define PAD_S_DATA 3
 
-#define PAD_SCALE 5.333333f
-
 namespace gr {
   namespace ieee80211 {
 
@@ -49,12 +47,9 @@ namespace gr {
       int d_pktNss;
       int d_pktLen;
       float d_scaler;
-      gr_complex d_preamblel0[400];
-      gr_complex d_preamblel1[400];
-      fft::fft_complex_rev d_ofdm_fft;
+      c8pTxPad d_pad;     // preamble and scaling
       int d_nSampCopied;
       int d_nSampTotal;
-      float d_scaleMask[320];
       int d_scaleTotal;
 
     public:
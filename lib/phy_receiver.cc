@@ -0,0 +1,278 @@
+/*
+ *
+ *     GNU Radio IEEE 802.11a/g/n/ac 2x2
+ *     Receiver of 802.11a/g/n/ac 1x1 and 2x2 formats without the scheduler
+ *     Copyright (C) June 1, 2022  Zelin Yun
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU Affero General Public License as published
+ *     by the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU Affero General Public License for more details.
+ *
+ *     You should have received a copy of the GNU Affero General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gnuradio/ieee80211/phy.h>
+#include <deque>
+#include "cloud80211rx.h"
+
+#define PHYRX_S_TRIGGER 0
+#define PHYRX_S_SIG 1
+#define PHYRX_S_COPY 2
+
+#define PHYRX_SLICE 8192      // input samples taken into the buffer at a time
+
+namespace gr {
+  namespace ieee80211 {
+    namespace phy {
+
+    // a sync found in the buffer, index counted from the first sample
+    struct phyRxSync
+    {
+      int64_t index;
+      float rad;
+      float snr;
+      float rssi;
+    };
+
+    /*
+     * The stages of stf_detect, sync and ofdm_rx over one buffer. d_base is
+     * the index of the first buffered sample, the buffer starts with the
+     * C8P_STF_HIST samples the stf detection looks back at. Each stage keeps
+     * its own position, the samples before all of them are dropped after
+     * each slice.
+     */
+    struct Receiver::impl
+    {
+      int d_nAnt;
+      int64_t d_base;
+      std::vector<gr_complex> d_buf1;
+      std::vector<gr_complex> d_buf2;
+      std::vector<uint8_t> d_trigger;
+      std::vector<gr_complex> d_conj;
+      // stf detect and sync
+      c8pStfDetect d_stf;
+      c8pLtfSync d_ltfSync;
+      bool d_fSync;
+      int64_t d_syncPos;
+      std::deque<phyRxSync> d_syncs;
+      // packet
+      int d_sRx;
+      int64_t d_rxPos;
+      uint64_t d_nPktSeq;
+      phyRxSync d_pktSync;
+      c8pRxPacket d_pkt;
+
+      impl(int nant, int llrtype)
+        : d_nAnt(nant), d_pkt(llrtype)
+      {
+        reset();
+      }
+
+      void reset()
+      {
+        // zeros before the first sample, as the history of stf_detect
+        d_base = -C8P_STF_HIST;
+        d_buf1.assign(C8P_STF_HIST, gr_complex(0.0f, 0.0f));
+        d_buf2.assign(d_nAnt > 1 ? C8P_STF_HIST : 0, gr_complex(0.0f, 0.0f));
+        d_trigger.assign(C8P_STF_HIST, 0);
+        d_conj.assign(C8P_STF_HIST, gr_complex(0.0f, 0.0f));
+        d_stf.reset();
+        d_ltfSync = c8pLtfSync();
+        d_fSync = false;
+        d_syncPos = 0;
+        d_syncs.clear();
+        d_sRx = PHYRX_S_TRIGGER;
+        d_rxPos = 0;
+        d_nPktSeq = 0;
+      }
+
+      int64_t end() const
+      {
+        return d_base + (int64_t)d_buf1.size();
+      }
+
+      void append(const gr_complex* in1, const gr_complex* in2, int n)
+      {
+        int tmpOld = d_buf1.size();
+        d_buf1.insert(d_buf1.end(), in1, in1 + n);
+        if(d_nAnt > 1 && in2)
+        {
+          d_buf2.insert(d_buf2.end(), in2, in2 + n);
+        }
+        else if(d_nAnt > 1)
+        {
+          d_buf2.resize(d_buf1.size(), gr_complex(0.0f, 0.0f));
+        }
+        d_trigger.resize(tmpOld + n);
+        d_conj.resize(tmpOld + n);
+        d_stf.run(&d_buf1[tmpOld], n, &d_trigger[tmpOld], &d_conj[tmpOld]);
+      }
+
+      void sync()
+      {
+        // same as the sync block, a trigger takes C8P_SYNC_BUF_LEN samples and moves on C8P_SYNC_RES_LEN
+        while(true)
+        {
+          if(!d_fSync)
+          {
+            int64_t i;
+            for(i=d_syncPos;i<end();i++)
+            {
+              uint8_t tmpTrigger = d_trigger[i - d_base];
+              if(tmpTrigger & 0x01)
+              {
+                d_fSync = true;
+                break;
+              }
+              else if(tmpTrigger & 0x02)
+              {
+                d_ltfSync.conjMultiAvg = d_conj[i - d_base];
+              }
+            }
+            d_syncPos = i;
+          }
+          if(!d_fSync || (end() - d_syncPos) < C8P_SYNC_BUF_LEN)
+          {
+            return;
+          }
+          if(d_ltfSync.run(&d_buf1[d_syncPos - d_base]))
+          {
+            d_syncs.push_back(phyRxSync{d_syncPos + d_ltfSync.index, d_ltfSync.rad, d_ltfSync.snr, d_ltfSync.rssi});
+          }
+          d_syncPos += C8P_SYNC_RES_LEN;
+          d_fSync = false;
+        }
+      }
+
+      void packets(std::vector<Frame>& frames)
+      {
+        // same as ofdm_rx, syncs inside a packet are skipped
+        while(true)
+        {
+          if(d_sRx == PHYRX_S_TRIGGER)
+          {
+            while(!d_syncs.empty() && d_syncs.front().index < d_rxPos)
+            {
+              d_syncs.pop_front();
+            }
+            if(d_syncs.empty())
+            {
+              return;
+            }
+            d_pktSync = d_syncs.front();
+            d_syncs.pop_front();
+            d_rxPos = d_pktSync.index;
+            d_sRx = PHYRX_S_SIG;
+          }
+
+          if(d_sRx == PHYRX_S_SIG)
+          {
+            if((end() - d_rxPos) < C8P_RX_SIG_SAMP)
+            {
+              return;
+            }
+            if(d_pkt.sig(&d_buf1[d_rxPos - d_base], d_pktSync.rad, d_pktSync.snr))
+            {
+              d_nPktSeq++;
+              d_rxPos += C8P_RX_SIG_SAMP;
+              d_sRx = PHYRX_S_COPY;
+            }
+            else
+            {
+              d_rxPos += 80;
+              d_sRx = PHYRX_S_TRIGGER;
+            }
+          }
+
+          if(d_sRx == PHYRX_S_COPY)
+          {
+            int tmpOff = d_rxPos - d_base;
+            d_rxPos += d_pkt.copy(&d_buf1[tmpOff], d_nAnt > 1 ? &d_buf2[tmpOff] : nullptr, end() - d_rxPos);
+            if(!d_pkt.copied())
+            {
+              return;
+            }
+            if(d_pkt.decode())
+            {
+              d_pkt.frame.mpdus([this, &frames](const uint8_t* mpdu, int len){
+                Frame tmpFrame;
+                tmpFrame.format = d_pkt.frame.format;
+                tmpFrame.mcs = d_pkt.frame.mcs;
+                tmpFrame.nss = d_pkt.frame.nss;
+                tmpFrame.seq = d_nPktSeq;
+                tmpFrame.offset = d_pktSync.index;
+                tmpFrame.cfo = d_pktSync.rad;
+                tmpFrame.snr = d_pktSync.snr;
+                tmpFrame.rssi = d_pktSync.rssi;
+                tmpFrame.mpdu.assign(mpdu, mpdu + len);
+                frames.push_back(std::move(tmpFrame));
+              });
+            }
+            d_sRx = PHYRX_S_TRIGGER;
+          }
+        }
+      }
+
+      void compact()
+      {
+        // keep the stf history, the pending sync and the packet in progress
+        int64_t tmpKeep = std::min(end() - C8P_STF_HIST, d_syncPos);
+        if(d_sRx != PHYRX_S_TRIGGER)
+        {
+          tmpKeep = std::min(tmpKeep, d_rxPos);
+        }
+        int tmpDrop = tmpKeep - d_base;
+        if(tmpDrop > 0)
+        {
+          d_buf1.erase(d_buf1.begin(), d_buf1.begin() + tmpDrop);
+          if(d_nAnt > 1)
+          {
+            d_buf2.erase(d_buf2.begin(), d_buf2.begin() + tmpDrop);
+          }
+          d_trigger.erase(d_trigger.begin(), d_trigger.begin() + tmpDrop);
+          d_conj.erase(d_conj.begin(), d_conj.begin() + tmpDrop);
+          d_base = tmpKeep;
+        }
+      }
+    };
+
+    Receiver::Receiver(int nant, int llrtype)
+      : d_impl(new impl(std::min(std::max(1, nant), 2), llrtype))
+    {
+    }
+
+    Receiver::~Receiver()
+    {
+    }
+
+    int
+    Receiver::process(const gr_complex* in1, const gr_complex* in2, int n, std::vector<Frame>& frames)
+    {
+      size_t tmpStart = frames.size();
+      for(int i=0;i<n;i+=PHYRX_SLICE)
+      {
+        int tmpN = std::min(PHYRX_SLICE, n - i);
+        d_impl->append(&in1[i], in2 ? &in2[i] : nullptr, tmpN);
+        d_impl->sync();
+        d_impl->packets(frames);
+        d_impl->compact();
+      }
+      return frames.size() - tmpStart;
+    }
+
+    void
+    Receiver::reset()
+    {
+      d_impl->reset();
+    }
+
+    } /* namespace phy */
+  } /* namespace ieee80211 */
+} /* namespace gr */
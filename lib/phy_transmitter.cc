@@ -0,0 +1,214 @@
+/*
+ *
+ *     GNU Radio IEEE 802.11a/g/n/ac 2x2
+ *     Transmitter of 802.11a/g/n/ac 1x1 and 2x2 formats without the scheduler
+ *     Copyright (C) June 1, 2022  Zelin Yun
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU Affero General Public License as published
+ *     by the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU Affero General Public License for more details.
+ *
+ *     You should have received a copy of the GNU Affero General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gnuradio/ieee80211/phy.h>
+#include <gnuradio/fft/fft.h>
+#include "cloud80211tx.h"
+
+namespace gr {
+  namespace ieee80211 {
+    namespace phy {
+
+    /*
+     * encode2, modulation2, fft with cp and pad2 of one su packet. The
+     * symbols go through the fft one at a time straight into the caller
+     * buffers, each stage works on the whole packet so there is no state
+     * between packets other than the buffers.
+     */
+    struct Transmitter::impl
+    {
+      c8pTxEncoder d_enc;
+      c8pTxModulator d_mod;
+      c8pTxPad d_pad;
+      fft::fft_complex_rev d_ofdm_fft;
+      gr_complex d_sym0[64];
+      gr_complex d_sym1[64];
+
+      impl()
+        : d_ofdm_fft(64, 1)
+      {
+      }
+
+      // same checks as pktgen and the parsers of the signal fields
+      static bool valid(int format, int mcs, int nss, int len, c8p_mod* m)
+      {
+        if(len < 0 || len > 4095)
+        {
+          return false;
+        }
+        if(format == C8P_F_L)
+        {
+          if(mcs < 0 || mcs > 7 || nss != 1 || len == 0)
+          {
+            return false;
+          }
+        }
+        else if(format == C8P_F_HT)
+        {
+          if(mcs < 0 || mcs > 15 || nss != (mcs / 8 + 1) || len == 0)
+          {
+            return false;
+          }
+        }
+        else if(format == C8P_F_VHT)
+        {
+          if(mcs < 0 || mcs > 8 || nss < 1 || nss > 2)
+          {
+            return false;
+          }
+        }
+        else
+        {
+          return false;
+        }
+        formatToModSu(m, format, mcs, nss, len);
+        return true;
+      }
+
+      // legacy sig, ht sig, ht stf and ltfs, or legacy sig, vht sig a, vht stf, ltfs and vht sig b
+      static int sigSym(const c8p_mod* m)
+      {
+        if(m->format == C8P_F_L)
+        {
+          return 1;
+        }
+        else if(m->format == C8P_F_HT)
+        {
+          return 4 + m->nLTF;
+        }
+        return 5 + m->nLTF;
+      }
+
+      static int samples(const c8p_mod* m)
+      {
+        return C8P_TX_PRE_SAMP + (sigSym(m) + m->nSym + C8P_TX_PAD_SYM) * 80;
+      }
+
+      // fft_vxx with shift and the 16 sample cp, in is 64 bins with dc at 32
+      void ofdm(const gr_complex* in, gr_complex* out)
+      {
+        memcpy(d_ofdm_fft.get_inbuf(), in + 32, sizeof(gr_complex) * 32);
+        memcpy(d_ofdm_fft.get_inbuf() + 32, in, sizeof(gr_complex) * 32);
+        d_ofdm_fft.execute();
+        memcpy(out, d_ofdm_fft.get_outbuf() + 48, sizeof(gr_complex) * 16);
+        memcpy(out + 16, d_ofdm_fft.get_outbuf(), sizeof(gr_complex) * 64);
+      }
+
+      void scale(gr_complex* out, int format, int n)
+      {
+        int tmpSig = c8pTxPad::sigSamp(format);
+        float tmpScaler = c8pTxPad::dataScale(format);
+        for(int i=0;i<tmpSig;i++)
+        {
+          out[i] *= d_pad.scaleMask[i];
+        }
+        for(int i=tmpSig;i<n;i++)
+        {
+          out[i] *= tmpScaler;
+        }
+      }
+
+      void run(const uint8_t* psdu, int len, int format, int mcs, int nss, gr_complex* out1, gr_complex* out2, int n)
+      {
+        d_enc.run(format, mcs, nss, psdu, len);
+        const c8p_mod* m = &d_enc.m;
+        bool tmpTwo = (m->nSS == 2);
+        const gr_complex *tmpSigP0, *tmpSigP1;
+        int tmpSigBins = d_mod.sig(m, d_enc.sigIntedL, d_enc.sigIntedNL, d_enc.sigIntedB0, &tmpSigP0, &tmpSigP1);
+
+        memcpy(out1, d_pad.pre0, sizeof(gr_complex) * C8P_TX_PRE_SAMP);
+        if(tmpTwo)
+        {
+          memcpy(out2, d_pad.pre1, sizeof(gr_complex) * C8P_TX_PRE_SAMP);
+        }
+        int tmpPos = C8P_TX_PRE_SAMP;
+        for(int i=0;i<tmpSigBins;i+=64)
+        {
+          ofdm(tmpSigP0 + i, out1 + tmpPos);
+          if(tmpTwo)
+          {
+            ofdm(tmpSigP1 + i, out2 + tmpPos);
+          }
+          tmpPos += 80;
+        }
+        for(int i=0;i<m->nSym;i++)
+        {
+          d_mod.sym(m, d_enc.chips0 + i * m->nSD, d_enc.chips1 + i * m->nSD, i, d_sym0, d_sym1);
+          ofdm(d_sym0, out1 + tmpPos);
+          if(tmpTwo)
+          {
+            ofdm(d_sym1, out2 + tmpPos);
+          }
+          tmpPos += 80;
+        }
+        memset((uint8_t*)(out1 + tmpPos), 0, sizeof(gr_complex) * (n - tmpPos));
+        scale(out1 + C8P_TX_PRE_SAMP, format, tmpPos - C8P_TX_PRE_SAMP);
+        if(tmpTwo)
+        {
+          memset((uint8_t*)(out2 + tmpPos), 0, sizeof(gr_complex) * (n - tmpPos));
+          scale(out2 + C8P_TX_PRE_SAMP, format, tmpPos - C8P_TX_PRE_SAMP);
+        }
+        else if(out2)
+        {
+          memset((uint8_t*)out2, 0, sizeof(gr_complex) * n);
+        }
+      }
+    };
+
+    Transmitter::Transmitter()
+      : d_impl(new impl())
+    {
+    }
+
+    Transmitter::~Transmitter()
+    {
+    }
+
+    int
+    Transmitter::burst_len(int format, int mcs, int nss, int len) const
+    {
+      c8p_mod tmpMod;
+      if(!impl::valid(format, mcs, nss, len, &tmpMod))
+      {
+        return -1;
+      }
+      return impl::samples(&tmpMod);
+    }
+
+    int
+    Transmitter::generate(const uint8_t* psdu, int len, int format, int mcs, int nss, gr_complex* out1, gr_complex* out2, int max)
+    {
+      c8p_mod tmpMod;
+      if(!impl::valid(format, mcs, nss, len, &tmpMod) || (len > 0 && !psdu) || !out1 || (nss == 2 && !out2))
+      {
+        return -1;
+      }
+      int tmpN = impl::samples(&tmpMod);
+      if(tmpN > max)
+      {
+        return -1;
+      }
+      d_impl->run(psdu, len, format, mcs, nss, out1, out2, tmpN);
+      return tmpN;
+    }
+
+    } /* namespace phy */
+  } /* namespace ieee80211 */
+} /* namespace gr */
@@ -0,0 +1,354 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Zelin Yun.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <gnuradio/blocks/stream_to_vector.h>
+#include <gnuradio/blocks/vector_sink.h>
+#include <gnuradio/blocks/vector_source.h>
+#include <gnuradio/digital/ofdm_cyclic_prefixer.h>
+#include <gnuradio/fft/fft_v.h>
+#include <gnuradio/ieee80211/encode2.h>
+#include <gnuradio/ieee80211/modulation2.h>
+#include <gnuradio/ieee80211/pad2.h>
+#include <gnuradio/ieee80211/phy.h>
+#include <gnuradio/ieee80211/utils.h>
+#include <gnuradio/top_block.h>
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace gr {
+namespace ieee80211 {
+namespace phy {
+
+// mpdu of len bytes with its fcs
+static std::vector<uint8_t> phyMpdu(int len, std::mt19937& rng)
+{
+    std::vector<uint8_t> m(len);
+    for (int i = 0; i < len - 4; i++) {
+        m[i] = rng() & 0xff;
+    }
+    uint32_t fcs = utils::crc32_update(0, m.data(), len - 4);
+    memcpy(&m[len - 4], &fcs, 4);
+    return m;
+}
+
+// VHT A-MPDU delimiter, eof and len, crc-8 over the first 16 bits and the signature
+static void phyDelimiter(int len, bool eof, uint8_t* d)
+{
+    uint32_t bits = (eof ? 1 : 0) | (((len >> 12) & 3) << 2) | ((uint32_t)(len & 0xfff) << 4);
+    uint16_t c = 0xff;
+    for (int i = 0; i < 16; i++) {
+        c = c << 1;
+        if (c & 0x100) {
+            c = (c + 1) ^ 0x06;
+        }
+        if ((bits >> i) & 1) {
+            c ^= 0x07;
+        }
+    }
+    c = 0xff - (c & 0xff);
+    uint8_t crc = 0;
+    for (int i = 0; i < 8; i++) {
+        crc |= ((c >> (7 - i)) & 1) << i;
+    }
+    d[0] = bits & 0xff;
+    d[1] = (bits >> 8) & 0xff;
+    d[2] = crc;
+    d[3] = 0x4e;
+}
+
+// psdu of one packet, a plain mpdu for L and HT, an A-MPDU of nsub mpdus for VHT
+struct phyPacket {
+    int format;
+    int mcs;
+    int nss;
+    std::vector<uint8_t> psdu;
+    std::vector<std::vector<uint8_t>> mpdus;
+
+    phyPacket(int format, int mcs, int nss, int len, int nsub, std::mt19937& rng)
+        : format(format), mcs(mcs), nss(nss)
+    {
+        if (format != FORMAT_VHT) {
+            psdu = phyMpdu(len, rng);
+            mpdus.push_back(psdu);
+            return;
+        }
+        for (int s = 0; s < nsub; s++) {
+            mpdus.push_back(phyMpdu(len, rng));
+            uint8_t d[4];
+            phyDelimiter(len, nsub == 1, d);
+            psdu.insert(psdu.end(), d, d + 4);
+            psdu.insert(psdu.end(), mpdus.back().begin(), mpdus.back().end());
+            while (psdu.size() % 4) {
+                psdu.push_back(0);
+            }
+        }
+    }
+};
+
+// bursts of the packets through a mild 2x2 channel with cfo and noise, rx is
+// fed pieces of 1 to maxChunk samples, taps is the impulse response of every path
+static std::vector<Frame> phyLoopback(const std::vector<phyPacket>& pkts,
+                                      Receiver& rx,
+                                      float cfo,
+                                      float snrDb,
+                                      int maxChunk,
+                                      uint32_t seed,
+                                      const std::vector<gr_complex>& taps = { 1.0f })
+{
+    Transmitter tx;
+    std::vector<gr_complex> a1(2000), a2(2000);
+    for (const auto& p : pkts) {
+        int n = tx.burst_len(p.format, p.mcs, p.nss, p.psdu.size());
+        BOOST_REQUIRE_GT(n, 0);
+        std::vector<gr_complex> s1(n), s2(n);
+        BOOST_REQUIRE_EQUAL(tx.generate(p.psdu.data(), p.psdu.size(), p.format, p.mcs, p.nss, s1.data(), s2.data(), n), n);
+        a1.insert(a1.end(), s1.begin(), s1.end());
+        a2.insert(a2.end(), s2.begin(), s2.end());
+        a1.insert(a1.end(), 1000, 0);
+        a2.insert(a2.end(), 1000, 0);
+    }
+    double power = 0.0;
+    for (const auto& x : a1) {
+        power += std::norm(x);
+    }
+    power /= a1.size();
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> noise(0.0f, std::sqrt(power / std::pow(10.0f, snrDb / 10.0f) / 2.0f));
+    std::vector<gr_complex> r1(a1.size()), r2(a1.size());
+    for (size_t i = 0; i < a1.size(); i++) {
+        gr_complex m1 = 0.0f, m2 = 0.0f;
+        for (size_t k = 0; k < taps.size() && k <= i; k++) {
+            m1 += taps[k] * a1[i - k];
+            m2 += taps[k] * a2[i - k];
+        }
+        gr_complex ph = std::polar(1.0f, cfo * (float)i);
+        r1[i] = (m1 * 0.9f + m2 * gr_complex(0.1f, 0.3f)) * ph + gr_complex(noise(rng), noise(rng));
+        r2[i] = (m1 * gr_complex(0.2f, -0.1f) + m2 * 0.8f) * ph + gr_complex(noise(rng), noise(rng));
+    }
+    std::vector<Frame> frames;
+    std::uniform_int_distribution<int> chunk(1, maxChunk);
+    for (size_t i = 0; i < r1.size();) {
+        int n = std::min((size_t)chunk(rng), r1.size() - i);
+        rx.process(&r1[i], &r2[i], n, frames);
+        i += n;
+    }
+    return frames;
+}
+
+// bursts of the packets by encode2, modulation2, the ifft with cyclic prefix and pad2 as tx2
+static void phyTxChain(const std::vector<phyPacket>& pkts, std::vector<gr_complex>& out1, std::vector<gr_complex>& out2)
+{
+    std::vector<uint8_t> data;
+    std::vector<gr::tag_t> tags;
+    for (size_t k = 0; k < pkts.size(); k++) {
+        const phyPacket& p = pkts[k];
+        const std::pair<const char*, long> meta[] = {
+            { "format", p.format }, { "mcs0", p.mcs }, { "nss0", p.nss }, { "len0", (long)p.psdu.size() }, { "seq", (long)k }
+        };
+        for (const auto& m : meta) {
+            gr::tag_t tag;
+            tag.offset = data.size();
+            tag.key = pmt::intern(m.first);
+            tag.value = pmt::from_long(m.second);
+            tags.push_back(tag);
+        }
+        data.insert(data.end(), p.psdu.begin(), p.psdu.end());
+        data.insert(data.end(), 160, 0);
+    }
+    gr::top_block_sptr tb = gr::make_top_block("qa_phy_tx2");
+    gr::blocks::vector_source_b::sptr src = gr::blocks::vector_source_b::make(data, false, 1, tags);
+    encode2::sptr enc = encode2::make();
+    modulation2::sptr mod = modulation2::make();
+    pad2::sptr pad = pad2::make();
+    gr::blocks::vector_sink_c::sptr dst[2];
+    tb->connect(src, 0, enc, 0);
+    for (int i = 0; i < 2; i++) {
+        gr::blocks::stream_to_vector::sptr s2v = gr::blocks::stream_to_vector::make(sizeof(gr_complex), 64);
+        gr::fft::fft_v<gr_complex, false>::sptr ifft = gr::fft::fft_v<gr_complex, false>::make(64, std::vector<float>(), true, 1);
+        gr::digital::ofdm_cyclic_prefixer::sptr cp = gr::digital::ofdm_cyclic_prefixer::make((size_t)64, (size_t)80, 0, "packet_len");
+        dst[i] = gr::blocks::vector_sink_c::make();
+        tb->connect(enc, i, mod, i);
+        tb->connect(mod, i, s2v, 0);
+        tb->connect(s2v, 0, ifft, 0);
+        tb->connect(ifft, 0, cp, 0);
+        tb->connect(cp, 0, pad, i);
+        tb->connect(pad, i, dst[i], 0);
+    }
+    tb->run();
+    out1 = dst[0]->data();
+    out2 = dst[1]->data();
+}
+
+// every mpdu of the packets once and in order, with the format, mcs and nss of its packet
+static void phyCheck(const std::vector<phyPacket>& pkts, const std::vector<Frame>& frames)
+{
+    size_t f = 0;
+    int64_t lastSeq = -1;
+    for (const auto& p : pkts) {
+        for (size_t k = 0; k < p.mpdus.size(); k++, f++) {
+            BOOST_REQUIRE_LT(f, frames.size());
+            BOOST_TEST_CONTEXT("format " << p.format << ", mcs " << p.mcs << ", nss " << p.nss << ", mpdu " << k)
+            {
+                BOOST_CHECK(frames[f].mpdu == p.mpdus[k]);
+                BOOST_CHECK_EQUAL(frames[f].format, p.format);
+                BOOST_CHECK_EQUAL(frames[f].mcs, p.mcs);
+                BOOST_CHECK_EQUAL(frames[f].nss, p.nss);
+                if (k == 0) {
+                    BOOST_CHECK_GT((int64_t)frames[f].seq, lastSeq);
+                } else {
+                    BOOST_CHECK_EQUAL((int64_t)frames[f].seq, lastSeq);
+                }
+                lastSeq = frames[f].seq;
+            }
+        }
+    }
+    BOOST_CHECK_EQUAL(f, frames.size());
+}
+
+// L mcs 0 to 7, HT mcs 0 to 15, VHT 1 and 2 streams mcs 0 to 8 with 1 or 2 mpdus
+static std::vector<phyPacket> phyAllRates(uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<phyPacket> pkts;
+    for (int mcs = 0; mcs < 8; mcs++) {
+        pkts.emplace_back(FORMAT_L, mcs, 1, 100 + rng() % 400, 1, rng);
+    }
+    for (int mcs = 0; mcs < 16; mcs++) {
+        pkts.emplace_back(FORMAT_HT, mcs, mcs / 8 + 1, 100 + rng() % 400, 1, rng);
+    }
+    for (int nss = 1; nss <= 2; nss++) {
+        for (int mcs = 0; mcs < 9; mcs++) {
+            pkts.emplace_back(FORMAT_VHT, mcs, nss, 100 + rng() % 400, 1 + mcs % 2, rng);
+        }
+    }
+    return pkts;
+}
+
+BOOST_AUTO_TEST_SUITE(qa_ieee80211_phy)
+
+BOOST_AUTO_TEST_CASE(test_loopback_llr_types)
+{
+    // all the rates with each llr type, 30 kHz of cfo and pieces of up to 3000 samples
+    std::vector<phyPacket> pkts = phyAllRates(1);
+    for (int llrType = 0; llrType < 3; llrType++) {
+        BOOST_TEST_CONTEXT("llr type " << llrType)
+        {
+            Receiver rx(2, llrType);
+            phyCheck(pkts, phyLoopback(pkts, rx, 2.0f * M_PI * 30e3f / 20e6f, 35.0f, 3000, 10 + llrType));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_loopback_multipath)
+{
+    // a second path 4 samples later at 0.9 of the first fades some subcarriers by
+    // about 20 dB, the llr weights have to follow the channel of each subcarrier
+    // for the high rates to decode
+    std::vector<phyPacket> pkts = phyAllRates(4);
+    for (int llrType : { 0, 2 }) {
+        BOOST_TEST_CONTEXT("llr type " << llrType)
+        {
+            Receiver rx(2, llrType);
+            phyCheck(pkts, phyLoopback(pkts, rx, 2.0f * M_PI * 20e3f / 20e6f, 35.0f, 3000, 40 + llrType, { 1.0f, 0.0f, 0.0f, 0.0f, gr_complex(0.7f, 0.56f) }));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_loopback_one_antenna)
+{
+    // one antenna decodes the one stream packets and drops the others
+    std::vector<phyPacket> pkts = phyAllRates(2);
+    std::vector<phyPacket> pkts1;
+    for (const auto& p : pkts) {
+        if (p.nss == 1) {
+            pkts1.push_back(p);
+        }
+    }
+    Receiver rx(1, 0);
+    phyCheck(pkts1, phyLoopback(pkts, rx, -2.0f * M_PI * 50e3f / 20e6f, 35.0f, 5000, 20));
+}
+
+BOOST_AUTO_TEST_CASE(test_loopback_chunks)
+{
+    // the frames do not depend on how the samples are cut into calls
+    std::vector<phyPacket> pkts = phyAllRates(3);
+    std::vector<std::vector<Frame>> frames;
+    for (int maxChunk : { 1 << 30, 20000, 700, 80 }) {
+        Receiver rx(2, 2);
+        frames.push_back(phyLoopback(pkts, rx, 2.0f * M_PI * 10e3f / 20e6f, 35.0f, maxChunk, 30));
+    }
+    phyCheck(pkts, frames[0]);
+    for (size_t c = 1; c < frames.size(); c++) {
+        BOOST_REQUIRE_EQUAL(frames[c].size(), frames[0].size());
+        for (size_t f = 0; f < frames[0].size(); f++) {
+            BOOST_CHECK(frames[c][f].mpdu == frames[0][f].mpdu);
+            BOOST_CHECK_EQUAL(frames[c][f].seq, frames[0][f].seq);
+            BOOST_CHECK_EQUAL(frames[c][f].offset, frames[0][f].offset);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_transmitter_chain)
+{
+    // the bursts of the Transmitter are the samples of the tx2 blocks, L, HT and VHT
+    // with 1 and 2 streams
+    std::mt19937 rng(4);
+    std::vector<phyPacket> pkts;
+    pkts.emplace_back(FORMAT_L, 0, 1, 120, 1, rng);
+    pkts.emplace_back(FORMAT_L, 5, 1, 700, 1, rng);
+    pkts.emplace_back(FORMAT_HT, 2, 1, 400, 1, rng);
+    pkts.emplace_back(FORMAT_HT, 12, 2, 900, 1, rng);
+    pkts.emplace_back(FORMAT_VHT, 4, 1, 300, 2, rng);
+    pkts.emplace_back(FORMAT_VHT, 8, 2, 500, 2, rng);
+    std::vector<gr_complex> c1, c2;
+    phyTxChain(pkts, c1, c2);
+    Transmitter tx;
+    size_t pos = 0;
+    for (const auto& p : pkts) {
+        BOOST_TEST_CONTEXT("format " << p.format << ", mcs " << p.mcs << ", nss " << p.nss)
+        {
+            int n = tx.burst_len(p.format, p.mcs, p.nss, p.psdu.size());
+            std::vector<gr_complex> s1(n), s2(n);
+            BOOST_REQUIRE_EQUAL(tx.generate(p.psdu.data(), p.psdu.size(), p.format, p.mcs, p.nss, s1.data(), s2.data(), n), n);
+            BOOST_REQUIRE_LE(pos + n, c1.size());
+            float peak = 0.0f, diff = 0.0f;
+            for (int i = 0; i < n; i++) {
+                peak = std::max(peak, std::abs(c1[pos + i]));
+                diff = std::max(diff, std::abs(s1[i] - c1[pos + i]));
+                diff = std::max(diff, std::abs(s2[i] - c2[pos + i]));
+            }
+            BOOST_CHECK_GT(peak, 0.0f);
+            BOOST_CHECK_LE(diff, peak * 1e-5f);
+            pos += n;
+        }
+    }
+    BOOST_CHECK_EQUAL(pos, c1.size());
+}
+
+BOOST_AUTO_TEST_CASE(test_transmitter_params)
+{
+    Transmitter tx;
+    BOOST_CHECK_EQUAL(tx.burst_len(FORMAT_L, 8, 1, 100), -1);
+    BOOST_CHECK_EQUAL(tx.burst_len(FORMAT_HT, 8, 1, 100), -1);
+    BOOST_CHECK_EQUAL(tx.burst_len(FORMAT_VHT, 9, 1, 100), -1);
+    BOOST_CHECK_EQUAL(tx.burst_len(FORMAT_L, 0, 1, 4096), -1);
+    BOOST_CHECK_GT(tx.burst_len(FORMAT_VHT, 0, 2, 0), 0);
+    // a buffer shorter than the burst is not written
+    std::vector<uint8_t> psdu(100);
+    std::vector<gr_complex> s1(tx.burst_len(FORMAT_L, 0, 1, 100) - 1);
+    BOOST_CHECK_EQUAL(tx.generate(psdu.data(), psdu.size(), FORMAT_L, 0, 1, s1.data(), nullptr, s1.size()), -1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace phy
+} // namespace ieee80211
+} // namespace gr
@@ -0,0 +1,132 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Zelin Yun.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <gnuradio/ieee80211/utils.h>
+#include <boost/test/unit_test.hpp>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+#include "cloud80211rx.h"
+
+namespace gr {
+namespace ieee80211 {
+
+// mpdu of len bytes with its fcs
+static std::vector<uint8_t> rxMpdu(int len, std::mt19937& rng)
+{
+    std::vector<uint8_t> m(len);
+    for (int i = 0; i < len - 4; i++) {
+        m[i] = rng() & 0xff;
+    }
+    uint32_t fcs = utils::crc32_update(0, m.data(), len - 4);
+    memcpy(&m[len - 4], &fcs, 4);
+    return m;
+}
+
+// HT A-MPDU delimiter of len, crc-8 over the first 16 bits and the signature
+static std::vector<uint8_t> rxDelimiter(int len)
+{
+    uint32_t bits = (uint32_t)(len & 0xfff) << 4;
+    uint16_t c = 0xff;
+    for (int i = 0; i < 16; i++) {
+        c = c << 1;
+        if (c & 0x100) {
+            c = (c + 1) ^ 0x06;
+        }
+        if ((bits >> i) & 1) {
+            c ^= 0x07;
+        }
+    }
+    c = 0xff - (c & 0xff);
+    uint8_t crc = 0;
+    for (int i = 0; i < 8; i++) {
+        crc |= ((c >> (7 - i)) & 1) << i;
+    }
+    return { (uint8_t)(bits & 0xff), (uint8_t)((bits >> 8) & 0xff), crc, 0x4e };
+}
+
+struct rxSubframe {
+    std::vector<uint8_t> mpdu;
+    uint32_t crc;
+};
+
+BOOST_AUTO_TEST_SUITE(qa_ieee80211_rx)
+
+BOOST_AUTO_TEST_CASE(test_ht_ampdu_subframes)
+{
+    // subframe a, a padding delimiter, subframe b behind a corrupted delimiter,
+    // subframe c with a bad fcs and the last subframe d without padding
+    std::mt19937 rng(1);
+    std::vector<uint8_t> a = rxMpdu(100, rng);
+    std::vector<uint8_t> b = rxMpdu(60, rng);
+    std::vector<uint8_t> c = rxMpdu(81, rng);
+    std::vector<uint8_t> d = rxMpdu(50, rng);
+    c[20] ^= 0x10;
+    std::vector<uint8_t> psdu;
+    auto add = [&psdu](const std::vector<uint8_t>& del, const std::vector<uint8_t>& m, bool pad) {
+        psdu.insert(psdu.end(), del.begin(), del.end());
+        psdu.insert(psdu.end(), m.begin(), m.end());
+        while (pad && psdu.size() % 4) {
+            psdu.push_back(0);
+        }
+    };
+    std::vector<uint8_t> badDel = rxDelimiter(b.size());
+    badDel[2] ^= 0x01;
+    add(rxDelimiter(a.size()), a, true);
+    add(rxDelimiter(0), {}, true);
+    add(badDel, b, true);
+    add(rxDelimiter(c.size()), c, true);
+    add(rxDelimiter(d.size()), d, false);
+
+    // psdu after the 2 service bytes as svDataDecoder leaves it
+    std::unique_ptr<c8pRxFrame> frame(new c8pRxFrame());
+    int trellis = 16 + psdu.size() * 8 + 6;
+    memset(frame->dec.unCodedBytes, 0, SV_B_MAX);
+    memcpy(&frame->dec.unCodedBytes[2], psdu.data(), psdu.size());
+    frame->format = C8P_F_HT;
+    frame->ampdu = 1;
+    frame->len = psdu.size();
+
+    // all at once and as the windowed traceback commits bytes give the same subframes
+    for (int step : { trellis, 64, 8 }) {
+        BOOST_TEST_CONTEXT("bits per call " << step)
+        {
+            std::vector<rxSubframe> subs;
+            frame->parser.init(C8P_F_HT, psdu.size(), trellis);
+            for (int done = 0; !frame->parser.done;) {
+                done = std::min(done + step, trellis);
+                frame->dec.dsDone = done;
+                frame->parser.subframes(&frame->dec, [&subs](const uint8_t* mpdu, int len, uint32_t crc) {
+                    subs.push_back({ std::vector<uint8_t>(mpdu, mpdu + len), crc });
+                });
+                BOOST_REQUIRE(done < trellis || frame->parser.done);
+            }
+            BOOST_REQUIRE_EQUAL(subs.size(), 3u);
+            BOOST_CHECK(subs[0].mpdu == a);
+            BOOST_CHECK_EQUAL(subs[0].crc, (uint32_t)C8P_RX_FCS_RESIDUE);
+            BOOST_CHECK(subs[1].mpdu == c);
+            BOOST_CHECK_NE(subs[1].crc, (uint32_t)C8P_RX_FCS_RESIDUE);
+            BOOST_CHECK(subs[2].mpdu == d);
+            BOOST_CHECK_EQUAL(subs[2].crc, (uint32_t)C8P_RX_FCS_RESIDUE);
+        }
+    }
+
+    // the frame passes on the ones with a correct fcs
+    std::vector<std::vector<uint8_t>> mpdus;
+    frame->parser.init(C8P_F_HT, psdu.size(), trellis);
+    frame->dec.dsDone = trellis;
+    frame->mpdus([&mpdus](const uint8_t* mpdu, int len) { mpdus.emplace_back(mpdu, mpdu + len); });
+    BOOST_REQUIRE_EQUAL(mpdus.size(), 2u);
+    BOOST_CHECK(mpdus[0] == a);
+    BOOST_CHECK(mpdus[1] == d);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ieee80211
+} // namespace gr
@@ -0,0 +1,335 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2022 Zelin Yun.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+#include "cloud80211phy.h"
+#include "cloud80211viterbi.h"
+#include "decode_impl.h"
+
+namespace gr {
+namespace ieee80211 {
+
+// Data field bits of len bytes with the zero tail, bcc coded, punctured and
+// sent as bpsk, llr > 0 for bit 1
+struct viterbiPacket {
+    int trellis;
+    int cr;
+    std::vector<uint8_t> bits;
+    std::vector<float> llr;
+
+    viterbiPacket(int len, int cr, float snrDb, uint32_t seed) : trellis(len * 8 + 22), cr(cr)
+    {
+        std::mt19937 rng(seed);
+        bits.assign(trellis, 0);
+        for (int i = 0; i < trellis - 6; i++) {
+            bits[i] = rng() & 1;
+        }
+        std::vector<uint8_t> coded(trellis * 2), punct(trellis * 2);
+        bccEncoder(bits.data(), coded.data(), trellis);
+        c8p_mod mod;
+        mod.cr = cr;
+        punctEncoder(coded.data(), punct.data(), trellis * 2, &mod);
+        svDataDecoder* tmpDec = new svDataDecoder();
+        tmpDec->init(trellis, cr);
+        int nLlr = tmpDec->llrPos(trellis);
+        delete tmpDec;
+        std::normal_distribution<float> noise(0.0f, std::sqrt(0.5f / std::pow(10.0f, snrDb / 10.0f)));
+        llr.resize(nLlr);
+        for (int i = 0; i < nLlr; i++) {
+            llr[i] = (punct[i] ? 1.0f : -1.0f) + noise(rng);
+        }
+    }
+
+    int errors(const uint8_t* bytes) const
+    {
+        int n = 0;
+        for (int i = 0; i < trellis; i++) {
+            n += ((bytes[i / 8] >> (i % 8)) & 1) != bits[i];
+        }
+        return n;
+    }
+};
+
+// the whole trellis by one decoder
+static void viterbiFull(const viterbiPacket& p, svDataDecoder* dec)
+{
+    dec->init(p.trellis, p.cr);
+    dec->update(p.llr.data(), p.llr.size());
+    dec->end();
+}
+
+// segment seg of nseg as a decode worker does it, bits are copied into out
+static void viterbiSegment(const viterbiPacket& p, int nseg, int seg, int overlap, svDataDecoder* dec, uint8_t* out)
+{
+    svSegment span = svSegmentSplit(p.trellis, seg, nseg, overlap);
+    dec->initSegment(p.cr, span.warm, span.begin, span.last);
+    int pos = dec->llrPos(span.warm);
+    dec->update(&p.llr[pos], p.llr.size() - pos);
+    if (span.last == p.trellis) {
+        dec->end();
+    } else {
+        dec->traceback(span.end);
+    }
+    memcpy(&out[span.begin / 8], &dec->scramBytes[span.begin / 8], (span.end - span.begin + 7) / 8);
+}
+
+static int viterbiSegmented(const viterbiPacket& p, int nseg, int overlap, std::vector<std::unique_ptr<svDataDecoder>>& decs, uint8_t* out)
+{
+    std::vector<std::thread> workers;
+    for (int s = 0; s < nseg; s++) {
+        workers.emplace_back(viterbiSegment, std::cref(p), nseg, s, overlap, decs[s].get(), out);
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    return p.errors(out);
+}
+
+// one trellis step straight from SV_STATE_NEXT and SV_STATE_OUTPUT, bit n of the
+// survivor word is set when the odd predecessor of n wins
+template <typename T>
+static uint64_t viterbiAcsStep(T t0, T t1, T* pm)
+{
+    T next[SV_N_STATE];
+    uint64_t word = 0;
+    for (int n = 0; n < SV_N_STATE; n++) {
+        T m[2];
+        for (int k = 0; k < 2; k++) {
+            int p = ((n & 31) << 1) | k;
+            int c = SV_STATE_OUTPUT[p][n >> 5];
+            m[k] = pm[p] + (((c & 2) ? t0 : T(0)) + ((c & 1) ? t1 : T(0)));
+        }
+        word |= (uint64_t)(m[1] > m[0]) << n;
+        next[n] = std::max(m[0], m[1]);
+    }
+    std::copy(next, next + SV_N_STATE, pm);
+    return word;
+}
+
+BOOST_AUTO_TEST_SUITE(qa_ieee80211_viterbi)
+
+BOOST_AUTO_TEST_CASE(test_acs_kernels)
+{
+    // every kernel this cpu has against the reference step, the float metrics bit
+    // for bit and the wrapping int16 metrics against int32 ones mod 2^16
+    const int nStep = 2000;
+    for (int p = 0; p < SV_N_STATE; p++) {
+        BOOST_REQUIRE_EQUAL(SV_STATE_NEXT[p][0], p >> 1);
+        BOOST_REQUIRE_EQUAL(SV_STATE_NEXT[p][1], (p >> 1) | 32);
+    }
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> fbm(-4.0f, 4.0f);
+    std::uniform_int_distribution<int> ibm(-256, 256);
+    std::vector<float> bm(nStep * 2);
+    std::vector<int16_t> bmI(nStep * 2);
+    for (int i = 0; i < nStep * 2; i++) {
+        bm[i] = fbm(rng);
+        bmI[i] = ibm(rng);
+    }
+    std::vector<float> pmRef(SV_N_STATE, SV_METRIC_INIT);
+    std::vector<int32_t> pmRefI(SV_N_STATE, SV_METRIC_INIT_I16);
+    pmRef[0] = 0.0f;
+    pmRefI[0] = 0;
+    std::vector<uint64_t> decRef(nStep), decRefI(nStep);
+    for (int t = 0; t < nStep; t++) {
+        decRef[t] = viterbiAcsStep(bm[t * 2], bm[t * 2 + 1], pmRef.data());
+        decRefI[t] = viterbiAcsStep<int32_t>(bmI[t * 2], bmI[t * 2 + 1], pmRefI.data());
+    }
+
+    for (int kernel : { SV_ACS_SCALAR, SV_ACS_AVX2, SV_ACS_AVX512 }) {
+        if (kernel > svAcsKernel()) {
+            BOOST_TEST_MESSAGE("acs kernel " << svAcsKernelName(kernel) << " not on this cpu");
+            continue;
+        }
+        BOOST_TEST_CONTEXT("acs kernel " << svAcsKernelName(kernel))
+        {
+            // in pieces as the decoder runs it
+            std::vector<float> pm(SV_N_STATE, SV_METRIC_INIT);
+            pm[0] = 0.0f;
+            std::vector<uint64_t> dec(nStep);
+            for (int t = 0; t < nStep; t += SV_ACS_CHUNK) {
+                svAcsRunKernel(kernel, &bm[t * 2], std::min(SV_ACS_CHUNK, nStep - t), pm.data(), &dec[t]);
+            }
+            BOOST_CHECK(dec == decRef);
+            BOOST_CHECK(pm == pmRef);
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+            if (kernel == SV_ACS_AVX512 && !__builtin_cpu_supports("avx512bw")) {
+                BOOST_TEST_MESSAGE("acs kernel avx512 int16 needs avx512bw");
+                continue;
+            }
+#endif
+            std::vector<int16_t> pmI(SV_N_STATE, SV_METRIC_INIT_I16);
+            pmI[0] = 0;
+            for (int t = 0; t < nStep; t += SV_ACS_CHUNK) {
+                svAcsRunKernelI16(kernel, &bmI[t * 2], std::min(SV_ACS_CHUNK, nStep - t), pmI.data(), &dec[t]);
+            }
+            BOOST_CHECK(dec == decRefI);
+            for (int n = 0; n < SV_N_STATE; n++) {
+                BOOST_CHECK_EQUAL(pmI[n], (int16_t)pmRefI[n]);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_sig_decoder)
+{
+    // the fixed length decoders of L-SIG, VHT-SIG-B and HT-SIG or VHT-SIG-A give
+    // the bits of the reference decoder, also when the noise leaves bit errors
+    std::mt19937 rng(7);
+    svSigDecoder dec;
+    for (int len : { 24, 26, 48 }) {
+        for (float snrDb : { -4.0f, 0.0f, 10.0f }) {
+            BOOST_TEST_CONTEXT("trellis " << len << ", snr " << snrDb)
+            {
+                std::normal_distribution<float> noise(0.0f, std::sqrt(0.5f / std::pow(10.0f, snrDb / 10.0f)));
+                int errors = 0;
+                for (int k = 0; k < 200; k++) {
+                    uint8_t bits[SV_SIG_T_MAX] = { 0 };
+                    uint8_t coded[SV_SIG_T_MAX * 2];
+                    float llr[SV_SIG_T_MAX * 2];
+                    for (int i = 0; i < len - 6; i++) {
+                        bits[i] = rng() & 1;
+                    }
+                    bccEncoder(bits, coded, len);
+                    for (int i = 0; i < len * 2; i++) {
+                        llr[i] = (coded[i] ? 1.0f : -1.0f) + noise(rng);
+                    }
+                    uint8_t ref[SV_SIG_T_MAX], out[SV_SIG_T_MAX];
+                    SV_Decode_Sig(llr, ref, len);
+                    dec.decode(llr, out, len);
+                    BOOST_CHECK(std::equal(out, out + len, ref));
+                    for (int i = 0; i < len; i++) {
+                        errors += ref[i] != bits[i];
+                    }
+                }
+                BOOST_TEST_MESSAGE("sig trellis " << len << ", snr " << snrDb << ": bit errors " << errors);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_windowed_traceback)
+{
+    // llr fed in chunks with the windowed traceback and descrambling of decode
+    // give the bytes of one traceback at the end of the trellis
+    const int crs[] = { C8P_CR_12, C8P_CR_23, C8P_CR_34, C8P_CR_56 };
+    const float snrs[] = { 2.0f, 4.0f, 5.0f, 6.0f };
+    std::unique_ptr<svDataDecoder> ref(new svDataDecoder());
+    std::unique_ptr<svDataDecoder> dec(new svDataDecoder());
+    for (int c = 0; c < 4; c++) {
+        viterbiPacket p(1500, crs[c], snrs[c], 200 + c);
+        viterbiFull(p, ref.get());
+        ref->descramble();
+        int nBytes = (p.trellis + 7) / 8;
+        for (int depth : { 96, 144 }) {
+            for (int chunk : { 37, 416, 2000 }) {
+                BOOST_TEST_CONTEXT("cr " << crs[c] << ", tbdepth " << depth << ", llr per call " << chunk)
+                {
+                    dec->init(p.trellis, p.cr);
+                    int windowed = 0;
+                    // update leaves the llr of a split pair to the next call as decode does
+                    for (int pos = 0, n = 0; pos < (int)p.llr.size(); pos += dec->update(&p.llr[pos], n - pos)) {
+                        n = std::min(n + chunk, (int)p.llr.size());
+                        if ((dec->t - depth - dec->tbDone) >= DECODE_TB_STEP) {
+                            dec->traceback(dec->t - depth);
+                            dec->descramble();
+                            windowed++;
+                            BOOST_CHECK(std::equal(dec->unCodedBytes, dec->unCodedBytes + dec->dsDone / 8, ref->unCodedBytes));
+                        }
+                    }
+                    BOOST_CHECK_GT(windowed, 0);
+                    dec->end();
+                    dec->descramble();
+                    BOOST_CHECK_EQUAL(dec->dsDone, ref->dsDone);
+                    BOOST_CHECK(std::equal(dec->unCodedBytes, dec->unCodedBytes + nBytes, ref->unCodedBytes));
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_segment_split)
+{
+    // the segments of decode tile the trellis on byte boundaries, and one 4095 byte
+    // MCS0 packet cut into them decodes as the whole trellis does, the latency is
+    // measured by tools/performance/perf_segments.py
+    for (int trellis : { DECODE_SEG_MIN, 5000, DECODE_B_MAX * 8 + 22 }) {
+        for (int nseg = 1; nseg <= 8; nseg++) {
+            BOOST_TEST_CONTEXT("trellis " << trellis << ", nsegments " << nseg)
+            {
+                int next = 0;
+                for (int s = 0; s < nseg; s++) {
+                    svSegment span = svSegmentSplit(trellis, s, nseg, DECODE_SEG_OVERLAP);
+                    BOOST_CHECK_EQUAL(span.begin, next);
+                    BOOST_CHECK_EQUAL(span.begin % 8, 0);
+                    BOOST_CHECK_LT(span.begin, span.end);
+                    BOOST_CHECK_EQUAL(span.warm, std::max(0, span.begin - DECODE_SEG_OVERLAP));
+                    BOOST_CHECK_EQUAL(span.last, std::min(trellis, span.end + DECODE_SEG_OVERLAP));
+                    next = span.end;
+                }
+                BOOST_CHECK_EQUAL(next, trellis);
+            }
+        }
+    }
+
+    viterbiPacket p(DECODE_B_MAX, C8P_CR_12, 6.0f, 1);
+    std::vector<std::unique_ptr<svDataDecoder>> decs;
+    for (int s = 0; s < 8; s++) {
+        decs.emplace_back(new svDataDecoder());
+    }
+    viterbiFull(p, decs[0].get());
+    std::vector<uint8_t> ref(decs[0]->scramBytes, decs[0]->scramBytes + (p.trellis + 7) / 8);
+    BOOST_REQUIRE_EQUAL(p.errors(ref.data()), 0);
+    for (int nseg : { 1, 2, 4, 8 }) {
+        BOOST_TEST_CONTEXT("nsegments " << nseg)
+        {
+            std::vector<uint8_t> out(SV_B_MAX, 0);
+            BOOST_CHECK_EQUAL(viterbiSegmented(p, nseg, DECODE_SEG_OVERLAP, decs, out.data()), 0);
+            BOOST_CHECK(std::equal(ref.begin(), ref.end(), out.begin()));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_segment_overlap_ber)
+{
+    // bit errors of 8 segments against the whole trellis near the threshold of each code rate
+    const int crs[] = { C8P_CR_12, C8P_CR_23, C8P_CR_34, C8P_CR_56 };
+    const float snrs[] = { -0.5f, 1.5f, 2.5f, 3.5f };
+    std::vector<std::unique_ptr<svDataDecoder>> decs;
+    for (int s = 0; s < 8; s++) {
+        decs.emplace_back(new svDataDecoder());
+    }
+    std::vector<uint8_t> out(SV_B_MAX);
+    for (int c = 0; c < 4; c++) {
+        for (int overlap : { 16, 32, 64, DECODE_SEG_OVERLAP }) {
+            int errFull = 0, errSeg = 0;
+            for (int k = 0; k < 8; k++) {
+                viterbiPacket p(DECODE_B_MAX, crs[c], snrs[c], 100 + k);
+                viterbiFull(p, decs[0].get());
+                errFull += p.errors(decs[0]->scramBytes);
+                std::fill(out.begin(), out.end(), 0);
+                errSeg += viterbiSegmented(p, 8, overlap, decs, out.data());
+            }
+            BOOST_TEST_MESSAGE("viterbi cr " << crs[c] << ", overlap " << overlap << ": bit errors whole " << errFull << ", 8 segments " << errSeg);
+            if (overlap >= 64) {
+                BOOST_CHECK_EQUAL(errSeg, errFull);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ieee80211
+} // namespace gr
@@ -0,0 +1,309 @@
+/*
+ *
+ *     GNU Radio IEEE 802.11a/g/n/ac 2x2
+ *     Packet parallel receiver of 802.11a/g/n/ac 1x1 and 2x2 formats
+ *     Copyright (C) June 1, 2022  Zelin Yun
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU Affero General Public License as published
+ *     by the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU Affero General Public License for more details.
+ *
+ *     You should have received a copy of the GNU Affero General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gnuradio/io_signature.h>
+#include <volk/volk.h>
+#include "rx_parallel_impl.h"
+
+namespace gr {
+  namespace ieee80211 {
+
+    rx_parallel::sptr
+    rx_parallel::make(int nworkers, int llrtype)
+    {
+      return gnuradio::make_block_sptr<rx_parallel_impl>(nworkers, llrtype
+        );
+    }
+
+    rx_parallel_impl::rx_parallel_impl(int nworkers, int llrtype)
+      : gr::block("rx_parallel",
+              gr::io_signature::makev(3, 3, std::vector<int>{sizeof(uint8_t), sizeof(gr_complex), sizeof(gr_complex)}),
+              gr::io_signature::make(0, 0, 0))
+    {
+      d_pmtOut = pmt::mp("out");
+      d_pmtLen = pmt::mp("len");
+      d_pmtSeq = pmt::mp("seq");
+      message_port_register_out(d_pmtOut);
+
+      d_sRx = RXP_S_TRIGGER;
+      d_nPktSeq = 0;
+      d_job = nullptr;
+      d_ring1 = std::vector<gr_complex>(RXP_RING, gr_complex(0.0f, 0.0f));
+      d_ring2 = std::vector<gr_complex>(RXP_RING, gr_complex(0.0f, 0.0f));
+      d_ringHead = 0;
+      d_ringTail = 0;
+      d_nWorker = std::min(std::max(1, nworkers), RXP_W_MAX);
+      d_llrType = llrtype;
+      d_stop = false;
+      // two jobs per worker, one being copied or waiting while the other is processed
+      for(int i=0;i<d_nWorker * 2;i++)
+      {
+        d_jobs.push_back(new rxpJob());
+        d_jobFree.push_back(d_jobs.back());
+      }
+      for(int i=0;i<d_nWorker;i++)
+      {
+        d_workerStates.push_back(new rxpWorker(llrtype));
+      }
+
+      set_tag_propagation_policy(block::TPP_DONT);
+    }
+
+    rx_parallel_impl::~rx_parallel_impl()
+    {
+      for(rxpJob* tmpJob : d_jobs)
+      {
+        delete tmpJob;
+      }
+      for(rxpWorker* tmpWorker : d_workerStates)
+      {
+        delete tmpWorker;
+      }
+    }
+
+    bool
+    rx_parallel_impl::start()
+    {
+      d_stop = false;
+      for(int i=0;i<d_nWorker;i++)
+      {
+        d_workers.push_back(std::thread(&rx_parallel_impl::workerLoop, this, i));
+      }
+      return block::start();
+    }
+
+    bool
+    rx_parallel_impl::stop()
+    {
+      {
+        std::lock_guard<std::mutex> tmpLock(d_mutex);
+        d_stop = true;
+      }
+      d_cvQueue.notify_all();
+      for(auto& tmpWorker : d_workers)
+      {
+        tmpWorker.join();
+      }
+      d_workers.clear();
+      return block::stop();
+    }
+
+    void
+    rx_parallel_impl::forecast (int noutput_items, gr_vector_int &ninput_items_required)
+    {
+      ninput_items_required[0] = noutput_items + C8P_RX_SIG_SAMP;
+      ninput_items_required[1] = noutput_items + C8P_RX_SIG_SAMP;
+      ninput_items_required[2] = noutput_items + C8P_RX_SIG_SAMP;
+    }
+
+    int
+    rx_parallel_impl::general_work (int noutput_items,
+                       gr_vector_int &ninput_items,
+                       gr_vector_const_void_star &input_items,
+                       gr_vector_void_star &output_items)
+    {
+      const uint8_t* sync = static_cast<const uint8_t*>(input_items[0]);
+      const gr_complex* inSig1 = static_cast<const gr_complex*>(input_items[1]);
+      const gr_complex* inSig2 = static_cast<const gr_complex*>(input_items[2]);
+      d_nProc = std::min(std::min(ninput_items[0], ninput_items[1]), ninput_items[2]);
+      d_nUsed = 0;
+
+      if(d_sRx == RXP_S_TRIGGER)
+      {
+        int i;
+        for(i=0;i<d_nProc;i++)
+        {
+          if(sync[i])
+          {
+            get_tags_in_range(d_tags, 0, nitems_read(0) + i, nitems_read(0) + i + 1);
+            c8p_pkt tmpPktCopy;
+            const c8p_pkt* tmpPkt = c8pPktFind(d_tags, &tmpPktCopy);
+            if (tmpPkt)
+            {
+              d_cfoRad = tmpPkt->rad;
+              d_snr = tmpPkt->snr;
+              d_sRx = RXP_S_SIG;
+            }
+            else
+            {
+              std::cout<<"ieee80211 rx_parallel, error: input sync with no tag."<<std::endl;
+              i++;
+            }
+            break;
+          }
+        }
+        d_nUsed += i;
+      }
+
+      if(d_sRx == RXP_S_SIG)
+      {
+        if((d_nProc - d_nUsed) >= C8P_RX_SIG_SAMP)
+        {
+          if(d_rxSig.run(&inSig1[d_nUsed], d_cfoRad))
+          {
+            d_nPktSeq++;
+            if(d_nPktSeq >= 1000000000){d_nPktSeq = 0;}
+            int tmpSpan = d_rxSig.nSamp + C8P_RX_PAD;
+            int64_t tmpPos = d_ringHead;
+            if((tmpPos % RXP_RING) + tmpSpan > RXP_RING)
+            {
+              // a span is never split, skip the rest of the ring
+              tmpPos += RXP_RING - (tmpPos % RXP_RING);
+            }
+            {
+              // the workers always make progress, jobs and ring space are freed once their packets are published
+              std::unique_lock<std::mutex> tmpLock(d_mutex);
+              d_cvFree.wait(tmpLock, [this, tmpPos, tmpSpan]{return !d_jobFree.empty() && (tmpPos + tmpSpan - d_ringTail) <= RXP_RING;});
+              d_job = d_jobFree.front();
+              d_jobFree.pop_front();
+            }
+            d_ringHead = tmpPos + tmpSpan;
+            d_job->seq = d_nPktSeq;
+            d_job->sigMcs = d_rxSig.mcs;
+            d_job->sigLen = d_rxSig.len;
+            d_job->rad = d_cfoRad;
+            d_job->snr = d_snr;
+            std::copy(d_rxSig.h.begin(), d_rxSig.h.begin() + 64, d_job->chan);
+            d_job->pos = tmpPos;
+            d_job->end = d_ringHead;
+            d_job->nSamp = d_rxSig.nSamp;
+            d_job->done = false;
+            d_job->decoded = false;
+            d_nCopied = 0;
+            d_sRx = RXP_S_COPY;
+            d_nUsed += C8P_RX_SIG_SAMP;
+          }
+          else
+          {
+            d_sRx = RXP_S_TRIGGER;
+            d_nUsed += 80;
+          }
+        }
+      }
+
+      if(d_sRx == RXP_S_COPY)
+      {
+        int tmpNum = std::min(d_nProc - d_nUsed, d_job->nSamp - d_nCopied);
+        int tmpOff = (int)(d_job->pos % RXP_RING) + d_nCopied;
+        memcpy(&d_ring1[tmpOff], &inSig1[d_nUsed], sizeof(gr_complex) * tmpNum);
+        memcpy(&d_ring2[tmpOff], &inSig2[d_nUsed], sizeof(gr_complex) * tmpNum);
+        d_nCopied += tmpNum;
+        d_nUsed += tmpNum;
+        if(d_nCopied >= d_job->nSamp)
+        {
+          tmpOff += tmpNum;
+          memset((uint8_t*)&d_ring1[tmpOff], 0, sizeof(gr_complex) * C8P_RX_PAD);
+          memset((uint8_t*)&d_ring2[tmpOff], 0, sizeof(gr_complex) * C8P_RX_PAD);
+          std::lock_guard<std::mutex> tmpLock(d_mutex);
+          d_jobOrder.push_back(d_job);
+          d_jobQueue.push_back(d_job);
+          d_cvQueue.notify_one();
+          d_sRx = RXP_S_TRIGGER;
+        }
+      }
+
+      if(d_sRx == RXP_S_TRIGGER && d_nUsed == d_nProc)
+      {
+        // caught up with the input, the packets in flight go out now so none is left on a worker when a finite stream ends
+        std::unique_lock<std::mutex> tmpLock(d_mutex);
+        d_cvFree.wait(tmpLock, [this]{return d_jobOrder.empty();});
+      }
+
+      consume_each(d_nUsed);
+      return 0;
+    }
+
+    void
+    rx_parallel_impl::workerLoop(int id)
+    {
+      rxpWorker* tmpWorker = d_workerStates[id];
+      while(true)
+      {
+        rxpJob* tmpJob;
+        {
+          std::unique_lock<std::mutex> tmpLock(d_mutex);
+          d_cvQueue.wait(tmpLock, [this]{return d_stop || !d_jobQueue.empty();});
+          if(d_jobQueue.empty())
+          {
+            return;
+          }
+          tmpJob = d_jobQueue.front();
+          d_jobQueue.pop_front();
+        }
+        jobRun(tmpJob, tmpWorker);
+        std::lock_guard<std::mutex> tmpLock(d_mutex);
+        tmpJob->done = true;
+        jobPublish();
+      }
+    }
+
+    void
+    rx_parallel_impl::jobRun(rxpJob* job, rxpWorker* worker)
+    {
+      // the span starts after the legacy signal, the cfo phase goes on from there
+      gr_complex* tmpSig1 = &d_ring1[job->pos % RXP_RING];
+      gr_complex* tmpSig2 = &d_ring2[job->pos % RXP_RING];
+      gr_complex tmpStep = std::polar(1.0f, job->rad);
+      gr_complex tmpPhase = std::polar(1.0f, (float)C8P_RX_SIG_SAMP * job->rad);
+      volk_32fc_s32fc_x2_rotator_32fc(tmpSig1, tmpSig1, tmpStep, &tmpPhase, job->nSamp);
+      tmpPhase = std::polar(1.0f, (float)C8P_RX_SIG_SAMP * job->rad);
+      volk_32fc_s32fc_x2_rotator_32fc(tmpSig2, tmpSig2, tmpStep, &tmpPhase, job->nSamp);
+
+      job->decoded = job->frame.run(&worker->rx, &worker->llr, d_llrType, tmpSig1, tmpSig2, job->nSamp, job->sigMcs, job->sigLen, job->chan, job->snr);
+    }
+
+    void
+    rx_parallel_impl::jobPublish()
+    {
+      // called with d_mutex held, only the oldest finished jobs can go out
+      while(!d_jobOrder.empty() && d_jobOrder.front()->done)
+      {
+        rxpJob* tmpJob = d_jobOrder.front();
+        d_jobOrder.pop_front();
+        if(tmpJob->decoded)
+        {
+          tmpJob->frame.mpdus([this, tmpJob](const uint8_t* mpdu, int len){
+            pktPublish(tmpJob, mpdu, len);
+          });
+        }
+        d_ringTail = tmpJob->end;
+        d_jobFree.push_back(tmpJob);
+        d_cvFree.notify_one();
+      }
+    }
+
+    void
+    rx_parallel_impl::pktPublish(rxpJob* job, const uint8_t* mpdu, int len)
+    {
+      // same message as decode, 1 byte format, 2 bytes len, mpdu and 1 byte mcs
+      pmt::pmt_t tmpPayload;
+      uint8_t* tmpBytes = d_blobPool.get(len + 4, tmpPayload);
+      tmpBytes[0] = job->frame.format;
+      tmpBytes[1] = len%256;
+      tmpBytes[2] = len/256;
+      memcpy(&tmpBytes[3], mpdu, len);
+      tmpBytes[len + 3] = job->frame.mcs;
+      pmt::pmt_t tmpMeta = pmt::dict_add(pmt::make_dict(), d_pmtLen, pmt::from_long(len + 4));
+      tmpMeta = pmt::dict_add(tmpMeta, d_pmtSeq, pmt::from_long(job->seq));
+      message_port_pub(d_pmtOut, pmt::cons(tmpMeta, tmpPayload));
+    }
+
+  } /* namespace ieee80211 */
+} /* namespace gr */
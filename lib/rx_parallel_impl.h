@@ -0,0 +1,130 @@
+/*
+ *
+ *     GNU Radio IEEE 802.11a/g/n/ac 2x2
+ *     Packet parallel receiver of 802.11a/g/n/ac 1x1 and 2x2 formats
+ *     Copyright (C) June 1, 2022  Zelin Yun
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU Affero General Public License as published
+ *     by the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU Affero General Public License for more details.
+ *
+ *     You should have received a copy of the GNU Affero General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_IEEE80211_RX_PARALLEL_IMPL_H
+#define INCLUDED_IEEE80211_RX_PARALLEL_IMPL_H
+
+#include <gnuradio/ieee80211/rx_parallel.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include "cloud80211phy.h"
+#include "cloud80211viterbi.h"
+#include "cloud80211pkt.h"
+#include "cloud80211rx.h"
+
+#define RXP_S_TRIGGER 0
+#define RXP_S_SIG 1
+#define RXP_S_COPY 2
+
+#define RXP_W_MAX 64          // max workers
+#define RXP_RING 1048576      // samples of each antenna in the ring, about 9 max len packets
+
+namespace gr {
+  namespace ieee80211 {
+
+    // one packet, its samples are in the ring from pos to pos + nSamp
+    struct rxpJob
+    {
+      int seq;
+      int sigMcs;           // legacy signal
+      int sigLen;
+      float rad;
+      float snr;
+      gr_complex chan[64];
+      int64_t pos;          // ring position, counted from the start
+      int64_t end;          // ring position after the span and its pad
+      int nSamp;
+      bool done;
+      bool decoded;
+      c8pRxFrame frame;
+    };
+
+    // demodulator and llr buffer of one worker
+    struct rxpWorker
+    {
+      c8pRxDemod rx;
+      std::vector<uint8_t> llr;
+      rxpWorker(int llrType) : rx(llrType) {}
+    };
+
+    class rx_parallel_impl : public rx_parallel
+    {
+     private:
+      // block
+      int d_sRx;
+      int d_nProc;
+      int d_nUsed;
+      int d_nPktSeq;
+      float d_cfoRad;
+      float d_snr;
+      std::vector<gr::tag_t> d_tags;
+      c8pRxSig d_rxSig;
+      rxpJob* d_job;
+      int d_nCopied;
+      // ring of the packet samples, spans never wrap
+      std::vector<gr_complex> d_ring1;
+      std::vector<gr_complex> d_ring2;
+      int64_t d_ringHead;
+      int64_t d_ringTail;
+      // workers, jobs are published in the order of the packets
+      int d_nWorker;
+      int d_llrType;
+      bool d_stop;
+      std::vector<std::thread> d_workers;
+      std::vector<rxpWorker*> d_workerStates;
+      std::vector<rxpJob*> d_jobs;
+      std::deque<rxpJob*> d_jobFree;
+      std::deque<rxpJob*> d_jobQueue;
+      std::deque<rxpJob*> d_jobOrder;
+      std::mutex d_mutex;
+      std::condition_variable d_cvQueue;
+      std::condition_variable d_cvFree;
+      // packet
+      c8pBlobPool d_blobPool;
+      pmt::pmt_t d_pmtOut;
+      pmt::pmt_t d_pmtLen;
+      pmt::pmt_t d_pmtSeq;
+
+     public:
+      rx_parallel_impl(int nworkers, int llrtype);
+      ~rx_parallel_impl();
+
+      // Where all the action really happens
+      void forecast (int noutput_items, gr_vector_int &ninput_items_required);
+
+      int general_work(int noutput_items,
+           gr_vector_int &ninput_items,
+           gr_vector_const_void_star &input_items,
+           gr_vector_void_star &output_items);
+
+      bool start();
+      bool stop();
+      void workerLoop(int id);
+      void jobRun(rxpJob* job, rxpWorker* worker);
+      void jobPublish();
+      void pktPublish(rxpJob* job, const uint8_t* mpdu, int len);
+    };
+
+  } // namespace ieee80211
+} // namespace gr
+
+#endif /* INCLUDED_IEEE80211_RX_PARALLEL_IMPL_H */
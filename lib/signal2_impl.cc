@@ -34,16 +34,11 @@ namespace gr {
     signal2_impl::signal2_impl()
       : gr::block("signal2",
               gr::io_signature::makev(3, 3, std::vector<int>{sizeof(uint8_t), sizeof(gr_complex), sizeof(gr_complex)}),
-              gr::io_signature::make(2, 2, sizeof(gr_complex))),
-              d_ofdm_fft1(64,1), d_ofdm_fft2(64,1), d_ofdm_ffts(64,1)
+              gr::io_signature::make(2, 2, sizeof(gr_complex)))
     {
       d_nProc = 0;
       d_nSigPktSeq = 0;
       d_sSignal = S_TRIGGER;
-      d_fftin1 = d_ofdm_fft1.get_inbuf();
-      d_fftin2 = d_ofdm_fft2.get_inbuf();
-      d_fftins = d_ofdm_ffts.get_inbuf();
-      d_h = std::vector<gr_complex>(64, gr_complex(0.0f, 0.0f));
 
       set_tag_propagation_policy(block::TPP_DONT);
     }
@@ -82,17 +77,14 @@ namespace gr {
         {
           if(sync[i])
           {
-            std::vector<gr::tag_t> tags;
-            get_tags_in_range(tags, 0, nitems_read(0) + i, nitems_read(0) + i + 1);
-            if (tags.size())
+            get_tags_in_range(d_tags, 0, nitems_read(0) + i, nitems_read(0) + i + 1);
+            c8p_pkt tmpPktCopy;
+            const c8p_pkt* tmpPkt = c8pPktFind(d_tags, &tmpPktCopy);
+            if (tmpPkt)
             {
-              pmt::pmt_t d_meta = pmt::make_dict();
-              for (auto tag : tags){
-                d_meta = pmt::dict_add(d_meta, tag.key, tag.value);
-              }
-              d_cfoRad = pmt::to_float(pmt::dict_ref(d_meta, pmt::mp("rad"), pmt::from_float(0.0f)));
-              d_snr = pmt::to_float(pmt::dict_ref(d_meta, pmt::mp("snr"), pmt::from_float(0.0f)));
-              d_rssi = pmt::to_float(pmt::dict_ref(d_meta, pmt::mp("rssi"), pmt::from_float(0.0f)));
+              d_cfoRad = tmpPkt->rad;
+              d_snr = tmpPkt->snr;
+              d_rssi = tmpPkt->rssi;
               d_sSignal = S_DEMOD;
               // std::cout<<"ieee80211 signal, rd tag cfo:"<<(d_cfoRad) * 20000000.0f / 2.0f / M_PI<<", snr:"<<d_snr<<std::endl;
             }
@@ -110,51 +102,36 @@ namespace gr {
       
       if(d_sSignal == S_DEMOD)
       {
-        if((d_nProc - d_nUsed) >= 224)
+        if((d_nProc - d_nUsed) >= C8P_RX_SIG_SAMP)
         {
-          d_sampin1 = &inSig1[C8P_SYM_SAMP_SHIFT+d_nUsed];
-          d_sampin2 = &inSig1[C8P_SYM_SAMP_SHIFT+64+d_nUsed];
-          d_sampins = &inSig1[C8P_SYM_SAMP_SHIFT+144+d_nUsed];
-          for(int i=0;i<64;i++)
+          if(d_rxSig.run(&inSig1[d_nUsed], d_cfoRad))
           {
-            d_fftin1[i] = d_sampin1[i] * gr_complex(cosf((i+C8P_SYM_SAMP_SHIFT) * d_cfoRad), sinf((i+C8P_SYM_SAMP_SHIFT) * d_cfoRad));
-            d_fftin2[i] = d_sampin2[i] * gr_complex(cosf((i+C8P_SYM_SAMP_SHIFT+64) * d_cfoRad), sinf((i+C8P_SYM_SAMP_SHIFT+64) * d_cfoRad));
-            d_fftins[i] = d_sampins[i] * gr_complex(cosf((i+C8P_SYM_SAMP_SHIFT+144) * d_cfoRad), sinf((i+C8P_SYM_SAMP_SHIFT+144) * d_cfoRad));
-          }
-          d_ofdm_fft1.execute();
-          d_ofdm_fft2.execute();
-          d_ofdm_ffts.execute();
-          procLHSigDemodDeint(d_ofdm_fft1.get_outbuf(), d_ofdm_fft2.get_outbuf(), d_ofdm_ffts.get_outbuf(), d_h, d_sigLegacyCodedLlr);
-          d_decoder.decode(d_sigLegacyCodedLlr, d_sigLegacyBits, 24);
-          if(signalCheckLegacy(d_sigLegacyBits, &d_nSigMcs, &d_nSigLen, &d_nSigDBPS))
-          {
-            d_nSymbol = (d_nSigLen*8 + 22 + d_nSigDBPS - 1)/d_nSigDBPS;
-            d_nSample = d_nSymbol * 80;
+            d_nSample = d_rxSig.nSamp;
             d_nSampleCopied = 0;
-            // std::cout<<"ieee80211 signal2, cfo:"<<(d_cfoRad) * 20000000.0f / 2.0f / M_PI<<", mcs: "<<d_nSigMcs<<", len:"<<d_nSigLen<<", nSym:"<<d_nSymbol<<", nSample:"<<d_nSample<<std::endl;
+            d_cfoStep = std::polar(1.0f, d_cfoRad);
+            d_cfoPhase = std::polar(1.0f, (float)C8P_RX_SIG_SAMP * d_cfoRad);
+            // std::cout<<"ieee80211 signal2, cfo:"<<(d_cfoRad) * 20000000.0f / 2.0f / M_PI<<", mcs: "<<d_rxSig.mcs<<", len:"<<d_rxSig.len<<", nSym:"<<d_rxSig.nSym<<", nSample:"<<d_nSample<<std::endl;
             // add info into tag
             d_nSigPktSeq++;
             if(d_nSigPktSeq >= 1000000000){d_nSigPktSeq = 0;}
-            pmt::pmt_t dict = pmt::make_dict();
-            dict = pmt::dict_add(dict, pmt::mp("cfo"), pmt::from_float(d_cfoRad * 3183098.8618379068f));  // rad * 20e6 / 2pi
-            dict = pmt::dict_add(dict, pmt::mp("snr"), pmt::from_float(d_snr));
-            dict = pmt::dict_add(dict, pmt::mp("rssi"), pmt::from_float(d_rssi));
-            dict = pmt::dict_add(dict, pmt::mp("seq"), pmt::from_long(d_nSigPktSeq));
-            dict = pmt::dict_add(dict, pmt::mp("mcs"), pmt::from_long(d_nSigMcs));
-            dict = pmt::dict_add(dict, pmt::mp("len"), pmt::from_long(d_nSigLen));
-            dict = pmt::dict_add(dict, pmt::mp("nsamp"), pmt::from_long(d_nSample));
-            dict = pmt::dict_add(dict, pmt::mp("chan"), pmt::init_c32vector(d_h.size(), d_h));
-            pmt::pmt_t pairs = pmt::dict_items(dict);
-            for (size_t i = 0; i < pmt::length(pairs); i++) {
-                pmt::pmt_t pair = pmt::nth(i, pairs);
-                add_item_tag(0,                   // output port index
-                              nitems_written(0),  // output sample index
-                              pmt::car(pair),     
-                              pmt::cdr(pair),
-                              alias_pmt());
-            }
+            c8p_pkt* tmpPkt = d_pktRing.next();
+            tmpPkt->rad = d_cfoRad;
+            tmpPkt->cfo = d_cfoRad * 3183098.8618379068f;  // rad * 20e6 / 2pi
+            tmpPkt->snr = d_snr;
+            tmpPkt->rssi = d_rssi;
+            tmpPkt->seq = d_nSigPktSeq;
+            tmpPkt->mcs = d_rxSig.mcs;
+            tmpPkt->len = d_rxSig.len;
+            tmpPkt->nSamp = d_nSample;
+            tmpPkt->nChan = 64;
+            std::copy(d_rxSig.h.begin(), d_rxSig.h.begin() + 64, tmpPkt->chan);
+            add_item_tag(0,                   // output port index
+                          nitems_written(0),  // output sample index
+                          c8pPktKey(),
+                          d_pktRing.publish(nitems_written(0)),
+                          alias_pmt());
             d_sSignal = S_COPY;
-            d_nUsed += 224;
+            d_nUsed += C8P_RX_SIG_SAMP;
           }
           else
           {
@@ -166,33 +143,18 @@ namespace gr {
       
       if(d_sSignal == S_COPY)
       {
-        float tmpRadStep;
+        // the phase carries over to the next call until the packet is copied
         d_nGen = std::min(noutput_items, (d_nProc - d_nUsed));
-        if(d_nGen < (d_nSample - d_nSampleCopied))
+        int tmpNumGen = std::min(d_nGen, d_nSample - d_nSampleCopied);
+        gr_complex tmpPhase = d_cfoPhase;
+        volk_32fc_s32fc_x2_rotator_32fc(outSig2, &inSig2[d_nUsed], d_cfoStep, &tmpPhase, tmpNumGen);
+        volk_32fc_s32fc_x2_rotator_32fc(outSig1, &inSig1[d_nUsed], d_cfoStep, &d_cfoPhase, tmpNumGen);
+        d_nSampleCopied += tmpNumGen;
+        d_nUsed += tmpNumGen;
+        d_nPassed += tmpNumGen;
+        if(d_nSampleCopied >= d_nSample)
         {
-          for(int i=0;i<d_nGen;i++)
-          {
-            tmpRadStep = (float)(d_nSampleCopied + 224) * d_cfoRad;
-            outSig1[i] = inSig1[i+d_nUsed] * gr_complex(cosf(tmpRadStep), sinf(tmpRadStep));   // * cfo
-            outSig2[i] = inSig2[i+d_nUsed] * gr_complex(cosf(tmpRadStep), sinf(tmpRadStep));   // * cfo
-            d_nSampleCopied++;
-          }
-          d_nUsed += d_nGen;
-          d_nPassed += d_nGen;
-        }
-        else
-        {
-          int tmpNumGen = d_nSample - d_nSampleCopied;
-          for(int i=0;i<tmpNumGen;i++)
-          {
-            tmpRadStep = (float)(d_nSampleCopied + 224) * d_cfoRad;
-            outSig1[i] = inSig1[i+d_nUsed] * gr_complex(cosf(tmpRadStep), sinf(tmpRadStep));   // * cfo
-            outSig2[i] = inSig2[i+d_nUsed] * gr_complex(cosf(tmpRadStep), sinf(tmpRadStep));   // * cfo
-            d_nSampleCopied++;
-          }
           d_sSignal = S_PAD;
-          d_nUsed += tmpNumGen;
-          d_nPassed += tmpNumGen;
         }
       }
       
@@ -22,10 +22,10 @@
 #define INCLUDED_IEEE80211_SIGNAL_IMPL_H
 
 #include <gnuradio/ieee80211/signal.h>
-#include <gnuradio/fft/fft.h>
 #include <volk/volk.h>
-#include <chrono>
 #include "cloud80211phy.h"
+#include "cloud80211pkt.h"
+#include "cloud80211rx.h"
 
 #define S_TRIGGER 0
 #define S_DEMOD 1
@@ -44,31 +44,19 @@ namespace gr {
       int d_nGen;
       int d_nUsed;
       int d_nPassed;
-      // signal soft viterbi ver
-      svSigDecoder d_decoder;
+      // legacy signal
+      c8pRxSig d_rxSig;
       float d_cfoRad;
+      gr_complex d_cfoStep;
+      gr_complex d_cfoPhase;
       float d_snr;
       float d_rssi;
-      std::vector<gr_complex> d_h;
-      float d_sigLegacyCodedLlr[48];
-      uint8_t d_sigLegacyBits[24];
+      // packet descriptors, from sync and for demod
+      std::vector<gr::tag_t> d_tags;
+      c8pPktRing d_pktRing;
       int d_nSigPktSeq;
-      int d_nSigMcs;
-      int d_nSigLen;
-      int d_nSigDBPS;
-      int d_nSymbol;
       int d_nSample;
       int d_nSampleCopied;
-      // fft
-      fft::fft_complex_fwd d_ofdm_fft1;
-      fft::fft_complex_fwd d_ofdm_fft2;
-      fft::fft_complex_fwd d_ofdm_ffts;
-      gr_complex *d_fftin1;
-      gr_complex *d_fftin2;
-      gr_complex *d_fftins;
-      const gr_complex *d_sampin1;
-      const gr_complex *d_sampin2;
-      const gr_complex *d_sampins;
 
      public:
       signal_impl();
@@ -0,0 +1,73 @@
+/*
+ *
+ *     GNU Radio IEEE 802.11a/g/n/ac 2x2
+ *     Short Training Field Detection
+ *     Copyright (C) June 1, 2022  Zelin Yun
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU Affero General Public License as published
+ *     by the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU Affero General Public License for more details.
+ *
+ *     You should have received a copy of the GNU Affero General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gnuradio/io_signature.h>
+#include "stf_detect_impl.h"
+
+namespace gr {
+  namespace ieee80211 {
+
+    stf_detect::sptr
+    stf_detect::make()
+    {
+      return gnuradio::make_block_sptr<stf_detect_impl>(
+        );
+    }
+
+    stf_detect_impl::stf_detect_impl()
+      : gr::block("stf_detect",
+              gr::io_signature::make(1, 1, sizeof(gr_complex)),
+              gr::io_signature::makev(2, 2, std::vector<int>{sizeof(uint8_t), sizeof(gr_complex)}))
+    {
+      d_debug = false;
+      d_nProc = 0;
+      // the input pointer starts C8P_STF_HIST samples back, zeros at the beginning as the delay block
+      set_history(C8P_STF_HIST + 1);
+    }
+
+    stf_detect_impl::~stf_detect_impl()
+    {
+    }
+
+    void
+    stf_detect_impl::forecast (int noutput_items, gr_vector_int &ninput_items_required)
+    {
+      ninput_items_required[0] = noutput_items + history() - 1;
+    }
+
+    int
+    stf_detect_impl::general_work (int noutput_items,
+                       gr_vector_int &ninput_items,
+                       gr_vector_const_void_star &input_items,
+                       gr_vector_void_star &output_items)
+    {
+      const gr_complex* inSig = static_cast<const gr_complex*>(input_items[0]) + C8P_STF_HIST;
+      uint8_t* outTrigger = static_cast<uint8_t*>(output_items[0]);
+      gr_complex* outConj = static_cast<gr_complex*>(output_items[1]);
+
+      d_nProc = std::min(noutput_items, ninput_items[0] - (int)history() + 1);
+      d_stf.run(inSig, d_nProc, outTrigger, outConj);
+
+      consume_each (d_nProc);
+      return d_nProc;
+    }
+
+  } /* namespace ieee80211 */
+} /* namespace gr */
@@ -83,7 +83,7 @@ namespace gr {
           }
           else if(trigger[i] & 0x02)
           {
-            d_conjMultiAvg = inConj[i];
+            d_ltfSync.conjMultiAvg = inConj[i];
           }
         }
         consume_each(i);
@@ -91,53 +91,25 @@ namespace gr {
       }
       else
       {
-        if(d_nProc >= SYNC_MAX_BUF_LEN)
+        if(d_nProc >= C8P_SYNC_BUF_LEN)
         {
-          ltf_autoCorrelation(inSig);
-          d_maxAcP = std::max_element(d_tmpAc, d_tmpAc + SYNC_MAX_RES_LEN);
-          memset(sync, 0, SYNC_MAX_RES_LEN);
-          if(*d_maxAcP > 0.5)  // some miss trigger not higher than 0.5
+          memset(sync, 0, C8P_SYNC_RES_LEN);
+          if(d_ltfSync.run(inSig))
           {
-            d_maxAc = *d_maxAcP * 0.8;
-            d_maxAcD = (double)(*d_maxAcP);
-            d_maxIndex = std::distance(d_tmpAc, d_maxAcP);
-            d_lIndex = d_maxIndex;
-            d_rIndex = d_maxIndex;
-            for(int j=d_maxIndex; j>=0; j--)
-            {
-              if(d_tmpAc[j] < d_maxAc)
-              {
-                d_lIndex = j;
-                break;
-              }
-            }
-            for(int j=d_maxIndex; j<SYNC_MAX_RES_LEN; j++)
-            {
-              if(d_tmpAc[j] < d_maxAc)
-              {
-                d_rIndex = j;
-                break;
-              }
-            }
-            d_mIndex = (d_lIndex+d_rIndex)/2;
-            sync[d_mIndex] = 0x01;  // sync index is LTF starting index + 16
-            pmt::pmt_t dict = pmt::make_dict();   // add tag to pass cfo and snr
-            dict = pmt::dict_add(dict, pmt::mp("rad"), pmt::from_float(ltf_cfo(&inSig[d_mIndex])));
-            dict = pmt::dict_add(dict, pmt::mp("snr"), pmt::from_float((float)(10.0 * log10(d_maxAcD / (1.0 - d_maxAcD)))));
-            dict = pmt::dict_add(dict, pmt::mp("rssi"), pmt::from_float(d_tmpPwr[d_maxIndex] / 64.0f));
-            pmt::pmt_t pairs = pmt::dict_items(dict);
-            for (size_t i = 0; i < pmt::length(pairs); i++) {
-                pmt::pmt_t pair = pmt::nth(i, pairs);
-                add_item_tag(0,                   // output port index
-                              nitems_written(0) + d_mIndex,  // output sample index
-                              pmt::car(pair),
-                              pmt::cdr(pair),
-                              alias_pmt());
-            }
+            sync[d_ltfSync.index] = 0x01;  // sync index is LTF starting index + 16
+            c8p_pkt* tmpPkt = d_pktRing.next();   // add tag to pass cfo and snr
+            tmpPkt->rad = d_ltfSync.rad;
+            tmpPkt->snr = d_ltfSync.snr;
+            tmpPkt->rssi = d_ltfSync.rssi;
+            add_item_tag(0,                   // output port index
+                          nitems_written(0) + d_ltfSync.index,  // output sample index
+                          c8pPktKey(),
+                          d_pktRing.publish(nitems_written(0) + d_ltfSync.index),
+                          alias_pmt());
           }
           d_sSync = SYNC_S_IDLE;
-          consume_each(SYNC_MAX_RES_LEN);
-          return SYNC_MAX_RES_LEN;
+          consume_each(C8P_SYNC_RES_LEN);
+          return C8P_SYNC_RES_LEN;
         }
         else
         {
@@ -152,48 +124,5 @@ namespace gr {
       return d_nProc;
     }
 
-    void
-    sync_impl::ltf_autoCorrelation(const gr_complex* sig)
-    {
-      gr_complex tmpMultiSum = gr_complex(0.0f, 0.0f);
-      float tmpSig1Sum = 0.0f;
-      float tmpSig2Sum = 0.0f;
-      // for 20MHz, init part 64 samples
-      for(int i=0;i<64;i++)
-      {
-        tmpMultiSum += sig[i] * std::conj(sig[i+64]);
-        tmpSig1Sum += std::abs(sig[i])*std::abs(sig[i]);
-        tmpSig2Sum += std::abs(sig[i+64])*std::abs(sig[i+64]);
-      }
-      for(int i=0;i<SYNC_MAX_RES_LEN;i++)   // sliding window to compute auto correlation
-      {
-        d_tmpAc[i] = std::abs(tmpMultiSum)/std::sqrt(tmpSig1Sum)/std::sqrt(tmpSig2Sum);
-        d_tmpPwr[i] = tmpSig1Sum;
-        tmpMultiSum -= sig[i] * std::conj(sig[i+64]);
-        tmpSig1Sum -= std::abs(sig[i])*std::abs(sig[i]);
-        tmpSig2Sum -= std::abs(sig[i+64])*std::abs(sig[i+64]);
-        tmpMultiSum += sig[i+64] * std::conj(sig[i+64+64]);
-        tmpSig1Sum += std::abs(sig[i+64])*std::abs(sig[i+64]);
-        tmpSig2Sum += std::abs(sig[i+64+64])*std::abs(sig[i+64+64]);
-      }
-    }
-
-    float
-    sync_impl::ltf_cfo(const gr_complex* sig)
-    {
-      gr_complex tmpConjSum = gr_complex(0.0f, 0.0f);
-      float tmpRadStepStf = atan2f(d_conjMultiAvg.imag(), d_conjMultiAvg.real()) / 16.0f;
-      for(int i=0;i<128;i++)
-      {
-        d_tmpConjSamp[i] = sig[i] * gr_complex(cosf(i * tmpRadStepStf), sinf(i * tmpRadStepStf));
-      }
-      for(int i=0;i<64;i++)
-      {
-        tmpConjSum += d_tmpConjSamp[i] * std::conj(d_tmpConjSamp[i+64]);
-      }
-      float tmpRadStepLtf = atan2f((tmpConjSum/64.0f).imag(), (tmpConjSum/64.0f).real()) / 64.0f;
-      return (tmpRadStepStf + tmpRadStepLtf);
-    }
-
   } /* namespace ieee80211 */
 } /* namespace gr */
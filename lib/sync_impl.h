@@ -23,13 +23,12 @@
 
 #include <gnuradio/ieee80211/sync.h>
 #include <chrono>
+#include "cloud80211pkt.h"
+#include "cloud80211rx.h"
 
 #define SYNC_S_IDLE 0
 #define SYNC_S_SYNC 1
 
-#define SYNC_MAX_BUF_LEN 240
-#define SYNC_MAX_RES_LEN SYNC_MAX_BUF_LEN - 128 - 1
-
 namespace gr {
   namespace ieee80211 {
 
@@ -41,17 +40,9 @@ namespace gr {
       int d_nProc;
       int d_nUsed;
       // for processing
-      float *d_maxAcP;
-      float d_maxAc;
-      double d_maxAcD;
-      int d_maxIndex;
-      int d_lIndex;
-      int d_rIndex;
-      int d_mIndex;
-      gr_complex d_conjMultiAvg;
-      float d_tmpAc[SYNC_MAX_RES_LEN];
-      float d_tmpPwr[SYNC_MAX_RES_LEN];
-      gr_complex d_tmpConjSamp[128];
+      c8pLtfSync d_ltfSync;
+      // packet descriptors for signal
+      c8pPktRing d_pktRing;
 
      public:
       sync_impl();
@@ -64,8 +55,6 @@ namespace gr {
            gr_vector_int &ninput_items,
            gr_vector_const_void_star &input_items,
            gr_vector_void_star &output_items);
-      void ltf_autoCorrelation(const gr_complex* sig);
-      float ltf_cfo(const gr_complex* sig);    // STF CFO with LTF residual CFO
     };
 
   } // namespace ieee80211
@@ -20,6 +20,8 @@
 
 #include <gnuradio/io_signature.h>
 #include "trigger_impl.h"
+#include <algorithm>
+#include <cstring>
 
 namespace gr {
   namespace ieee80211 {
@@ -44,12 +46,25 @@ namespace gr {
       d_conjAc = 0.0f;
 
       d_sampCount = 0;
+      d_sampFast = 0;
       d_usUsed = 0;
     }
 
     trigger_impl::~trigger_impl()
     {}
 
+    static inline bool
+    triggerScan(const float* ac)
+    {
+      // branchless so it compiles to vector compares, a NaN compares false as in the plain loop
+      int tmpAbove = 0;
+      for(int i=0;i<TRIGGER_SCAN;i++)
+      {
+        tmpAbove |= (ac[i] > TRIGGER_AC_TH);
+      }
+      return tmpAbove != 0;
+    }
+
     void
     trigger_impl::forecast (int noutput_items, gr_vector_int &ninput_items_required)
     {
@@ -68,53 +83,94 @@ namespace gr {
       d_ts = std::chrono::high_resolution_clock::now();
       if(d_sampCount > 57860000)
       {
-        dout<<"trigger procd samp: "<<d_sampCount<<", used time: "<<d_usUsed<<"us, avg "<<((double)d_sampCount / (double)d_usUsed)<<" samp/us"<<std::endl;
+        dout<<"trigger procd samp: "<<d_sampCount<<", used time: "<<d_usUsed<<"us, avg "<<((double)d_sampCount / (double)d_usUsed)<<" samp/us, fast path "<<fast_path_fraction()<<std::endl;
       }
 
       d_nProc = noutput_items;
-      for(int i=0;i<d_nProc;i++)
+      int tmpFast = 0;
+      int i = 0;
+      while(i < d_nProc)
       {
-        outTrigger[i] = 0;
-        /*  */
-        if(inAc[i] > 0.3f)
+        if(d_nPlateau == 0 && d_fPlateau == 0)
         {
-          d_nPlateau++;
-          if(inAc[i] > d_conjAc)
+          // idle, samples below the threshold keep the state as it is and give no trigger
+          int tmpEnd = i;
+          while((tmpEnd + TRIGGER_SCAN) <= d_nProc && !triggerScan(&inAc[tmpEnd]))
           {
-            d_conjAc = inAc[i];
-            // indicate to update conjugate
-            outTrigger[i] |= 0x02;
+            tmpEnd += TRIGGER_SCAN;
           }
-          if(d_nPlateau > 20 && (d_fPlateau+d_fPlateauEnd)==0)
+          if(tmpEnd > i)
           {
-            d_fPlateau = 1;
-            d_fPlateauEnd = 1;
-            d_countDown = 80;
+            memset(&outTrigger[i], 0, tmpEnd - i);
+            tmpFast += (tmpEnd - i);
+            i = tmpEnd;
+            continue;
           }
         }
-        else
+        int tmpEnd = std::min(d_nProc, i + TRIGGER_SCAN);
+        for(;i<tmpEnd;i++)
         {
-          d_nPlateau = 0;
-          d_fPlateauEnd = 0;
-          d_conjAc = 0.0f;
-        }
-        if(d_fPlateau)
-        {
-          d_countDown--;
-          if(d_countDown==0)
+          outTrigger[i] = 0;
+          if(inAc[i] > TRIGGER_AC_TH)
+          {
+            d_nPlateau++;
+            if(inAc[i] > d_conjAc)
+            {
+              d_conjAc = inAc[i];
+              // indicate to update conjugate
+              outTrigger[i] |= 0x02;
+            }
+            if(d_nPlateau > 20 && (d_fPlateau+d_fPlateauEnd)==0)
+            {
+              d_fPlateau = 1;
+              d_fPlateauEnd = 1;
+              d_countDown = 80;
+            }
+          }
+          else
+          {
+            d_nPlateau = 0;
+            d_fPlateauEnd = 0;
+            d_conjAc = 0.0f;
+          }
+          if(d_fPlateau)
           {
-            d_fPlateau = 0;
-            outTrigger[i] |= 0x01;
+            d_countDown--;
+            if(d_countDown==0)
+            {
+              d_fPlateau = 0;
+              outTrigger[i] |= 0x01;
+            }
           }
         }
       }
 
       consume_each (d_nProc);
       d_sampCount += d_nProc;
+      d_sampFast += tmpFast;
       d_te = std::chrono::high_resolution_clock::now();
       d_usUsed += std::chrono::duration_cast<std::chrono::microseconds>(d_te - d_ts).count();
       return d_nProc;
     }
 
+    uint64_t
+    trigger_impl::samples_processed()
+    {
+      return d_sampCount;
+    }
+
+    uint64_t
+    trigger_impl::samples_fast_pathed()
+    {
+      return d_sampFast;
+    }
+
+    double
+    trigger_impl::fast_path_fraction()
+    {
+      uint64_t tmpCount = d_sampCount;
+      return tmpCount ? ((double)d_sampFast / (double)tmpCount) : 0.0;
+    }
+
   } /* namespace ieee80211 */
 } /* namespace gr */
@@ -22,9 +22,13 @@
 #define INCLUDED_IEEE80211_TRIGGER_IMPL_H
 
 #include <gnuradio/ieee80211/trigger.h>
+#include <atomic>
 
 #define dout d_debug&&std::cout
 
+#define TRIGGER_AC_TH 0.3f      // plateau threshold of the normalized autocorrelation
+#define TRIGGER_SCAN 64         // samples checked at once for an idle span
+
 namespace gr {
   namespace ieee80211 {
 
@@ -44,7 +48,8 @@ namespace gr {
       std::chrono::_V2::system_clock::time_point d_ts;
       std::chrono::_V2::system_clock::time_point d_te;
       uint64_t d_usUsed;
-      uint64_t d_sampCount;
+      std::atomic<uint64_t> d_sampCount;
+      std::atomic<uint64_t> d_sampFast;
 
      public:
       trigger_impl();
@@ -57,6 +62,10 @@ namespace gr {
            gr_vector_int &ninput_items,
            gr_vector_const_void_star &input_items,
            gr_vector_void_star &output_items);
+
+      uint64_t samples_processed();
+      uint64_t samples_fast_pathed();
+      double fast_path_fraction();
     };
   } // namespace ieee80211
 } // namespace gr
@@ -14,6 +14,12 @@
 
 #include <gnuradio/ieee80211/utils.h>
 #include <cmath>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CRC32_X86
+#include <immintrin.h>
+#endif
 
 namespace gr {
 namespace ieee80211 {
@@ -56,15 +62,161 @@ static const uint32_t crc32_table[256] = {
     0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94, 0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D
 };
 
-uint32_t calc_fcs(const uint8_t* data, size_t len)
+// Slicing-by-8 tables, row k is row 0 followed by k zero bytes
+struct crc32_slice_tables {
+    uint32_t t[8][256];
+
+    crc32_slice_tables()
+    {
+        for (int i = 0; i < 256; i++) {
+            t[0][i] = crc32_table[i];
+        }
+        for (int k = 1; k < 8; k++) {
+            for (int i = 0; i < 256; i++) {
+                t[k][i] = (t[k - 1][i] >> 8) ^ crc32_table[t[k - 1][i] & 0xFF];
+            }
+        }
+    }
+};
+
+static const crc32_slice_tables& crc32_slices()
 {
-    uint32_t crc = 0xFFFFFFFF;
+    static const crc32_slice_tables tables;
+    return tables;
+}
 
-    for (size_t i = 0; i < len; i++) {
-        crc = (crc >> 8) ^ crc32_table[(crc ^ data[i]) & 0xFF];
+// Runs the CRC register (not inverted) over the data 8 bytes at a time
+static uint32_t crc32_slice8(uint32_t crc, const uint8_t* data, size_t len)
+{
+    const uint32_t(*t)[256] = crc32_slices().t;
+
+    while (len >= 8) {
+        uint32_t lo = crc ^ (data[0] | (data[1] << 8) | (data[2] << 16) |
+                             ((uint32_t)data[3] << 24));
+        uint32_t hi =
+            data[4] | (data[5] << 8) | (data[6] << 16) | ((uint32_t)data[7] << 24);
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^
+              t[4][lo >> 24] ^ t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^
+              t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+        data += 8;
+        len -= 8;
+    }
+    while (len--) {
+        crc = (crc >> 8) ^ crc32_table[(crc ^ *data++) & 0xFF];
+    }
+    return crc;
+}
+
+#ifdef CRC32_X86
+// Carry-less multiply folding from Intel's "Fast CRC Computation for Generic
+// Polynomials Using PCLMULQDQ Instruction", with the bit-reflected constants
+// of the paper. Takes len >= 64 and a multiple of 16, the register is not
+// inverted on either side.
+__attribute__((target("pclmul,sse4.1")))
+static uint32_t crc32_pclmul(uint32_t crc, const uint8_t* data, size_t len)
+{
+    alignas(16) static const uint64_t k1k2[2] = { 0x0154442bd4, 0x01c6e41596 };
+    alignas(16) static const uint64_t k3k4[2] = { 0x01751997d0, 0x00ccaa009e };
+    alignas(16) static const uint64_t k5k0[2] = { 0x0163cd6124, 0x0000000000 };
+    alignas(16) static const uint64_t poly[2] = { 0x01db710641, 0x01f7011641 };
+
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8;
+
+    x1 = _mm_loadu_si128((const __m128i*)(data + 0x00));
+    x2 = _mm_loadu_si128((const __m128i*)(data + 0x10));
+    x3 = _mm_loadu_si128((const __m128i*)(data + 0x20));
+    x4 = _mm_loadu_si128((const __m128i*)(data + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc));
+    data += 64;
+    len -= 64;
+
+    // fold 4 x 128 bits per 64 bytes
+    x0 = _mm_load_si128((const __m128i*)k1k2);
+    while (len >= 64) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5),
+                           _mm_loadu_si128((const __m128i*)(data + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6),
+                           _mm_loadu_si128((const __m128i*)(data + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7),
+                           _mm_loadu_si128((const __m128i*)(data + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8),
+                           _mm_loadu_si128((const __m128i*)(data + 0x30)));
+        data += 64;
+        len -= 64;
+    }
+
+    // fold the 4 lanes into one, then the remaining 16 byte blocks
+    x0 = _mm_load_si128((const __m128i*)k3k4);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+    while (len >= 16) {
+        x2 = _mm_loadu_si128((const __m128i*)data);
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+        data += 16;
+        len -= 16;
     }
 
-    return ~crc;
+    // 128 to 64 bits
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_srli_si128(x1, 8);
+    x1 = _mm_xor_si128(x1, x2);
+    x0 = _mm_loadl_epi64((const __m128i*)k5k0);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, x3);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction to 32 bits
+    x0 = _mm_load_si128((const __m128i*)poly);
+    x2 = _mm_and_si128(x1, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return (uint32_t)_mm_extract_epi32(x1, 1);
+}
+#endif
+
+uint32_t crc32_update(uint32_t crc, const uint8_t* data, size_t len)
+{
+    crc = ~crc;
+
+#ifdef CRC32_X86
+    static const bool pclmul =
+        __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+    if (pclmul && len >= 64) {
+        size_t n = len & ~(size_t)15;
+        crc = crc32_pclmul(crc, data, n);
+        data += n;
+        len -= n;
+    }
+#endif
+
+    return ~crc32_slice8(crc, data, len);
+}
+
+uint32_t calc_fcs(const uint8_t* data, size_t len)
+{
+    return crc32_update(0, data, len);
 }
 
 bool validate_fcs(const uint8_t* data, size_t len)
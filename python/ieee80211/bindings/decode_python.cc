@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(decode.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(dc21917a94d93bd9318193b5718f02a9)                     */
+/* BINDTOOL_HEADER_FILE_HASH(7a259285517bba25ad7680a15dde958b)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -38,6 +38,10 @@ void bind_decode(py::module& m)
 
         .def(py::init(&decode::make),
            py::arg("ifdebug"),
+           py::arg("tbdepth") = 0,
+           py::arg("nworkers") = 0,
+           py::arg("nsegments") = 0,
+           py::arg("llrtype") = 0,
            D(decode,make)
         )
         
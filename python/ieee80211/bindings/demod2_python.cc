@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(demod2.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(ce00088d2f09489a29c8a1becd2ba375)                     */
+/* BINDTOOL_HEADER_FILE_HASH(4d1e01a9e2555b1a4476b4fc7363cb0a)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -37,6 +37,7 @@ void bind_demod2(py::module& m)
         std::shared_ptr<demod2>>(m, "demod2", D(demod2))
 
         .def(py::init(&demod2::make),
+           py::arg("llrtype") = 0,
            D(demod2,make)
         )
         
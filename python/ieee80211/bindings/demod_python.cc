@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(demod.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(03f258bed3d0157dd9e8944fb164a474)                     */
+/* BINDTOOL_HEADER_FILE_HASH(ece4565077305778fe08fcd82da42ff9)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -39,6 +39,7 @@ void bind_demod(py::module& m)
         .def(py::init(&demod::make),
            py::arg("mupos"),
            py::arg("mugid"),
+           py::arg("llrtype") = 0,
            D(demod,make)
         )
         
@@ -25,3 +25,12 @@
  static const char *__doc_gr_ieee80211_trigger_make = R"doc()doc";
 
   
+
+
+ static const char *__doc_gr_ieee80211_trigger_samples_processed = R"doc()doc";
+
+
+ static const char *__doc_gr_ieee80211_trigger_samples_fast_pathed = R"doc()doc";
+
+
+ static const char *__doc_gr_ieee80211_trigger_fast_path_fraction = R"doc()doc";
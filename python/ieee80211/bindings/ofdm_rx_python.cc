@@ -0,0 +1,60 @@
+/*
+ * Copyright 2022 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(ofdm_rx.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(8b8f28d534b94c930f2e7c5126861e06)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/ieee80211/ofdm_rx.h>
+// pydoc.h is automatically generated in the build directory
+#include <ofdm_rx_pydoc.h>
+
+void bind_ofdm_rx(py::module& m)
+{
+
+    using ofdm_rx    = gr::ieee80211::ofdm_rx;
+
+
+    py::class_<ofdm_rx, gr::block, gr::basic_block,
+        std::shared_ptr<ofdm_rx>>(m, "ofdm_rx", D(ofdm_rx))
+
+        .def(py::init(&ofdm_rx::make),
+           py::arg("llrtype") = 0,
+           D(ofdm_rx,make)
+        )
+        
+
+
+
+        ;
+
+
+
+
+}
+
+
+
+
+
+
+
+
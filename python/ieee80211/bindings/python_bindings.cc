@@ -22,6 +22,7 @@ namespace py = pybind11;
 /**************************************/
 // BINDING_FUNCTION_PROTOTYPES(
     void bind_trigger(py::module& m);
+    void bind_stf_detect(py::module& m);
     void bind_sync(py::module& m);
     void bind_signal(py::module& m);
     void bind_modulation(py::module& m);
@@ -35,6 +36,8 @@ namespace py = pybind11;
     void bind_pad(py::module& m);
     void bind_modulation2(py::module& m);
     void bind_pad2(py::module& m);
+    void bind_rx_parallel(py::module& m);
+    void bind_ofdm_rx(py::module& m);
     void bind_chip_sync_c(py::module& m);
     void bind_ppdu_chip_mapper_bc(py::module& m);
     void bind_ppdu_prefixer(py::module& m);
@@ -67,6 +70,7 @@ PYBIND11_MODULE(ieee80211_python, m)
     /**************************************/
     // BINDING_FUNCTION_CALLS(
     bind_trigger(m);
+    bind_stf_detect(m);
     bind_sync(m);
     bind_signal(m);
     bind_modulation(m);
@@ -80,6 +84,8 @@ PYBIND11_MODULE(ieee80211_python, m)
     bind_pad(m);
     bind_modulation2(m);
     bind_pad2(m);
+    bind_rx_parallel(m);
+    bind_ofdm_rx(m);
     bind_chip_sync_c(m);
     bind_ppdu_chip_mapper_bc(m);
     bind_ppdu_prefixer(m);
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2022 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(rx_parallel.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(dcf9f9467393a360642d2bd8c8d43988)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/ieee80211/rx_parallel.h>
+// pydoc.h is automatically generated in the build directory
+#include <rx_parallel_pydoc.h>
+
+void bind_rx_parallel(py::module& m)
+{
+
+    using rx_parallel    = gr::ieee80211::rx_parallel;
+
+
+    py::class_<rx_parallel, gr::block, gr::basic_block,
+        std::shared_ptr<rx_parallel>>(m, "rx_parallel", D(rx_parallel))
+
+        .def(py::init(&rx_parallel::make),
+           py::arg("nworkers") = 4,
+           py::arg("llrtype") = 0,
+           D(rx_parallel,make)
+        )
+        
+
+
+
+        ;
+
+
+
+
+}
+
+
+
+
+
+
+
+
@@ -0,0 +1,59 @@
+/*
+ * Copyright 2022 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(stf_detect.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(382f0b16856e096f387855292c79adb3)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <gnuradio/ieee80211/stf_detect.h>
+// pydoc.h is automatically generated in the build directory
+#include <stf_detect_pydoc.h>
+
+void bind_stf_detect(py::module& m)
+{
+
+    using stf_detect    = gr::ieee80211::stf_detect;
+
+
+    py::class_<stf_detect, gr::block, gr::basic_block,
+        std::shared_ptr<stf_detect>>(m, "stf_detect", D(stf_detect))
+
+        .def(py::init(&stf_detect::make),
+           D(stf_detect,make)
+        )
+        
+
+
+
+        ;
+
+
+
+
+}
+
+
+
+
+
+
+
+
@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(trigger.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(31df2041480bb387e089208f29459895)                     */
+/* BINDTOOL_HEADER_FILE_HASH(df9b57f82a34bc69805befc8cc2a739d)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -39,6 +39,21 @@ void bind_trigger(py::module& m)
         .def(py::init(&trigger::make),
            D(trigger,make)
         )
+
+
+        .def("samples_processed",&trigger::samples_processed,
+            D(trigger,samples_processed)
+        )
+
+
+        .def("samples_fast_pathed",&trigger::samples_fast_pathed,
+            D(trigger,samples_fast_pathed)
+        )
+
+
+        .def("fast_path_fraction",&trigger::fast_path_fraction,
+            D(trigger,fast_path_fraction)
+        )
         
 
 
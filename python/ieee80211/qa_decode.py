@@ -7,7 +7,6 @@
 #
 
 from gnuradio import gr, gr_unittest
-# from gnuradio import blocks
 try:
   from gnuradio.ieee80211 import decode
 except ImportError:
@@ -16,6 +15,7 @@ except ImportError:
     dirname, filename = os.path.split(os.path.abspath(__file__))
     sys.path.append(os.path.join(dirname, "bindings"))
     from gnuradio.ieee80211 import decode
+from qa_rx_parallel import rx_packets, rx_bursts, rx_chain
 
 class qa_decode(gr_unittest.TestCase):
 
@@ -26,13 +26,20 @@ class qa_decode(gr_unittest.TestCase):
         self.tb = None
 
     def test_instance(self):
-        # FIXME: Test will fail until you pass sensible arguments to the constructor
-        instance = decode()
-
-    def test_001_descriptive_test_name(self):
-        # set up fg
-        self.tb.run()
-        # check data
+        instance = decode(False)
+
+    def test_001_settings(self):
+        # windowed traceback, the worker pool, segments and fixed point llr give the
+        # pdus and seq of the in-block decoder, the 700 and 900 byte packets are cut
+        # into 2 and 3 segments
+        pkts = rx_packets(5)
+        sig1, sig2 = rx_bursts(pkts, 6)
+        ref = rx_chain(sig1, sig2)
+        self.assertEqual(len(ref), sum(len(pkt[4]) for pkt in pkts))
+        for tbdepth, nworkers, nsegments, llrtype in ((96, 0, 0, 0), (0, 1, 0, 0), (0, 4, 0, 0), (0, 4, 4, 0),
+                                                      (0, 3, 8, 1), (0, 4, 4, 2), (96, 0, 0, 1), (144, 0, 0, 2)):
+            pdus = rx_chain(sig1, sig2, tbdepth, nworkers, nsegments, llrtype)
+            self.assertEqual(pdus, ref, "tbdepth %d, nworkers %d, nsegments %d, llrtype %d" % (tbdepth, nworkers, nsegments, llrtype))
 
 
 if __name__ == '__main__':
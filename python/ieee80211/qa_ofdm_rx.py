@@ -0,0 +1,41 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2022 Zelin Yun.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+from gnuradio import gr, gr_unittest
+try:
+  from gnuradio.ieee80211 import ofdm_rx
+except ImportError:
+    import os
+    import sys
+    dirname, filename = os.path.split(os.path.abspath(__file__))
+    sys.path.append(os.path.join(dirname, "bindings"))
+    from gnuradio.ieee80211 import ofdm_rx
+from qa_rx_parallel import rx_packets, rx_bursts, rx_chain, rx_block
+
+class qa_ofdm_rx(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def test_instance(self):
+        instance = ofdm_rx()
+
+    def test_001_same_as_chain(self):
+        # the fused block gives the pdus and seq of the signal2, demod2 and decode chain
+        pkts = rx_packets(3)
+        sig1, sig2 = rx_bursts(pkts, 4)
+        ref = rx_chain(sig1, sig2)
+        self.assertEqual(len(ref), sum(len(pkt[4]) for pkt in pkts))
+        self.assertEqual(rx_block(ofdm_rx(), sig1, sig2), ref)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_ofdm_rx)
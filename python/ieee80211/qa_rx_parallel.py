@@ -0,0 +1,207 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2022 Zelin Yun.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+import cmath
+import random
+import zlib
+import pmt
+from gnuradio import gr, gr_unittest
+from gnuradio import blocks, digital, fft
+try:
+  from gnuradio.ieee80211 import rx_parallel, encode2, modulation2, pad2, stf_detect, sync, signal2, demod2, decode
+except ImportError:
+    import os
+    import sys
+    dirname, filename = os.path.split(os.path.abspath(__file__))
+    sys.path.append(os.path.join(dirname, "bindings"))
+    from gnuradio.ieee80211 import rx_parallel, encode2, modulation2, pad2, stf_detect, sync, signal2, demod2, decode
+
+FORMAT_L = 0
+FORMAT_HT = 1
+FORMAT_VHT = 2
+
+
+def rx_mpdu(rng, length):
+    # random mpdu of length bytes ending with its fcs
+    mpdu = [rng.randrange(256) for i in range(length - 4)]
+    return mpdu + list(zlib.crc32(bytes(mpdu)).to_bytes(4, "little"))
+
+
+def rx_delimiter(length, eof):
+    # VHT A-MPDU delimiter, crc-8 over the first 16 bits and the signature
+    bits = (1 if eof else 0) | (((length >> 12) & 3) << 2) | ((length & 0xfff) << 4)
+    c = 0xff
+    for i in range(16):
+        c = c << 1
+        if c & 0x100:
+            c = (c + 1) ^ 0x06
+        if (bits >> i) & 1:
+            c ^= 0x07
+    c = 0xff - (c & 0xff)
+    crc = 0
+    for i in range(8):
+        crc |= ((c >> (7 - i)) & 1) << i
+    return [bits & 0xff, (bits >> 8) & 0xff, crc, 0x4e]
+
+
+def rx_packets(seed):
+    # (format, mcs, nss, psdu, mpdus), a plain mpdu for L and HT, an A-MPDU for VHT
+    rng = random.Random(seed)
+    pkts = []
+    for format, mcs, nss, length, nsub in ((FORMAT_L, 0, 1, 120, 1), (FORMAT_L, 5, 1, 700, 1),
+                                           (FORMAT_HT, 2, 1, 400, 1), (FORMAT_HT, 12, 2, 900, 1),
+                                           (FORMAT_VHT, 4, 1, 300, 2), (FORMAT_VHT, 8, 2, 500, 2)):
+        if format != FORMAT_VHT:
+            mpdu = rx_mpdu(rng, length)
+            pkts.append((format, mcs, nss, mpdu, [mpdu]))
+            continue
+        psdu = []
+        mpdus = []
+        for s in range(nsub):
+            mpdus.append(rx_mpdu(rng, length))
+            psdu += rx_delimiter(length, nsub == 1) + mpdus[-1]
+            psdu += [0] * (-len(psdu) % 4)
+        pkts.append((format, mcs, nss, psdu, mpdus))
+    return pkts
+
+
+def rx_tag(offset, key, value):
+    tag = gr.tag_t()
+    tag.offset = offset
+    tag.key = pmt.intern(key)
+    tag.value = pmt.from_long(value)
+    return tag
+
+
+def rx_bursts(pkts, seed):
+    # encode2, modulation2, ifft with cp and pad2 as tx2, then a mild 2x2 channel with cfo and noise
+    data = []
+    tags = []
+    for seq, (format, mcs, nss, psdu, mpdus) in enumerate(pkts):
+        for key, value in (("format", format), ("mcs0", mcs), ("nss0", nss), ("len0", len(psdu)), ("seq", seq)):
+            tags.append(rx_tag(len(data), key, value))
+        data += psdu + [0] * 160
+    tb = gr.top_block()
+    src = blocks.vector_source_b(data, False, 1, tags)
+    enc = encode2()
+    mod = modulation2()
+    pad = pad2()
+    dst = [blocks.vector_sink_c(), blocks.vector_sink_c()]
+    tb.connect(src, enc)
+    for i in range(2):
+        s2v = blocks.stream_to_vector(gr.sizeof_gr_complex, 64)
+        ifft = fft.fft_vcc(64, False, [], True, 1)
+        cp = digital.ofdm_cyclic_prefixer(64, 64 + 16, 0, "packet_len")
+        tb.connect((enc, i), (mod, i))
+        tb.connect((mod, i), s2v, ifft, cp, (pad, i))
+        tb.connect((pad, i), dst[i])
+    tb.run()
+    tx1 = dst[0].data()
+    tx2 = dst[1].data()
+
+    rng = random.Random(seed)
+    power = sum(abs(x) ** 2 for x in tx1) / len(tx1)
+    amp = (power / 10 ** 3.0 / 2) ** 0.5
+    rad = 2 * cmath.pi * 20e3 / 20e6
+    sig1 = [0j] * 1000
+    sig2 = [0j] * 1000
+    for i in range(len(tx1)):
+        ph = cmath.exp(1j * rad * i)
+        sig1.append((tx1[i] * 0.9 + tx2[i] * (0.1 + 0.3j)) * ph)
+        sig2.append((tx1[i] * (0.2 - 0.1j) + tx2[i] * 0.8) * ph)
+    sig1 += [0j] * 4000
+    sig2 += [0j] * 4000
+    sig1 = [x + complex(rng.gauss(0, amp), rng.gauss(0, amp)) for x in sig1]
+    sig2 = [x + complex(rng.gauss(0, amp), rng.gauss(0, amp)) for x in sig2]
+    return sig1, sig2
+
+
+def rx_pdus(dbg):
+    # mpdu bytes, format, mcs and seq of each pdu
+    pdus = []
+    for i in range(dbg.num_messages()):
+        msg = dbg.get_message(i)
+        payload = list(pmt.u8vector_elements(pmt.cdr(msg)))
+        seq = pmt.to_long(pmt.dict_ref(pmt.car(msg), pmt.intern("seq"), pmt.from_long(-1)))
+        pdus.append((payload, seq))
+    return pdus
+
+
+def rx_chain(sig1, sig2, tbdepth=0, nworkers=0, nsegments=0, llrtype=0):
+    # stf_detect, sync, signal2, demod2 and decode as rx2
+    tb = gr.top_block()
+    src1 = blocks.vector_source_c(sig1)
+    src2 = blocks.vector_source_c(sig2)
+    stf = stf_detect()
+    syn = sync()
+    sig = signal2()
+    dem = demod2(llrtype)
+    dec = decode(False, tbdepth, nworkers, nsegments, llrtype)
+    dbg = blocks.message_debug()
+    tb.connect((src1, 0), (stf, 0))
+    tb.connect((stf, 0), (syn, 0))
+    tb.connect((stf, 1), (syn, 1))
+    tb.connect((src1, 0), (syn, 2))
+    tb.connect((syn, 0), (sig, 0))
+    tb.connect((src1, 0), (sig, 1))
+    tb.connect((src2, 0), (sig, 2))
+    tb.connect((sig, 0), (dem, 0))
+    tb.connect((sig, 1), (dem, 1))
+    tb.connect(dem, dec)
+    tb.msg_connect((dec, "out"), (dbg, "store"))
+    tb.run()
+    return rx_pdus(dbg)
+
+
+def rx_block(rx, sig1, sig2):
+    # stf_detect and sync feeding a block that takes their outputs in place of signal2, demod2 and decode
+    tb = gr.top_block()
+    src1 = blocks.vector_source_c(sig1)
+    src2 = blocks.vector_source_c(sig2)
+    stf = stf_detect()
+    syn = sync()
+    dbg = blocks.message_debug()
+    tb.connect((src1, 0), (stf, 0))
+    tb.connect((stf, 0), (syn, 0))
+    tb.connect((stf, 1), (syn, 1))
+    tb.connect((src1, 0), (syn, 2))
+    tb.connect((syn, 0), (rx, 0))
+    tb.connect((src1, 0), (rx, 1))
+    tb.connect((src2, 0), (rx, 2))
+    tb.msg_connect((rx, "out"), (dbg, "store"))
+    tb.run()
+    return rx_pdus(dbg)
+
+
+class qa_rx_parallel(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def test_instance(self):
+        instance = rx_parallel()
+
+    def test_001_same_as_chain(self):
+        # one and several workers give the pdus and seq of the chain in the same order,
+        # the stream is finite, so the packets in flight at its end must still get out
+        pkts = rx_packets(1)
+        sig1, sig2 = rx_bursts(pkts, 2)
+        ref = rx_chain(sig1, sig2)
+        mpdus = [(format, mcs, mpdu) for format, mcs, nss, psdu, pkt in pkts for mpdu in pkt]
+        self.assertEqual(len(ref), len(mpdus))
+        for (payload, seq), (format, mcs, mpdu) in zip(ref, mpdus):
+            self.assertEqual(payload, [format, len(mpdu) % 256, len(mpdu) // 256] + mpdu + [mcs])
+        for nworkers in (1, 4):
+            self.assertEqual(rx_block(rx_parallel(nworkers), sig1, sig2), ref)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_rx_parallel)
@@ -0,0 +1,87 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2022 Zelin Yun.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+import random
+from gnuradio import gr, gr_unittest
+from gnuradio import blocks
+try:
+  from gnuradio.ieee80211 import stf_detect, trigger
+except ImportError:
+    import os
+    import sys
+    dirname, filename = os.path.split(os.path.abspath(__file__))
+    sys.path.append(os.path.join(dirname, "bindings"))
+    from gnuradio.ieee80211 import stf_detect, trigger
+
+
+def stf_bursts(seed):
+    # bursts of a 16 sample period repeated 10 times and random data over a noise floor
+    rng = random.Random(seed)
+
+    def noise(amp):
+        return complex(rng.gauss(0, amp), rng.gauss(0, amp))
+
+    samples = [noise(0.01) for i in range(600)]
+    for amp in (1.0, 0.2, 2.0):
+        period = [noise(amp) for i in range(16)]
+        burst = period * 10 + [noise(amp) for i in range(800)]
+        samples += [s + noise(amp * 0.05) for s in burst]
+        samples += [noise(0.01) for i in range(600)]
+    return samples
+
+
+class qa_stf_detect(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def test_instance(self):
+        instance = stf_detect()
+
+    def test_001_presiso(self):
+        # same trigger and conj as the presiso blocks followed by trigger
+        for seed in range(3):
+            self.tb = gr.top_block()
+            src = blocks.vector_source_c(stf_bursts(seed))
+            stf = stf_detect()
+            dstTrigger = blocks.vector_sink_b()
+            dstConj = blocks.vector_sink_c()
+            self.tb.connect(src, stf)
+            self.tb.connect((stf, 0), dstTrigger)
+            self.tb.connect((stf, 1), dstConj)
+
+            delay = blocks.delay(gr.sizeof_gr_complex, 16)
+            conjMult = blocks.multiply_conjugate_cc()
+            conjAvg = blocks.moving_average_cc(48, 1, 4000, 1)
+            conjMag = blocks.complex_to_mag()
+            pwr = blocks.complex_to_mag_squared()
+            pwrAvg = blocks.moving_average_ff(64, 1, 4000, 1)
+            div = blocks.divide_ff()
+            trig = trigger()
+            refTrigger = blocks.vector_sink_b()
+            refConj = blocks.vector_sink_c()
+            self.tb.connect(src, delay, (conjMult, 0))
+            self.tb.connect(src, (conjMult, 1))
+            self.tb.connect(conjMult, conjAvg, conjMag, (div, 0))
+            self.tb.connect(src, pwr, pwrAvg, (div, 1))
+            self.tb.connect(div, trig, refTrigger)
+            self.tb.connect(conjAvg, refConj)
+            self.tb.run()
+
+            self.assertEqual(len(dstTrigger.data()), len(refTrigger.data()))
+            self.assertEqual(dstTrigger.data(), refTrigger.data())
+            self.assertEqual(sum(t & 1 for t in dstTrigger.data()), 3)
+            # presiso sums in float and restarts each call, the block sums in double
+            self.assertComplexTuplesAlmostEqual2(refConj.data(), dstConj.data(), 1e-3, 1e-4)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_stf_detect)
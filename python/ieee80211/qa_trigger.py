@@ -6,8 +6,9 @@
 # SPDX-License-Identifier: GPL-3.0-or-later
 #
 
+import random
 from gnuradio import gr, gr_unittest
-# from gnuradio import blocks
+from gnuradio import blocks
 try:
   from gnuradio.ieee80211 import trigger
 except ImportError:
@@ -17,6 +18,50 @@ except ImportError:
     sys.path.append(os.path.join(dirname, "bindings"))
     from gnuradio.ieee80211 import trigger
 
+def trigger_ac(seed):
+    # idle autocorrelation with plateaus of 5 to 300 samples starting anywhere in a scan
+    # block, the values are multiples of 1/1024 so the float32 compares match the reference
+    rng = random.Random(seed)
+    ac = []
+    for p in range(40):
+        ac += [rng.randint(0, 256) / 1024.0 for i in range(rng.randint(1, 700))]
+        ac += [rng.randint(512, 1024) / 1024.0 for i in range(rng.choice((5, 19, 21, 22, 80, 81, 150, 300)))]
+    ac += [rng.randint(0, 256) / 1024.0 for i in range(500)]
+    return ac
+
+
+def trigger_ref(ac):
+    # the plateau detection of trigger one sample at a time, without the idle fast path
+    out = []
+    nPlateau = 0
+    fPlateau = 0
+    fPlateauEnd = 0
+    countDown = 0
+    conjAc = 0.0
+    for x in ac:
+        t = 0
+        if x > 0.3:
+            nPlateau += 1
+            if x > conjAc:
+                conjAc = x
+                t |= 0x02
+            if nPlateau > 20 and (fPlateau + fPlateauEnd) == 0:
+                fPlateau = 1
+                fPlateauEnd = 1
+                countDown = 80
+        else:
+            nPlateau = 0
+            fPlateauEnd = 0
+            conjAc = 0.0
+        if fPlateau:
+            countDown -= 1
+            if countDown == 0:
+                fPlateau = 0
+                t |= 0x01
+        out.append(t)
+    return out
+
+
 class qa_trigger(gr_unittest.TestCase):
 
     def setUp(self):
@@ -26,13 +71,27 @@ class qa_trigger(gr_unittest.TestCase):
         self.tb = None
 
     def test_instance(self):
-        # FIXME: Test will fail until you pass sensible arguments to the constructor
         instance = trigger()
 
-    def test_001_descriptive_test_name(self):
-        # set up fg
-        self.tb.run()
-        # check data
+    def test_001_fast_path(self):
+        # the output does not depend on how the calls cut the idle spans and plateaus, each
+        # call is at least one scan block so some idle spans take the fast path
+        ac = trigger_ac(1)
+        ref = trigger_ref(ac)
+        self.assertGreater(sum(1 for t in ref if t & 0x01), 20)
+        for nmax in (0, 1000, 100, 65):
+            tb = gr.top_block()
+            src = blocks.vector_source_f(ac)
+            trig = trigger()
+            if nmax:
+                trig.set_max_noutput_items(nmax)
+            dst = blocks.vector_sink_b()
+            tb.connect(src, trig, dst)
+            tb.run()
+            self.assertEqual(list(dst.data()), ref, "max noutput %d" % nmax)
+            self.assertEqual(trig.samples_processed(), len(ac))
+            self.assertGreater(trig.samples_fast_pathed(), 0)
+            self.assertLessEqual(trig.samples_fast_pathed(), sum(1 for x in ac if x <= 0.3))
 
 
 if __name__ == '__main__':
@@ -24,7 +24,6 @@ from gnuradio.eng_arg import eng_float, intx
 from gnuradio import eng_notation
 from gnuradio import ieee80211
 from gnuradio import network
-from presiso import presiso  # grc-generated hier_block
 import time
 
 
@@ -46,9 +45,8 @@ class wifirx2(gr.top_block):
         ##################################################
         # Blocks
         ##################################################
-        self.presiso_0 = presiso()
         self.network_socket_pdu_0 = network.socket_pdu('UDP_CLIENT', '127.0.0.1', '9527', 65535, False)
-        self.ieee80211_trigger_0 = ieee80211.trigger()
+        self.ieee80211_stf_detect_0 = ieee80211.stf_detect()
         self.ieee80211_sync_0 = ieee80211.sync()
         self.ieee80211_signal2_0 = ieee80211.signal2()
         self.ieee80211_demod2_0 = ieee80211.demod2()
@@ -72,16 +70,15 @@ class wifirx2(gr.top_block):
         self.connect((self.blocks_add_xx_0, 0), (self.ieee80211_signal2_0, 2))
         self.connect((self.blocks_add_xx_0_0, 0), (self.ieee80211_signal2_0, 1))
         self.connect((self.blocks_add_xx_0_0, 0), (self.ieee80211_sync_0, 2))
-        self.connect((self.blocks_add_xx_0_0, 0), (self.presiso_0, 0))
+        self.connect((self.blocks_add_xx_0_0, 0), (self.ieee80211_stf_detect_0, 0))
         self.connect((self.blocks_file_source_0, 0), (self.blocks_add_xx_0_0, 0))
         self.connect((self.blocks_file_source_0_0, 0), (self.blocks_add_xx_0, 0))
         self.connect((self.ieee80211_demod2_0, 0), (self.ieee80211_decode_0, 0))
         self.connect((self.ieee80211_signal2_0, 1), (self.ieee80211_demod2_0, 1))
         self.connect((self.ieee80211_signal2_0, 0), (self.ieee80211_demod2_0, 0))
         self.connect((self.ieee80211_sync_0, 0), (self.ieee80211_signal2_0, 0))
-        self.connect((self.ieee80211_trigger_0, 0), (self.ieee80211_sync_0, 0))
-        self.connect((self.presiso_0, 1), (self.ieee80211_sync_0, 1))
-        self.connect((self.presiso_0, 0), (self.ieee80211_trigger_0, 0))
+        self.connect((self.ieee80211_stf_detect_0, 0), (self.ieee80211_sync_0, 0))
+        self.connect((self.ieee80211_stf_detect_0, 1), (self.ieee80211_sync_0, 1))
 
 
     def get_samp_rate(self):
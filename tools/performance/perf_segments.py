@@ -0,0 +1,96 @@
+import numpy as np
+import pmt
+import time
+import zlib
+from gnuradio import gr, blocks, digital, fft
+from gnuradio import ieee80211
+
+# latency of decode for one long packet cut into nsegments Viterbi segments, each on its own worker
+# the llr of a 4095 byte legacy MCS0 packet are made once by tx2 and rx2 up to demod2, then only
+# decode runs on them, the time of a run without the packet tags is the flowgraph overhead
+
+def genLlr(nPkt, snr):
+    tb = gr.top_block()
+    rng = np.random.default_rng(1)
+    data = []
+    tags = []
+    for seq in range(0, nPkt):
+        payload = list(rng.integers(0, 256, 4091, dtype=np.uint8))
+        payload += list(np.frombuffer(np.uint32(zlib.crc32(bytes(payload))).tobytes(), dtype=np.uint8))
+        for key, value in (("format", 0), ("mcs0", 0), ("nss0", 1), ("len0", len(payload)), ("seq", seq)):
+            tag = gr.tag_t()
+            tag.offset = len(data)
+            tag.key = pmt.intern(key)
+            tag.value = pmt.from_long(value)
+            tags.append(tag)
+        data += [int(x) for x in payload] + [0] * 160
+    src = blocks.vector_source_b(data, False, 1, tags)
+    enc = ieee80211.encode2()
+    mod = ieee80211.modulation2()
+    pad = ieee80211.pad2()
+    dst = [blocks.vector_sink_c(), blocks.vector_sink_c()]
+    tb.connect(src, enc)
+    for i in range(0, 2):
+        s2v = blocks.stream_to_vector(gr.sizeof_gr_complex, 64)
+        ifft = fft.fft_vcc(64, False, [], True, 1)
+        cp = digital.ofdm_cyclic_prefixer(64, 64 + 16, 0, "packet_len")
+        tb.connect((enc, i), (mod, i))
+        tb.connect((mod, i), s2v, ifft, cp, (pad, i))
+        tb.connect((pad, i), dst[i])
+    tb.run()
+
+    sig = []
+    for i in range(0, 2):
+        tmpSig = np.concatenate((np.zeros(1000, dtype=np.complex64), np.array(dst[i].data(), dtype=np.complex64), np.zeros(4000, dtype=np.complex64)))
+        tmpAmp = np.sqrt(np.mean(np.abs(tmpSig)**2) / (10.0**(snr/10.0)) / 2)
+        sig.append(tmpSig + tmpAmp * (rng.standard_normal(len(tmpSig)) + 1j * rng.standard_normal(len(tmpSig))).astype(np.complex64))
+
+    tb = gr.top_block()
+    src1 = blocks.vector_source_c(sig[0])
+    src2 = blocks.vector_source_c(sig[1])
+    stf = ieee80211.stf_detect()
+    syn = ieee80211.sync()
+    sg2 = ieee80211.signal2()
+    dem = ieee80211.demod2(0)
+    llr = blocks.vector_sink_f()
+    tb.connect((src1, 0), (stf, 0))
+    tb.connect((stf, 0), (syn, 0))
+    tb.connect((stf, 1), (syn, 1))
+    tb.connect((src1, 0), (syn, 2))
+    tb.connect((syn, 0), (sg2, 0))
+    tb.connect((src1, 0), (sg2, 1))
+    tb.connect((src2, 0), (sg2, 2))
+    tb.connect((sg2, 0), (dem, 0))
+    tb.connect((sg2, 1), (dem, 1))
+    tb.connect(dem, llr)
+    tb.run()
+    return llr.data(), llr.tags()
+
+def timeDecode(llr, tags, nSegment, nRun):
+    tmpTime = []
+    tmpPdu = 0
+    for r in range(0, nRun):
+        tb = gr.top_block()
+        src = blocks.vector_source_f(llr, False, 1, tags)
+        dec = ieee80211.decode(False, 0, max(1, nSegment), nSegment, 0)
+        dbg = blocks.message_debug()
+        tb.connect(src, dec)
+        tb.msg_connect((dec, "out"), (dbg, "store"))
+        tmpStart = time.perf_counter()
+        tb.run()
+        tmpTime.append(time.perf_counter() - tmpStart)
+        tmpPdu = dbg.num_messages()
+    return min(tmpTime), tmpPdu
+
+if __name__ == "__main__":
+    perfSnr = 10.0
+    perfRun = 20
+    perfLlr, perfTags = genLlr(1, perfSnr)
+    tmpIdle, tmpPdu = timeDecode(perfLlr, [], 1, perfRun)
+    tmpBase = 0.0
+    for nSegment in [1, 2, 4, 8]:
+        tmpTime, tmpPdu = timeDecode(perfLlr, perfTags, nSegment, perfRun)
+        tmpTime -= tmpIdle
+        if(nSegment == 1):
+            tmpBase = tmpTime
+        print("nsegments %d: latency %.1f us (x%.2f), pdus %d" % (nSegment, tmpTime * 1e6, tmpBase / tmpTime, tmpPdu))